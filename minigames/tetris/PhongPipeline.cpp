@@ -3,6 +3,7 @@
 
 #include <xe/gfx/GraphicsDriver.hpp>
 #include <xe/gfx/Vertex.hpp>
+#include <xe/gfx/Mesh.hpp>
 #include <xe/sg/Camera.hpp>
 #include <xe/sg/Light.hpp>
 
@@ -52,6 +53,9 @@ namespace xe { namespace sg {
     
     void PhongPipeline::beginFrame(const xe::Vector4f &color) {
         graphicsDriver->beginFrame(color);
+
+        currentMaterial = nullptr;
+        currentSubset = nullptr;
     }
     
     void PhongPipeline::endFrame() {
@@ -83,6 +87,27 @@ namespace xe { namespace sg {
         assert(mesh);
     
         graphicsDriver->render(mesh);
+
+        currentMaterial = nullptr;
+        currentSubset = nullptr;
+    }
+
+    void PhongPipeline::render(xe::gfx::Mesh *mesh, int subset) {
+        assert(mesh);
+
+        const xe::gfx::MeshSubset *meshSubset = mesh->getSubset(subset);
+
+        if (meshSubset->getMaterial() != currentMaterial) {
+            currentMaterial = meshSubset->getMaterial();
+            graphicsDriver->setMaterial(currentMaterial);
+        }
+
+        if (meshSubset != currentSubset) {
+            currentSubset = meshSubset;
+            graphicsDriver->setMeshSubset(currentSubset);
+        }
+
+        graphicsDriver->render(meshSubset->getPrimitive(), 0);
     }
     
     void PhongPipeline::setModel(const xe::Matrix4f &transformation) {
@@ -58,6 +58,7 @@ namespace xe { namespace cm {
         
         if (cache_ptr) {
             queue->enqueueWriteBuffer(buffer, CL_TRUE, 0, cache_size, cache_ptr);
+            this->notifyChange();
         }
         
         cache.unlock();
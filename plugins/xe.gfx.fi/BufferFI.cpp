@@ -29,10 +29,17 @@ namespace xe { namespace gfx {
         }
 #endif
 
+        writeLocked = (mode&BufferUsage::Write) != 0;
+
         return ::FreeImage_GetBits(image->getBitmap());
     }
 
-    void BufferFI::unlock() {}
+    void BufferFI::unlock() {
+        if (writeLocked) {
+            writeLocked = false;
+            this->notifyChange();
+        }
+    }
 
     const void* BufferFI::lock() const {
 #if defined(EXENG_DEBUG)
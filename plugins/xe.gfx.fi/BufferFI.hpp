@@ -27,6 +27,7 @@ namespace xe { namespace gfx {
 
 	private:
 		ImageFI *image = nullptr;
+		bool writeLocked = false;
 	};
 }}
 
@@ -68,6 +68,8 @@ namespace xe { namespace gfx { namespace gl3 {
             cache_ptr = nullptr;
 
             GL3_CHECK();
+
+            this->notifyChange();
         }
 
         return cacheBuffer->unlock();
@@ -107,6 +109,8 @@ namespace xe { namespace gfx { namespace gl3 {
 		this->cacheBuffer->write(data, size, dataOffset, bufferOffset);
 
 		GL3_CHECK();
+
+		this->notifyChange();
 	}
 
     void BufferGL3::read(void* data, const int size, const int dataOffset, const int bufferOffset) const {
@@ -95,6 +95,8 @@ namespace xe { namespace gfx { namespace gl3 {
             cache_ptr = nullptr;
 
             GL3_CHECK();
+
+            this->notifyChange();
         }
 
 		cache.unlock();
@@ -0,0 +1,199 @@
+/**
+ * @file SlabBenchmark.cpp
+ * @brief Throughput of the ray-box slab tests, one box at a time and in packets of eight.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+#include <xe/AlignedAllocator.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/SlabIntersect.hpp>
+
+using namespace xe;
+using namespace xe::sg;
+
+namespace {
+    const int BoxCount = 1024;
+    const int RayCount = 4096;
+    const int RunCount = 5;
+
+    /**
+     * @brief The box test replaced by the sign based slab test: a branch for the parallel rays, a swap, and
+     * a exit on each axis. Kept to compare against it.
+     */
+    bool intersectReference(const Ray &ray, const Boxf &box, float *distance) {
+        const Vector3f minEdge = box.getMinEdge();
+        const Vector3f maxEdge = box.getMaxEdge();
+        const Vector3f rayPoint = ray.getPoint();
+        const Vector3f rayDirection = ray.getDirection();
+
+        float tnear = ray.getMinDistance();
+        float tfar = ray.getMaxDistance();
+
+        for (int coord=0; coord<3; ++coord) {
+            if (rayDirection[coord] == 0.0f) {
+                if (rayPoint[coord] < minEdge[coord] || rayPoint[coord] > maxEdge[coord]) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            const float invRayDirection = 1.0f / rayDirection[coord];
+            float t1 = (minEdge[coord] - rayPoint[coord]) * invRayDirection;
+            float t2 = (maxEdge[coord] - rayPoint[coord]) * invRayDirection;
+
+            if (t1 > t2) {
+                std::swap(t1, t2);
+            }
+
+            if (t1 > tnear) {
+                tnear = t1;
+            }
+
+            if (t2 < tfar) {
+                tfar = t2;
+            }
+
+            if (tnear > tfar) {
+                return false;
+            }
+        }
+
+        *distance = tnear;
+
+        return true;
+    }
+
+    /**
+     * @brief Run the test over all the rays, and report the box tests per second of the fastest run.
+     * @return The number of hits, to compare the results of the routines.
+     */
+    template<typename Test>
+    int measure(const char *name, Test test, double referenceRate, double *rate) {
+        double bestSeconds = std::numeric_limits<double>::max();
+        int hits = 0;
+
+        for (int run=0; run<RunCount; run++) {
+            const auto begin = std::chrono::steady_clock::now();
+
+            hits = test();
+
+            const auto end = std::chrono::steady_clock::now();
+
+            bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(end - begin).count());
+        }
+
+        *rate = double(BoxCount) * RayCount / bestSeconds;
+
+        std::cout << std::left << std::setw(24) << name;
+        std::cout << std::right << std::fixed << std::setprecision(1) << std::setw(10) << *rate / 1.0e6 << " M tests/s";
+
+        if (referenceRate > 0.0) {
+            std::cout << std::setprecision(2) << std::setw(8) << *rate / referenceRate << "x";
+        }
+
+        std::cout << "   (" << hits << " hits)" << std::endl;
+
+        return hits;
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(0.0f, 100.0f);
+    std::uniform_real_distribution<float> extent(0.5f, 10.0f);
+
+    std::vector<Boxf> boxes;
+    // the packets are over-aligned for the AVX loads, that the default allocator doesn't honor before C++17
+    AlignedVector<BoxPacket, alignof(BoxPacket)> packets(BoxCount / BoxPacket::MaxSize);
+
+    for (int i=0; i<BoxCount; i++) {
+        const Vector3f minEdge(coordinate(random), coordinate(random), coordinate(random));
+        const Boxf box(minEdge, minEdge + Vector3f(extent(random), extent(random), extent(random)));
+
+        boxes.push_back(box);
+        packets[i / BoxPacket::MaxSize].add(box);
+    }
+
+    // rays between random points inside of the volume, one of each eight parallel to some axis
+    std::vector<Ray> rays;
+
+    for (int i=0; i<RayCount; i++) {
+        const Vector3f point(coordinate(random), coordinate(random), coordinate(random));
+        Vector3f direction = Vector3f(coordinate(random), coordinate(random), coordinate(random)) - point;
+
+        if (i%8 == 0) {
+            direction[i%3] = 0.0f;
+        }
+
+        rays.emplace_back(point, direction, 0.0f, 100.0f);
+    }
+
+    double referenceRate = 0.0, rate = 0.0;
+
+    const int referenceHits = measure("reference", [&]() {
+        int hits = 0;
+        float distance = 0.0f;
+
+        for (const Ray &ray : rays) {
+            for (const Boxf &box : boxes) {
+                hits += intersectReference(ray, box, &distance) ? 1 : 0;
+            }
+        }
+
+        return hits;
+    }, 0.0, &referenceRate);
+
+    const int slabHits = measure("slab", [&]() {
+        int hits = 0;
+        float distance = 0.0f;
+
+        for (const Ray &ray : rays) {
+            for (const Boxf &box : boxes) {
+                hits += intersectSlab(ray, box, &distance) ? 1 : 0;
+            }
+        }
+
+        return hits;
+    }, referenceRate, &rate);
+
+    const int packetHits = measure("slab, 8 boxes at once", [&]() {
+        int hits = 0;
+        float distances[BoxPacket::MaxSize];
+
+        for (const Ray &ray : rays) {
+            for (const BoxPacket &packet : packets) {
+                const int mask = intersectSlab(ray, packet, distances);
+
+                for (int bits=mask; bits; bits &= bits - 1) {
+                    hits++;
+                }
+            }
+        }
+
+        return hits;
+    }, referenceRate, &rate);
+
+    // the slab tests widen the far distance slightly, so they can report a few more hits on the borders
+    if (slabHits != packetHits || std::abs(slabHits - referenceHits) > RayCount / 100) {
+        std::cout << "The results of the routines don't match" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
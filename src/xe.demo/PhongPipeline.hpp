@@ -24,6 +24,7 @@ namespace xe { namespace sg {
         virtual void render(xe::sg::Camera *) override;
         virtual void render(xe::sg::Geometry *) override;
         virtual void render(xe::gfx::Mesh *) override;
+        virtual void render(xe::gfx::Mesh *mesh, int subset) override;
     
         virtual void setModel(const xe::Matrix4f &) override;
     
@@ -38,6 +39,10 @@ namespace xe { namespace sg {
     
         xe::gfx::VertexFormat vertexFormat;
         xe::gfx::MaterialFormat materialFormat;
+
+        //! State bound by the last subset rendered, to skip setting it again.
+        const xe::gfx::Material *currentMaterial = nullptr;
+        const xe::gfx::MeshSubset *currentSubset = nullptr;
     };
 }}
 
@@ -3,8 +3,6 @@
  */
 
 #include <cmath>
-#include <ctime>
-#include <cstdlib>
 #include <iostream>
 
 #include "JitteredSampler.hpp"
@@ -13,33 +11,24 @@ using xe::Vector2f;
 
 namespace raytracer { namespace samplers {
         
-JitteredSampler::JitteredSampler(int sampleCount) {
+JitteredSampler::JitteredSampler(int sampleCount, std::uint32_t seed) : engine(seed) {
     this->sampleCount = sampleCount;
     this->generateSamples();
 }
 
 
-/**
-    * @brief Regresa un numero aleatorio entre -0.5 y 0.5
-    */
-float randomFloat() {
-    const float randMax = static_cast<float>(RAND_MAX);
-    
-    float value = static_cast<float>(std::rand()) / randMax;
-    
-    return value - 0.5f;
-}
-
-
 void JitteredSampler::generateSamples() {
     int n = static_cast<int>(std::sqrt(this->sampleCount));
     Vector2f sampledPoint;
     
+    // numero aleatorio entre -0.5 y 0.5
+    std::uniform_real_distribution<float> randomFloat(-0.5f, 0.5f);
+    
     for (int p=0; p<this->setCount; ++p) {
         for (int j=0; j<n; ++j) {
             for (int k=0; k<n; ++k) {
-                sampledPoint.x = (k + randomFloat()) / n;
-                sampledPoint.y = (j + randomFloat()) / n;
+                sampledPoint.x = (k + randomFloat(this->engine)) / n;
+                sampledPoint.y = (j + randomFloat(this->engine)) / n;
                 
                 this->sampleArray.push_back(sampledPoint);
             }
@@ -2,15 +2,25 @@
 #ifndef __RAYTRACER_SAMPLERS_JITTEREDSAMPLER_HPP__
 #define __RAYTRACER_SAMPLERS_JITTEREDSAMPLER_HPP__
 
+#include <cstdint>
+#include <random>
+
 #include "Sampler.hpp"
 
 namespace raytracer { namespace samplers {
 
 	class JitteredSampler : public Sampler {
 	public:
-		JitteredSampler(int sampleCount);
+		/**
+		 * @brief Genera las muestras, usando el generador de numeros aleatorios propio del 
+		 * muestreador, inicializado con la semilla indicada.
+		 */
+		JitteredSampler(int sampleCount, std::uint32_t seed=0);
     
 		virtual void generateSamples();
+
+	private:
+		std::mt19937 engine;
 	};
 
 }}
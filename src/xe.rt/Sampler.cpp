@@ -1,7 +1,5 @@
 
-#include <ctime>
-#include <cstdlib>
-#include <cstdint>
+#include <cassert>
 
 #include "Sampler.hpp"
 
@@ -10,14 +8,8 @@ using xe::Vector2f;
 namespace raytracer { namespace samplers {
     
     Sampler::Sampler() {
-        // Inicializa el generador de numeros aleatorios
-        auto time = std::time(nullptr);
-        std::srand(static_cast<std::uint32_t>(time));
-    
         this->sampleCount = 0;
         this->setCount = 1;
-        this->count = 0;
-        this->jump = 0;
     }
 
 
@@ -25,9 +17,10 @@ namespace raytracer { namespace samplers {
     }
 
 
-    Vector2f Sampler::sampleUnitSquare() const {
-        auto sampleIndex = this->count++ % (this->sampleCount * this->setCount);
-        return this->sampleArray[sampleIndex];
+    Vector2f Sampler::sampleUnitSquare(int sampleIndex) const {
+        assert(sampleIndex >= 0);
+        
+        return this->sampleArray[sampleIndex % (this->sampleCount * this->setCount)];
     }
 
 
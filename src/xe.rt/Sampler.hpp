@@ -37,9 +37,10 @@ namespace raytracer { namespace samplers {
         void shuffleSamples();
         
         /**
-         *  @brief Obtiene la siguiente muestra en el cuadrano unitario
+         *  @brief Obtiene la muestra indicada en el cuadrado unitario. No modifica el 
+         *  estado del muestreador, por lo que puede llamarse desde varios hilos a la vez.
          */
-        xe::Vector2f sampleUnitSquare() const;
+        xe::Vector2f sampleUnitSquare(int sampleIndex) const;
         
         /**
          *  @brief Devuelve la cantidad de muestras
@@ -72,15 +73,6 @@ namespace raytracer { namespace samplers {
          */
         IntArray shuffledIndices;
         
-        /**
-         *  @brief El numero actual de puntos de muestra usados
-         */
-        mutable int count;
-        
-        /** 
-         *  @brief Salto de indice aleatorio
-         */ 
-        int jump;
     };
 }}
 
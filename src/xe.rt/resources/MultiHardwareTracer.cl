@@ -371,6 +371,16 @@ __kernel void ComputeSynthesisData2 (
 
 }
 
+/**
+ * @brief Compute the color seen by a ray, from the synthesis element it has found.
+ */
+float4 shade_se(const ray_t *ray, const SynthesisElement *se, int materialSize, global float *materialData)
+{
+	const float4 color = *((global float4 *)(materialData + se->material*materialSize));
+
+	return color * fabs(dot(ray->direction, se->normal));
+}
+
 /**
  * @brief Synthetize the final image.
  * 
@@ -391,8 +401,188 @@ __kernel void SynthetizeImage (
 	const ray_t ray = rays[i];
 	const SynthesisElement synthElement = synthesisBuffer[i];
     
-	const float4 color = *((global float4 *)(materialData + synthElement.material*materialSize));
-	const float4 finalColor = color * fabs(dot(ray.direction, synthElement.normal));
+	const float4 finalColor = shade_se(&ray, &synthElement, materialSize, materialData);
+
+	write_imagef (image, (int2)(x, y), finalColor);
+}
+
+/*
+ * Adaptive antialiasing.
+ *
+ * The rays of GenerateRays are traced as usual, with a single sample per pixel. DetectEdges then 
+ * compares the synthesis element of each pixel against its neighbours, and appends the pixels on the 
+ * edges to a compact list. Only these pixels get the remaining samples, from 1 to sample_count - 1: 
+ * for each one, GenerateEdgeRays casts one ray per listed pixel, ComputeSynthesisData is invoked over the 
+ * list as a (count, 1) range, and AccumulateEdgeSamples adds the resulting colors. ResolveAdaptiveImage 
+ * writes the final image.
+ */
+
+// differences between neighbouring pixels above which they are considered to be on an edge
+#define EDGE_LUMINANCE_THRESHOLD	0.1f
+#define EDGE_NORMAL_THRESHOLD		0.9f
+#define EDGE_DEPTH_THRESHOLD		0.05f
+
+float luminance(float4 color) 
+{
+	return dot(color.xyz, (float3)(0.2126f, 0.7152f, 0.0722f));
+}
+
+/**
+ * @brief Check if two neighbouring pixels see different surfaces, or a sharp change of color.
+ */
+int is_discontinuity (
+	const ray_t *ray1, const SynthesisElement *se1, 
+	const ray_t *ray2, const SynthesisElement *se2, 
+	int materialSize, global float *materialData)
+{
+	const int hit1 = se1->distance > 0.0f;
+	const int hit2 = se2->distance > 0.0f;
+
+	if (hit1 != hit2) {
+		return 1;
+	}
+
+	if (!hit1) {
+		return 0;
+	}
+
+	const float luminance1 = luminance(shade_se(ray1, se1, materialSize, materialData));
+	const float luminance2 = luminance(shade_se(ray2, se2, materialSize, materialData));
+
+	if (fabs(luminance1 - luminance2) > EDGE_LUMINANCE_THRESHOLD) {
+		return 1;
+	}
+
+	if (se1->material != se2->material) {
+		return 1;
+	}
+
+	if (dot(se1->normal.xyz, se2->normal.xyz) < EDGE_NORMAL_THRESHOLD) {
+		return 1;
+	}
+
+	return fabs(se1->distance - se2->distance) > EDGE_DEPTH_THRESHOLD * fmin(se1->distance, se2->distance);
+}
+
+/**
+ * @brief Flag the pixels whose first sample differs from the ones of its neighbours, and append them to the edge list.
+ * The edge count must be cleared before the invocation.
+ */
+__kernel void DetectEdges (
+	__global SynthesisElement *synthesisBuffer, 
+	__global ray_t *rays, 
+	int materialSize, global float *materialData, 
+	__global int *edgeFlags, 
+	__global int *edgePixels, 
+	__global int *edgeCount)
+{
+	const int w = get_global_size(0);
+	const int h = get_global_size(1);
+	const int x = get_global_id(0);
+	const int y = get_global_id(1);
+	const int i = offset2(x, y, w, h);
+
+	const ray_t ray = rays[i];
+	const SynthesisElement se = synthesisBuffer[i];
+
+	const int2 neighbours[4] = {(int2)(x - 1, y), (int2)(x + 1, y), (int2)(x, y - 1), (int2)(x, y + 1)};
+
+	int edge = 0;
+
+	for (int n=0; n<4 && !edge; n++) {
+		const int2 neighbour = neighbours[n];
+
+		if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= w || neighbour.y >= h) {
+			continue;
+		}
+
+		const int j = offset2(neighbour.x, neighbour.y, w, h);
+		const ray_t neighbourRay = rays[j];
+		const SynthesisElement neighbourSe = synthesisBuffer[j];
+
+		edge = is_discontinuity(&ray, &se, &neighbourRay, &neighbourSe, materialSize, materialData);
+	}
+
+	edgeFlags[i] = edge;
+
+	if (edge) {
+		edgePixels[atomic_inc(edgeCount)] = i;
+	}
+}
+
+/**
+ * @brief Cast the rays of the specified sample, for the pixels of the edge list.
+ */
+__kernel void GenerateEdgeRays (
+	global ray_t *rays, 
+	__global const int *edgePixels, 
+	__global const float2 *samples, 
+	int sampleIndex, 
+	int width, int height, 
+	float camPosX, float camPosY, float camPosZ,
+	float camLookAtX, float camLookAtY, float camLookAtZ, 
+	float camUpX, float camUpY, float camUpZ) 
+{
+	const int e = get_global_id(0);
+	const int i = edgePixels[e];
+
+	const float2 screenCoord = {(float)(i % width), (float)(i / width)};
+	const float2 screenSize = {(float)width, (float)height};
+
+	const camera_t camera = {
+		{camPosX, camPosY, camPosZ, 1.0f},
+		{camLookAtX, camLookAtY, camLookAtZ, 1.0f},
+		{camUpX, camUpY, camUpZ, 0.0f},
+	};
+
+	rays[e] = cast(&camera, screenCoord, screenSize, samples[sampleIndex]);
+}
+
+/**
+ * @brief Add the colors found by the rays of GenerateEdgeRays to the accumulation buffer of their pixels.
+ */
+__kernel void AccumulateEdgeSamples (
+	__global float4 *accumulation, 
+	__global const int *edgePixels, 
+	__global SynthesisElement *synthesisBuffer, 
+	__global ray_t *rays, 
+	int materialSize, global float *materialData)
+{
+	const int e = get_global_id(0);
+
+	const ray_t ray = rays[e];
+	const SynthesisElement se = synthesisBuffer[e];
+
+	accumulation[edgePixels[e]] += shade_se(&ray, &se, materialSize, materialData);
+}
+
+/**
+ * @brief Synthetize the final image from the first sample of each pixel, averaged with the accumulated 
+ * samples for the pixels on the edges.
+ */
+__kernel void ResolveAdaptiveImage (
+	__write_only image2d_t image, 
+	__global SynthesisElement *synthesisBuffer, 
+	__global ray_t *rays, 
+	int materialSize, global float *materialData, 
+	__global const int *edgeFlags, 
+	__global const float4 *accumulation, 
+	int sampleCount)
+{
+	const int w = get_global_size(0);
+	const int h = get_global_size(1);
+	const int x = get_global_id(0);
+	const int y = get_global_id(1);
+	const int i = offset2(x, y, w, h);
+
+	const ray_t ray = rays[i];
+	const SynthesisElement synthElement = synthesisBuffer[i];
+
+	float4 finalColor = shade_se(&ray, &synthElement, materialSize, materialData);
+
+	if (edgeFlags[i]) {
+		finalColor = (finalColor + accumulation[i]) / (float)sampleCount;
+	}
 
 	write_imagef (image, (int2)(x, y), finalColor);
 }
@@ -7,9 +7,191 @@
 #include <xe/gfx/MeshSubsetGeneratorPlane.hpp>
 #include <xe/sg/Light.hpp>
 #include <xe/sg/Camera.hpp>
+#include <xe/sg/InstanceBVH.hpp>
+#include <xe/sg/RayPacket.hpp>
+#include <xe/sg/Sampler.hpp>
+#include <xe/sys/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
 namespace xe { namespace sg {
 
+    //! Size, in pixels, of the square tiles in which the frame is split for tracing.
+    static const int TileSize = 32;
+
+    //! Size, in pixels, of the blocks of each tile traced as a single ray packet.
+    static const int PacketWidth = 4;
+    static const int PacketHeight = 2;
+
+    //! Distance along the normal that the shadow rays are moved away from the surfaces.
+    static const float ShadowBias = 1e-3f;
+
+    static_assert(PacketWidth*PacketHeight <= xe::sg::RayPacket::MaxSize, "The ray packets are too small for the blocks");
+
+    //! Samples per pixel traced in each tile before checking if it has converged.
+    static const int MinSampleCount = 4;
+
+    //! Samples per pixel after which a tile is considered converged, regardless of its variance.
+    static const int MaxSampleCount = 256;
+
+    //! Standard error of the mean luminance, below which all the pixels of a tile must be to stop tracing it.
+    static const float ConvergenceThreshold = 1.0f / 255.0f;
+
+    //! Samples per pixel traced along the edges in the adaptive mode, by default.
+    static const int DefaultAdaptiveSampleCount = 16;
+
+    //! Differences between neighbouring pixels above which they are considered to be on an edge.
+    static const float EdgeLuminanceThreshold = 0.1f;
+    static const float EdgeNormalThreshold = 0.9f;
+    static const float EdgeDepthThreshold = 0.05f;
+
+    static float luminance(const xe::Vector4f &color) {
+        return 0.2126f*color.x + 0.7152f*color.y + 0.0722f*color.z;
+    }
+
+    /**
+     * @brief Shading attributes of a material, read once per tile.
+     */
+    struct MaterialColors {
+        xe::Vector4f ambient = {0.2f, 0.2f, 0.2f, 1.0f};
+        xe::Vector4f diffuse = {0.8f, 0.8f, 0.8f, 1.0f};
+    };
+
+    /**
+     * @brief Lighting parameters of a light, as submitted in a frame.
+     */
+    struct LightState {
+        const xe::sg::Light *light;
+        LightType::Enum type;
+        xe::Vector3f position;
+        xe::Vector3f target;
+        xe::Vector4f diffuse;
+
+        explicit LightState(const xe::sg::Light *light) : light(light) {
+            this->type = light->getLightType();
+            this->position = light->getPosition();
+            this->target = light->getTarget();
+            this->diffuse = light->getDiffuse();
+        }
+
+        bool operator== (const LightState &other) const {
+            return light == other.light && type == other.type && position == other.position 
+                && target == other.target && diffuse == other.diffuse;
+        }
+    };
+
+    /**
+     * @brief A geometry instance, as submitted in a frame. The version changes with the edits made inside of the geometry.
+     */
+    struct GeometryState {
+        const xe::sg::Geometry *geometry;
+        xe::Matrix4f transform;
+        std::uint32_t version;
+
+        explicit GeometryState(const xe::sg::GeometryInstance &instance) : geometry(instance.geometry), transform(instance.transform) {
+            this->version = instance.geometry->getVersion();
+        }
+
+        bool operator== (const GeometryState &other) const {
+            return geometry == other.geometry && transform == other.transform && version == other.version;
+        }
+    };
+
+    /**
+     * @brief A material used by the meshes of a frame, along with the version of the buffer holding its attributes.
+     */
+    struct MaterialState {
+        const xe::gfx::Material *material;
+        std::uint32_t version;
+
+        explicit MaterialState(const xe::gfx::Material *material) : material(material) {
+            const xe::Buffer *buffer = material ? material->getBuffer() : nullptr;
+
+            this->version = buffer ? buffer->getVersion() : 0;
+        }
+
+        bool operator== (const MaterialState &other) const {
+            return material == other.material && version == other.version;
+        }
+    };
+
+    /**
+     * @brief Everything submitted during a frame that affects the traced image. The accumulated 
+     * samples are kept while it stays the same from one frame to the next.
+     */
+    struct FrameState {
+        xe::Vector2i size = {0, 0};
+        xe::Vector4f background = {0.0f, 0.0f, 0.0f, 1.0f};
+        xe::Matrix4f view = xe::identity<float, 4>();
+        xe::Matrix4f proj = xe::identity<float, 4>();
+        std::vector<GeometryState> geometries;
+        std::vector<MaterialState> materials;
+        std::vector<LightState> lights;
+        AntialiasMode::Enum antialiasMode = AntialiasMode::Progressive;
+        int adaptiveSampleCount = 0;
+
+        bool operator== (const FrameState &other) const {
+            return size == other.size && background == other.background 
+                && view == other.view && proj == other.proj 
+                && geometries == other.geometries && materials == other.materials && lights == other.lights
+                && antialiasMode == other.antialiasMode && adaptiveSampleCount == other.adaptiveSampleCount;
+        }
+
+        bool operator!= (const FrameState &other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief Progress of the accumulation of a tile.
+     */
+    struct TileState {
+        int sampleCount = 0;
+        bool converged = false;
+    };
+
+    /**
+     * @brief What the first sample of a pixel has found, compared against its neighbours to detect the edges.
+     */
+    struct PixelSample {
+        bool hit = false;
+        const xe::gfx::Material *material = nullptr;
+        xe::Vector3f normal = {0.0f, 0.0f, 0.0f};
+        float distance = 0.0f;
+        float luminance = 0.0f;
+    };
+
+    /**
+     * @brief Check if two neighbouring pixels see different surfaces, or a sharp change of color.
+     */
+    static bool isDiscontinuity(const PixelSample &first, const PixelSample &second) {
+        if (first.hit != second.hit) {
+            return true;
+        }
+
+        if (std::abs(first.luminance - second.luminance) > EdgeLuminanceThreshold) {
+            return true;
+        }
+
+        if (!first.hit) {
+            return false;
+        }
+
+        if (first.material != second.material) {
+            return true;
+        }
+
+        if (dot(first.normal, second.normal) < EdgeNormalThreshold) {
+            return true;
+        }
+
+        return std::abs(first.distance - second.distance) > EdgeDepthThreshold * std::min(first.distance, second.distance);
+    }
+
     struct SoftwarePipeline::Private {
         xe::Matrix4f model = xe::identity<float, 4>();
         xe::Matrix4f view = xe::identity<float, 4>();
@@ -31,6 +213,36 @@ namespace xe { namespace sg {
 
         std::vector<xe::sg::Ray> rays;
         std::vector<xe::sg::IntersectInfo> synthetizationData;
+
+        //! Geometry instances and lights submitted during the current frame.
+        xe::sg::InstanceBVH instances;
+        std::vector<xe::sg::Light*> lights;
+
+        xe::sys::ThreadPool *pool = xe::sys::ThreadPool::getDefault();
+
+        //! Subpixel positions of the samples. Shared by all the threads.
+        xe::sg::BlueNoiseSampler sampler;
+
+        //! Sum of the samples traced for each pixel since the last change of the frame.
+        std::vector<xe::Vector4f> accumulation;
+
+        //! Sum of the squared luminances of the samples of each pixel, for the variance estimates.
+        std::vector<float> accumulationSq;
+
+        //! Number of samples accumulated in each pixel.
+        std::vector<int> sampleCounts;
+
+        //! First sample of each pixel, compared with the neighbouring ones to find the edges in the adaptive mode.
+        std::vector<PixelSample> firstSamples;
+
+        std::vector<TileState> tiles;
+
+        AntialiasMode::Enum antialiasMode = AntialiasMode::Progressive;
+        int adaptiveSampleCount = DefaultAdaptiveSampleCount;
+
+        //! The frame whose samples are accumulated.
+        FrameState accumulatedFrame;
+        bool accumulationValid = false;
         
         int computeOffset(const xe::Vector2i &pixel, const xe::Vector2i &size) {
 		    assert(pixel.x >= 0);
@@ -45,8 +257,8 @@ namespace xe { namespace sg {
             assert(offset >= 0);
             assert(offset < size.x*size.y);
         
-            const int x = offset / size.y;
-            const int y = offset % size.x;
+            const int x = offset % size.x;
+            const int y = offset / size.x;
         
             return xe::Vector2i(x, y);
         }
@@ -63,10 +275,10 @@ namespace xe { namespace sg {
 		    const xe::Vector2f nc = (coordsf / (sizef - Vector2f(1.0f, 1.0f)) ) - Vector2f(0.5f, 0.5f);
 		    const xe::Vector3f image_point = nc.x * cam_right + nc.y * cam_up + cam_pos + cam_dir;
     
-		    const xe::sg::Ray ray = {
-			    cam_pos, 
-			    xe::normalize(image_point - cam_pos)
-		    };
+		    // one approximated normalization, instead of two exact ones
+		    xe::sg::Ray ray;
+		    ray.setPoint(cam_pos);
+		    ray.setNormalizedDirection(xe::normalizeFast(image_point - cam_pos));
         
 		    return ray;
 	    }    
@@ -107,6 +319,434 @@ namespace xe { namespace sg {
             }
         }
         
+        MaterialColors readMaterial(const xe::gfx::Material *material) const {
+            MaterialColors colors;
+
+            if (!material) {
+                return colors;
+            }
+
+            const xe::gfx::MaterialFormat *format = material->getFormat();
+            const xe::Buffer *buffer = material->getBuffer();
+
+            if (!format || !buffer) {
+                return colors;
+            }
+
+            int offset = 0;
+
+            for (const xe::gfx::MaterialAttrib &attrib : format->attribs) {
+                const int size = static_cast<int>(attrib.getSize());
+
+                if (attrib.name == "ambient" && size == sizeof(xe::Vector4f)) {
+                    buffer->read(&colors.ambient, size, offset);
+                } else if (attrib.name == "diffuse" && size == sizeof(xe::Vector4f)) {
+                    buffer->read(&colors.diffuse, size, offset);
+                }
+
+                offset += size;
+            }
+
+            return colors;
+        }
+
+        typedef std::vector<std::pair<const xe::gfx::Material*, MaterialColors>> MaterialCache;
+
+        /**
+         * @brief Get the colors of a material, reading them only the first time it is found.
+         */
+        const MaterialColors& getMaterialColors(MaterialCache &materials, const xe::gfx::Material *material) const {
+            auto materialIt = std::find_if(materials.begin(), materials.end(), [material](const MaterialCache::value_type &entry) {
+                return entry.first == material;
+            });
+
+            if (materialIt == materials.end()) {
+                materials.push_back({material, this->readMaterial(material)});
+                materialIt = materials.end() - 1;
+            }
+
+            return materialIt->second;
+        }
+
+        xe::Vector4f shade(const xe::sg::Ray &ray, const xe::sg::IntersectInfo &info, const MaterialColors &colors) const {
+            xe::Vector3f normal = info.normal;
+
+            if (dot(normal, ray.getDirection()) > 0.0f) {
+                normal = -normal;
+            }
+
+            xe::Vector4f color = colors.ambient;
+
+            if (this->lights.size() == 0) {
+                // head light
+                const float factor = std::max(0.0f, -dot(normal, ray.getDirection()));
+                color += factor * colors.diffuse;
+
+            } else {
+                // shadow rays start slightly above the surface, to avoid hitting it again
+                const xe::Vector3f shadowPoint = info.point + ShadowBias * normal;
+
+                for (const xe::sg::Light *light : this->lights) {
+                    xe::Vector3f lightDirection;
+                    float lightDistance;
+
+                    if (light->getLightType() == xe::sg::LightType::Directional) {
+                        lightDirection = normalize(light->getPosition() - light->getTarget());
+                        lightDistance = std::numeric_limits<float>::max();
+                    } else {
+                        lightDirection = light->getPosition() - shadowPoint;
+                        lightDistance = abs(lightDirection);
+                        lightDirection = lightDirection / lightDistance;
+                    }
+
+                    const float factor = dot(normal, lightDirection);
+
+                    if (factor <= 0.0f) {
+                        continue;
+                    }
+
+                    if (this->instances.occluded(xe::sg::Ray(shadowPoint, lightDirection, 0.0f, lightDistance))) {
+                        continue;
+                    }
+
+                    color += factor * colors.diffuse * light->getDiffuse();
+                }
+            }
+
+            color.w = 1.0f;
+
+            return minimize(color, xe::Vector4f(1.0f));
+        }
+
+        /**
+         * @brief Trace a packet of primary rays, adding the color of each ray to the accumulation buffers of its pixel.
+         */
+        void tracePacket(xe::sg::RayPacket &packet, const xe::Vector2i *pixels, const xe::Vector2i &size, MaterialCache &materials) {
+            xe::sg::IntersectInfo infos[xe::sg::RayPacket::MaxSize];
+
+            const int mask = this->instances.intersect(packet, infos);
+
+            for (int lane=0; lane<packet.size; lane++) {
+                const bool hit = (mask & (1 << lane)) != 0;
+
+                xe::Vector4f color = this->color;
+
+                if (hit) {
+                    const xe::sg::Ray ray = {packet.getPoint(lane), packet.getDirection(lane)};
+                    color = this->shade(ray, infos[lane], this->getMaterialColors(materials, infos[lane].material));
+                }
+
+                const int pixelOffset = computeOffset(pixels[lane], size);
+                const float colorLuminance = luminance(color);
+
+                if (this->sampleCounts[pixelOffset] == 0 && !this->firstSamples.empty()) {
+                    PixelSample &sample = this->firstSamples[pixelOffset];
+
+                    sample.hit = hit;
+                    sample.luminance = colorLuminance;
+
+                    if (hit) {
+                        sample.material = infos[lane].material;
+                        sample.normal = infos[lane].normal;
+                        sample.distance = infos[lane].distance;
+                    }
+                }
+
+                this->accumulation[pixelOffset] += color;
+                this->accumulationSq[pixelOffset] += colorLuminance * colorLuminance;
+                this->sampleCounts[pixelOffset]++;
+            }
+        }
+
+        /**
+         * @brief Trace one sample for each pixel of a rectangular region of the frame, adding its color 
+         * to the accumulation buffers. The rays pass through the position of the specified sample inside each pixel.
+         *
+         * The pixels are traced in blocks of PacketWidth x PacketHeight coherent rays, that are tested at once 
+         * against the geometry.
+         */
+        void traceTile (
+            const xe::Vector2i &tileBegin, 
+            const xe::Vector2i &tileEnd, 
+            const xe::Vector2i &size, 
+            const int sampleIndex, 
+            const xe::Vector3f &cam_pos, 
+            const xe::Vector3f &cam_up, 
+            const xe::Vector3f &cam_dir, 
+            const xe::Vector3f &cam_right) {
+
+            const xe::Vector2f sizef = (xe::Vector2f)size;
+
+            MaterialCache materials;
+
+            for (int blockY=tileBegin.y; blockY<tileEnd.y; blockY+=PacketHeight) {
+                for (int blockX=tileBegin.x; blockX<tileEnd.x; blockX+=PacketWidth) {
+                    xe::sg::RayPacket packet;
+                    xe::Vector2i pixels[xe::sg::RayPacket::MaxSize];
+
+                    for (int y=blockY; y<std::min(blockY + PacketHeight, tileEnd.y); y++) {
+                        for (int x=blockX; x<std::min(blockX + PacketWidth, tileEnd.x); x++) {
+                            const xe::Vector2i pixel = {x, y};
+                            const xe::Vector2f offset = this->sampler.sample(pixel, sampleIndex, 0) - xe::Vector2f(0.5f);
+
+                            pixels[packet.add(castRay((xe::Vector2f)pixel + offset, sizef, cam_pos, cam_up, cam_dir, cam_right))] = pixel;
+                        }
+                    }
+
+                    this->tracePacket(packet, pixels, size, materials);
+                }
+            }
+        }
+
+        /**
+         * @brief Check if the first sample of a pixel differs enough from the ones of its neighbours to need more samples.
+         */
+        bool isEdgePixel(const xe::Vector2i &pixel, const xe::Vector2i &size) {
+            const PixelSample &sample = this->firstSamples[computeOffset(pixel, size)];
+
+            static constexpr xe::Vector2i offsets[] = {
+                {-1, 0}, {1, 0}, {0, -1}, {0, 1}
+            };
+
+            for (const xe::Vector2i &offset : offsets) {
+                const xe::Vector2i neighbour = pixel + offset;
+
+                if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= size.x || neighbour.y >= size.y) {
+                    continue;
+                }
+
+                if (isDiscontinuity(sample, this->firstSamples[computeOffset(neighbour, size)])) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Trace the remaining samples of the pixels of the tile found on the edges, up to the adaptive sample count. 
+         *
+         * All the samples of a pixel start from the same point towards almost the same direction, so they are traced 
+         * together as packets.
+         */
+        void refineTile (
+            const xe::Vector2i &tileBegin, 
+            const xe::Vector2i &tileEnd, 
+            const xe::Vector2i &size, 
+            const xe::Vector3f &cam_pos, 
+            const xe::Vector3f &cam_up, 
+            const xe::Vector3f &cam_dir, 
+            const xe::Vector3f &cam_right) {
+
+            const xe::Vector2f sizef = (xe::Vector2f)size;
+
+            MaterialCache materials;
+
+            for (int y=tileBegin.y; y<tileEnd.y; y++) {
+                for (int x=tileBegin.x; x<tileEnd.x; x++) {
+                    const xe::Vector2i pixel = {x, y};
+
+                    if (!this->isEdgePixel(pixel, size)) {
+                        continue;
+                    }
+
+                    int sampleIndex = this->sampleCounts[computeOffset(pixel, size)];
+
+                    while (sampleIndex < this->adaptiveSampleCount) {
+                        xe::sg::RayPacket packet;
+                        xe::Vector2i pixels[xe::sg::RayPacket::MaxSize];
+
+                        for (; sampleIndex<this->adaptiveSampleCount && packet.size<xe::sg::RayPacket::MaxSize; sampleIndex++) {
+                            const xe::Vector2f offset = this->sampler.sample(pixel, sampleIndex, 0) - xe::Vector2f(0.5f);
+
+                            pixels[packet.add(castRay((xe::Vector2f)pixel + offset, sizef, cam_pos, cam_up, cam_dir, cam_right))] = pixel;
+                        }
+
+                        this->tracePacket(packet, pixels, size, materials);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Check if the running average of all the pixels of the tile is close enough to its final value.
+         */
+        bool isTileConverged(const xe::Vector2i &tileBegin, const xe::Vector2i &tileEnd, const xe::Vector2i &size, const int sampleCount) {
+            if (sampleCount < MinSampleCount) {
+                return false;
+            }
+
+            if (sampleCount >= MaxSampleCount) {
+                return true;
+            }
+
+            const float invSampleCount = 1.0f / sampleCount;
+
+            for (int y=tileBegin.y; y<tileEnd.y; y++) {
+                for (int x=tileBegin.x; x<tileEnd.x; x++) {
+                    const int pixelOffset = computeOffset({x, y}, size);
+
+                    const float mean = luminance(this->accumulation[pixelOffset]) * invSampleCount;
+                    const float variance = std::max(0.0f, this->accumulationSq[pixelOffset] * invSampleCount - mean*mean);
+
+                    // standard error of the mean
+                    if (variance * invSampleCount > ConvergenceThreshold * ConvergenceThreshold) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Write the running average of the pixels of the tile into the render target.
+         */
+        void resolveTile(const xe::Vector2i &tileBegin, const xe::Vector2i &tileEnd, const xe::Vector2i &size) {
+            for (int y=tileBegin.y; y<tileEnd.y; y++) {
+                for (int x=tileBegin.x; x<tileEnd.x; x++) {
+                    const int pixelOffset = computeOffset({x, y}, size);
+
+                    assert(this->sampleCounts[pixelOffset] > 0);
+
+                    const float invSampleCount = 1.0f / this->sampleCounts[pixelOffset];
+                    const xe::Vector4f color = minimize(this->accumulation[pixelOffset] * invSampleCount, xe::Vector4f(1.0f));
+
+                    renderTargetSurface[pixelOffset] = (xe::Vector4ub)(color * 255.0f);
+                }
+            }
+        }
+
+        /**
+         * @brief Discard the accumulated samples if something changed since the previous frame.
+         */
+        void updateAccumulation(const xe::Vector2i &size, const int tileCount) {
+            FrameState frame;
+
+            frame.size = size;
+            frame.background = this->color;
+            frame.view = this->view;
+            frame.proj = this->proj;
+            frame.antialiasMode = this->antialiasMode;
+            frame.adaptiveSampleCount = this->adaptiveSampleCount;
+
+            for (int i=0; i<this->instances.getInstanceCount(); i++) {
+                const xe::sg::GeometryInstance &instance = this->instances.getInstance(i);
+
+                frame.geometries.push_back(GeometryState(instance));
+
+                // the materials of the subsets, as they are what gets shaded
+                if (const xe::gfx::Mesh *mesh = dynamic_cast<const xe::gfx::Mesh*>(instance.geometry)) {
+                    for (int j=0; j<mesh->getSubsetCount(); j++) {
+                        frame.materials.push_back(MaterialState(mesh->getSubset(j)->getMaterial()));
+                    }
+                }
+            }
+
+            for (const xe::sg::Light *light : this->lights) {
+                frame.lights.push_back(LightState(light));
+            }
+
+            if (this->accumulationValid && frame == this->accumulatedFrame) {
+                return;
+            }
+
+            this->accumulation.assign(size.x*size.y, xe::Vector4f(0.0f));
+            this->accumulationSq.assign(size.x*size.y, 0.0f);
+            this->sampleCounts.assign(size.x*size.y, 0);
+            this->tiles.assign(tileCount, TileState());
+
+            if (this->antialiasMode == AntialiasMode::Adaptive) {
+                this->firstSamples.assign(size.x*size.y, PixelSample());
+            } else {
+                this->firstSamples.clear();
+            }
+
+            this->accumulatedFrame = std::move(frame);
+            this->accumulationValid = true;
+        }
+
+        /**
+         * @brief Trace the geometry submitted during the frame, splitting the frame in tiles traced in parallel.
+         *
+         * In the progressive mode, each frame adds one sample per pixel to the tiles that haven't converged yet, 
+         * and shows the running average. In the adaptive mode, a single frame traces one sample per pixel, and then 
+         * the remaining ones only for the pixels on the edges. The accumulation restarts when the camera, the lights 
+         * or the geometries change.
+         */
+        void traceFrame(const xe::Vector2i &size) {
+            assert(renderTargetSurface);
+
+            this->instances.build();
+
+            if (this->instances.getInstanceCount() == 0) {
+                return;
+            }
+
+            // camera basis, from the view and projection transformations
+            const xe::Matrix4f invView = inverse(this->view);
+
+            const xe::Vector3f cam_pos = {invView.get(0, 3), invView.get(1, 3), invView.get(2, 3)};
+            const xe::Vector3f cam_right = normalize(xe::Vector3f(invView.get(0, 0), invView.get(1, 0), invView.get(2, 0)));
+            const xe::Vector3f cam_up = normalize(xe::Vector3f(invView.get(0, 1), invView.get(1, 1), invView.get(2, 1)));
+            const xe::Vector3f cam_dir = -normalize(xe::Vector3f(invView.get(0, 2), invView.get(1, 2), invView.get(2, 2)));
+
+            // the image plane is placed at distance one, so its extent is given by the field of view.
+            const float width = 2.0f / this->proj.get(0, 0);
+            const float height = 2.0f / this->proj.get(1, 1);
+
+            const int tileCountX = (size.x + TileSize - 1) / TileSize;
+            const int tileCountY = (size.y + TileSize - 1) / TileSize;
+
+            this->updateAccumulation(size, tileCountX*tileCountY);
+
+            const int tileCount = tileCountX*tileCountY;
+            const bool adaptive = this->antialiasMode == AntialiasMode::Adaptive;
+
+            auto getTileBegin = [&](const int tile) {
+                return xe::Vector2i(TileSize * (tile % tileCountX), TileSize * (tile / tileCountX));
+            };
+
+            auto getTileEnd = [&](const xe::Vector2i &tileBegin) {
+                return xe::Vector2i(std::min(size.x, tileBegin.x + TileSize), std::min(size.y, tileBegin.y + TileSize));
+            };
+
+            // the edges cross the tiles, so all the first samples must be traced before looking for them.
+            if (adaptive && !this->tiles.front().converged) {
+                this->pool->parallelFor(0, tileCount, 1, [&](int begin, int end) {
+                    for (int tile=begin; tile<end; tile++) {
+                        const xe::Vector2i tileBegin = getTileBegin(tile);
+
+                        this->traceTile(tileBegin, getTileEnd(tileBegin), size, 0, cam_pos, height * cam_up, cam_dir, width * cam_right);
+                    }
+                });
+            }
+
+            this->pool->parallelFor(0, tileCount, 1, [&](int begin, int end) {
+                for (int tile=begin; tile<end; tile++) {
+                    const xe::Vector2i tileBegin = getTileBegin(tile);
+                    const xe::Vector2i tileEnd = getTileEnd(tileBegin);
+
+                    TileState &state = this->tiles[tile];
+
+                    if (!state.converged && adaptive) {
+                        this->refineTile(tileBegin, tileEnd, size, cam_pos, height * cam_up, cam_dir, width * cam_right);
+
+                        state.sampleCount = this->adaptiveSampleCount;
+                        state.converged = true;
+
+                    } else if (!state.converged) {
+                        this->traceTile(tileBegin, tileEnd, size, state.sampleCount, cam_pos, height * cam_up, cam_dir, width * cam_right);
+
+                        state.sampleCount++;
+                        state.converged = this->isTileConverged(tileBegin, tileEnd, size, state.sampleCount);
+                    }
+
+                    this->resolveTile(tileBegin, tileEnd, size);
+                }
+            });
+        }
+
         void fillSurface(const int size, const xe::Vector4ub &color) {
             assert(size > 0);
         
@@ -145,8 +785,7 @@ namespace xe { namespace sg {
     uniform sampler2D screenTexture;
     
     void main() {
-        // color = texture(screenTexture, uv);    
-        color = vec4(0.0, 0.0, 0.0, 1.0);
+        color = texture(screenTexture, uv);
     })";
 
         impl = new SoftwarePipeline::Private();
@@ -202,6 +841,9 @@ namespace xe { namespace sg {
 		xe::Vector3i size = impl->screenTexture->getSize();
 
         impl->color = color;
+		impl->instances.clear();
+		impl->lights.clear();
+
 		impl->driver->beginFrame({1.0f, 1.0f, 1.0f, 1.0f} , xe::gfx::ClearFlags::Color);
 
 		auto data = impl->screenTexture->getBuffer()->lock(BufferUsage::ReadWrite);
@@ -213,6 +855,10 @@ namespace xe { namespace sg {
     void SoftwarePipeline::endFrame() {
         assert(impl);
 
+		xe::Vector3i size = impl->screenTexture->getSize();
+
+		impl->traceFrame({size.x, size.y});
+
 		impl->renderTargetSurface = nullptr;
 		impl->screenTexture->getBuffer()->unlock();
 
@@ -220,10 +866,54 @@ namespace xe { namespace sg {
         impl->driver->endFrame();
     }
     
+    void SoftwarePipeline::resetAccumulation() {
+        assert(impl);
+
+        impl->accumulationValid = false;
+    }
+
+    bool SoftwarePipeline::isConverged() const {
+        assert(impl);
+
+        if (!impl->accumulationValid) {
+            return false;
+        }
+
+        return std::all_of(impl->tiles.begin(), impl->tiles.end(), [](const TileState &state) {
+            return state.converged;
+        });
+    }
+
+    void SoftwarePipeline::setAntialiasMode(AntialiasMode::Enum mode) {
+        assert(impl);
+
+        impl->antialiasMode = mode;
+    }
+
+    AntialiasMode::Enum SoftwarePipeline::getAntialiasMode() const {
+        assert(impl);
+
+        return impl->antialiasMode;
+    }
+
+    void SoftwarePipeline::setAdaptiveSampleCount(int sampleCount) {
+        assert(impl);
+        assert(sampleCount > 0 && sampleCount <= MaxSampleCount);
+
+        impl->adaptiveSampleCount = sampleCount;
+    }
+
+    int SoftwarePipeline::getAdaptiveSampleCount() const {
+        assert(impl);
+
+        return impl->adaptiveSampleCount;
+    }
+
     void SoftwarePipeline::render(xe::sg::Light *light) {
-        //! TODO: Add custom code
         assert(impl);
         assert(light);
+
+        impl->lights.push_back(light);
     }
     
     void SoftwarePipeline::render(xe::sg::Camera *camera) {
@@ -234,15 +924,18 @@ namespace xe { namespace sg {
     }
     
     void SoftwarePipeline::render(xe::sg::Geometry *geometry) {
-        //! TODO: Add custom code
         assert(impl);
 		assert(geometry);
+
+		// the geometry is traced at the end of the frame, along with all the other geometries
+		impl->instances.add(geometry, impl->model);
     }
     
     void SoftwarePipeline::render(xe::gfx::Mesh *mesh) {
-        //! TODO: Add custom code
         assert(impl);
 		assert(mesh);
+
+		impl->instances.add(mesh, impl->model);
     }
     
     void SoftwarePipeline::setModel(const xe::Matrix4f &model) {
@@ -4,6 +4,7 @@
 #ifndef __xe_sg_softwarepipeline_hpp__
 #define __xe_sg_softwarepipeline_hpp__
 
+#include <xe/Enum.hpp>
 #include <xe/Vector.hpp>
 #include <xe/Matrix.hpp>
 #include <xe/gfx/Forward.hpp>
@@ -12,6 +13,20 @@
 #include <xe/sg/IntersectInfo.hpp>
 
 namespace xe { namespace sg {
+
+    /**
+     * @brief Strategies used by the software pipeline to distribute the samples of a frame among its pixels.
+     */
+    struct AntialiasMode : public Enum {
+        enum Enum {
+            //! Every pixel gets one more sample each frame, until its tile converges.
+            Progressive,
+
+            //! One sample for every pixel, and the full sample count only for the pixels along the edges.
+            Adaptive
+        };
+    };
+
     class EXENGAPI SoftwarePipeline : public xe::sg::Pipeline {
     public:
         explicit SoftwarePipeline(xe::gfx::GraphicsDriver *driver);
@@ -31,6 +46,34 @@ namespace xe { namespace sg {
     
         virtual const xe::gfx::MaterialFormat* getMaterialFormat() const override;
 
+        /**
+         * @brief Discard the samples accumulated in the previous frames. 
+         *
+         * The accumulation restarts by itself when the camera, the lights, the background color, the 
+         * geometries submitted or their versions, or the attributes of the materials of the meshes change. 
+         * This is needed only for the changes that none of them track, like the textures of a material.
+         */
+        void resetAccumulation();
+
+        /**
+         * @brief Check if all the pixels of the last frame have converged, so the next frames won't change the image.
+         */
+        bool isConverged() const;
+
+        /**
+         * @brief Set the strategy used to antialias the image. Changing it restarts the accumulation.
+         */
+        void setAntialiasMode(AntialiasMode::Enum mode);
+
+        AntialiasMode::Enum getAntialiasMode() const;
+
+        /**
+         * @brief Set the number of samples traced for the pixels detected as edges in the adaptive mode.
+         */
+        void setAdaptiveSampleCount(int sampleCount);
+
+        int getAdaptiveSampleCount() const;
+
     private:
         struct Private;
         Private *impl = nullptr;
@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include <xe/Matrix.hpp>
+#include <xe/gfx/Algorithm.hpp>
+
+using namespace xe;
+
+/**
+ * @brief Interleaved vertex, with padding between its attributes.
+ */
+struct TestVertex {
+	Vector3f position;
+	float u;
+	Vector3f normal;
+	float v;
+};
+
+BOOST_AUTO_TEST_CASE(TransformPointsTest)
+{
+	std::mt19937 engine(5);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	const Matrix4f transformation = translate<float>({1.0f, -2.0f, 3.0f}) * rotate<float>(0.5f, {1.0f, 1.0f, 0.0f}) * scale<float, 4>({2.0f, 1.0f, 0.5f});
+	const Matrix4f normalTransformation = transpose(inverse(transformation));
+
+	// long enough to be split between threads, and not a multiple of the SIMD width
+	std::vector<TestVertex> vertices(100003);
+
+	for (TestVertex &vertex : vertices) {
+		vertex.position = {distribution(engine), distribution(engine), distribution(engine)};
+		vertex.normal = normalize(Vector3f(distribution(engine), distribution(engine), distribution(engine)));
+		vertex.u = vertex.v = 0.25f;
+	}
+
+	const std::vector<TestVertex> original = vertices;
+
+	gfx::transformPoints(transformation, &vertices[0].position.x, sizeof(TestVertex), static_cast<int>(vertices.size()));
+	gfx::transformNormals(transformation, &vertices[0].normal.x, sizeof(TestVertex), static_cast<int>(vertices.size()));
+
+	for (size_t i=0; i<vertices.size(); i++) {
+		const Vector3f position = transform(transformation, original[i].position);
+
+		const Vector4f n = transform(normalTransformation, Vector4f(original[i].normal, 0.0f));
+		const Vector3f normal = normalize(Vector3f(n.x, n.y, n.z));
+
+		BOOST_REQUIRE_SMALL(abs(vertices[i].position - position), 1e-5f);
+		BOOST_REQUIRE_SMALL(abs(vertices[i].normal - normal), 1e-5f);
+
+		// the other attributes are left untouched
+		BOOST_REQUIRE_EQUAL(vertices[i].u, 0.25f);
+		BOOST_REQUIRE_EQUAL(vertices[i].v, 0.25f);
+	}
+
+	// packed elements, without space between them
+	std::vector<Vector3f> points(1001);
+
+	for (Vector3f &point : points) {
+		point = {distribution(engine), distribution(engine), distribution(engine)};
+	}
+
+	const std::vector<Vector3f> originalPoints = points;
+
+	gfx::transformPoints(transformation, &points[0].x, sizeof(Vector3f), static_cast<int>(points.size()));
+
+	for (size_t i=0; i<points.size(); i++) {
+		BOOST_REQUIRE_SMALL(abs(points[i] - transform(transformation, originalPoints[i])), 1e-5f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ComputeBoxTest)
+{
+	std::mt19937 engine(7);
+	std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+	// long enough to be split in several parts, with a odd count
+	std::vector<TestVertex> vertices(200001);
+
+	Boxf expected;
+
+	for (TestVertex &vertex : vertices) {
+		vertex.position = {distribution(engine), distribution(engine), distribution(engine)};
+		vertex.normal = {1000.0f, 1000.0f, 1000.0f};
+		vertex.u = vertex.v = -1000.0f;
+
+		expected.expand(vertex.position);
+	}
+
+	// the extremes at both ends, where the scalar paths take over
+	vertices.front().position = {-200.0f, 0.0f, 0.0f};
+	vertices.back().position = {0.0f, 0.0f, 200.0f};
+	expected.expand(vertices.front().position);
+	expected.expand(vertices.back().position);
+
+	const Boxf box = gfx::computeBox(&vertices[0].position.x, sizeof(TestVertex), static_cast<int>(vertices.size()));
+
+	BOOST_CHECK_EQUAL(box.getMinEdge(), expected.getMinEdge());
+	BOOST_CHECK_EQUAL(box.getMaxEdge(), expected.getMaxEdge());
+
+	// short and packed sequences
+	const std::vector<Vector3f> points = {{1.0f, 2.0f, 3.0f}, {-1.0f, 5.0f, 0.0f}, {0.0f, 0.0f, 4.0f}};
+
+	BOOST_CHECK_EQUAL(gfx::computeBox(&points[0].x, sizeof(Vector3f), 1).getMaxEdge(), points[0]);
+	BOOST_CHECK_EQUAL(gfx::computeBox(&points[0].x, sizeof(Vector3f), 3).getMinEdge(), Vector3f(-1.0f, 0.0f, 0.0f));
+	BOOST_CHECK_EQUAL(gfx::computeBox(&points[0].x, sizeof(Vector3f), 3).getMaxEdge(), Vector3f(1.0f, 5.0f, 4.0f));
+
+	BOOST_CHECK(!gfx::computeBox(nullptr, sizeof(Vector3f), 0).isValid());
+}
@@ -0,0 +1,177 @@
+#include <boost/test/unit_test.hpp>
+
+#include <xe/sg/BVH.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/SlabIntersect.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace xe;
+using namespace xe::sg;
+
+struct BVHFixture
+{
+	std::vector<Boxf> boxes;
+
+	BVHFixture()
+	{
+		// a 8x8x8 grid of unit boxes, separated by one unit
+		for (int i=0; i<8; i++) {
+			for (int j=0; j<8; j++) {
+				for (int k=0; k<8; k++) {
+					Vector3f minEdge(2.0f*i, 2.0f*j, 2.0f*k);
+
+					Boxf box;
+					box.expand(minEdge);
+					box.expand(minEdge + Vector3f(1.0f));
+
+					boxes.push_back(box);
+				}
+			}
+		}
+	}
+};
+
+BOOST_FIXTURE_TEST_CASE(BVHBuildTest, BVHFixture)
+{
+	BVH bvh(boxes);
+
+	BOOST_CHECK(!bvh.isEmpty());
+	BOOST_CHECK_EQUAL(bvh.getBox().getMinEdge(), Vector3f(0.0f));
+	BOOST_CHECK_EQUAL(bvh.getBox().getMaxEdge(), Vector3f(15.0f));
+	BOOST_CHECK_EQUAL(bvh.getIndices().size(), boxes.size());
+
+	// every primitive must be referenced exactly once
+	std::vector<int> references(boxes.size(), 0);
+
+	for (const BVHNode &node : bvh.getNodes()) {
+		if (node.isLeaf()) {
+			for (int i=node.offset; i<node.offset + node.count; i++) {
+				references[bvh.getIndices()[i]]++;
+			}
+		}
+	}
+
+	for (int count : references) {
+		BOOST_CHECK_EQUAL(count, 1);
+	}
+
+	BVH empty(std::vector<Boxf>{});
+	BOOST_CHECK(empty.isEmpty());
+	BOOST_CHECK(!empty.getBox().isValid());
+}
+
+BOOST_FIXTURE_TEST_CASE(BVHTraverseTest, BVHFixture)
+{
+	BVH bvh(boxes);
+
+	auto closest = [&](Ray ray) {
+		int hitIndex = -1;
+
+		ray.setMaxDistance(1000.0f);
+
+		bvh.traverse(ray, [&](int index, Ray &current) {
+			float distance = 0.0f;
+
+			if (intersectSlab(current, boxes[index], &distance)) {
+				current.clip(distance);
+				hitIndex = index;
+				return true;
+			}
+
+			return false;
+		});
+
+		return hitIndex;
+	};
+
+	// along the X axis, the first box of the row must be reported
+	int index = closest(Ray(Vector3f(-5.0f, 0.5f, 0.5f), Vector3f(1.0f, 0.0f, 0.0f)));
+	BOOST_REQUIRE(index != -1);
+	BOOST_CHECK_EQUAL(boxes[index].getMinEdge(), Vector3f(0.0f, 0.0f, 0.0f));
+
+	// from the other side
+	index = closest(Ray(Vector3f(20.0f, 2.5f, 4.5f), Vector3f(-1.0f, 0.0f, 0.0f)));
+	BOOST_REQUIRE(index != -1);
+	BOOST_CHECK_EQUAL(boxes[index].getMinEdge(), Vector3f(14.0f, 2.0f, 4.0f));
+
+	// between the rows of boxes
+	index = closest(Ray(Vector3f(-5.0f, 1.5f, 1.5f), Vector3f(1.0f, 0.0f, 0.0f)));
+	BOOST_CHECK_EQUAL(index, -1);
+
+	// pointing away
+	index = closest(Ray(Vector3f(-5.0f, 0.5f, 0.5f), Vector3f(-1.0f, 0.0f, 0.0f)));
+	BOOST_CHECK_EQUAL(index, -1);
+}
+
+BOOST_AUTO_TEST_CASE(SlabParallelRayTest)
+{
+	const Boxf box(Vector3f(0.0f), Vector3f(1.0f));
+	float distance = 0.0f;
+
+	// the reciprocal of the zero components is infinite, with the sign of the zero
+	for (float zero : {0.0f, -0.0f}) {
+		// starting exactly on the planes of the parallel slabs, where 0 * inf gives NaN
+		BOOST_CHECK(intersectSlab(Ray(Vector3f(-5.0f, 1.0f, 0.0f), Vector3f(1.0f, zero, zero)), box, &distance));
+		BOOST_CHECK_CLOSE(distance, 5.0f, 0.001f);
+
+		BOOST_CHECK(intersectSlab(Ray(Vector3f(0.5f, 0.0f, 0.5f), Vector3f(zero, 1.0f, zero)), box, &distance));
+		BOOST_CHECK_EQUAL(distance, 0.0f);
+
+		// outside of the parallel slabs
+		BOOST_CHECK(!intersectSlab(Ray(Vector3f(-5.0f, 1.5f, 0.5f), Vector3f(1.0f, zero, zero)), box, &distance));
+		BOOST_CHECK(!intersectSlab(Ray(Vector3f(-5.0f, 0.5f, -0.5f), Vector3f(1.0f, zero, zero)), box, &distance));
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(SlabBoxPacketTest, BVHFixture)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(-2.0f, 18.0f);
+	std::uniform_int_distribution<int> axis(0, 5);
+
+	int hitCount = 0;
+
+	for (int i=0; i<4000; i++) {
+		BoxPacket packet;
+		const int size = 1 + i%BoxPacket::MaxSize;
+
+		for (int lane=0; lane<size; lane++) {
+			BOOST_CHECK_EQUAL(packet.add(boxes[(i*37 + lane*11) % boxes.size()]), lane);
+		}
+
+		// some of the rays are parallel to one or two axes, and start on the planes of the grid
+		// aimed near one of the boxes of the packet
+		Vector3f point(coordinate(random), coordinate(random), coordinate(random));
+		Vector3f direction = packet.getBox(i%size).getCenter() + 0.1f*Vector3f(coordinate(random), coordinate(random), coordinate(random)) - point;
+
+		const int zeroAxis = axis(random);
+
+		if (zeroAxis < 3) {
+			direction[zeroAxis] = 0.0f;
+			point[zeroAxis] = std::floor(point[zeroAxis]);
+		}
+
+		Ray ray(point, direction, 0.0f, 30.0f);
+
+		float distances[BoxPacket::MaxSize];
+		const int mask = intersectSlab(ray, packet, distances);
+
+		BOOST_CHECK_EQUAL(mask >> size, 0);
+
+		for (int lane=0; lane<size; lane++) {
+			float distance = 0.0f;
+			const bool hit = intersectSlab(ray, packet.getBox(lane), &distance);
+
+			BOOST_CHECK_EQUAL(hit, (mask & (1 << lane)) != 0);
+
+			if (hit) {
+				BOOST_CHECK_EQUAL(distance, distances[lane]);
+				hitCount++;
+			}
+		}
+	}
+
+	BOOST_CHECK(hitCount > 100);
+}
@@ -3,6 +3,7 @@
 
 #include <xe/Buffer.hpp>
 #include <xe/HeapBuffer.hpp>
+#include <xe/StaticBuffer.hpp>
 
 // Probar los metodos de la clase ray
 BOOST_AUTO_TEST_CASE(TestBuffer) 
@@ -78,3 +79,52 @@ BOOST_AUTO_TEST_CASE(TestBuffer)
 		BOOST_CHECK_EQUAL(std::memcmp(&values4[1], locker4.getPointer(), buffer4.getSize()), 0);
 	}
 }
+
+BOOST_AUTO_TEST_CASE(TestBufferVersion)
+{
+	const int values[] = {1, 2, 3, 4};
+
+	xe::HeapBuffer buffer(sizeof(values));
+
+	// writes change the version
+	const std::uint32_t version = buffer.getVersion();
+	buffer.write(values);
+	BOOST_CHECK_NE(buffer.getVersion(), version);
+
+	// reads don't
+	const std::uint32_t writtenVersion = buffer.getVersion();
+
+	int values_out[4];
+	buffer.read(values_out);
+	BOOST_CHECK_EQUAL(buffer.getVersion(), writtenVersion);
+}
+
+BOOST_AUTO_TEST_CASE(TestStaticBufferVersion)
+{
+	int values[] = {1, 2, 3, 4};
+	const int values_in[] = {5, 6, 7, 8};
+
+	xe::StaticBuffer buffer(values, sizeof(values));
+
+	// writes change the version, and go to the wrapped memory
+	const std::uint32_t version = buffer.getVersion();
+	buffer.write(values_in, sizeof(values_in), 0, 0);
+	BOOST_CHECK_NE(buffer.getVersion(), version);
+	BOOST_CHECK_EQUAL(std::memcmp(values, values_in, sizeof(values)), 0);
+
+	// unlocking after a write lock too
+	const std::uint32_t writtenVersion = buffer.getVersion();
+
+	static_cast<int*>(buffer.lock(xe::BufferUsage::Write))[0] = 9;
+	buffer.unlock();
+
+	BOOST_CHECK_NE(buffer.getVersion(), writtenVersion);
+	BOOST_CHECK_EQUAL(values[0], 9);
+
+	// reads don't
+	const std::uint32_t lockedVersion = buffer.getVersion();
+
+	int values_out[4];
+	buffer.read(values_out, sizeof(values_out), 0, 0);
+	BOOST_CHECK_EQUAL(buffer.getVersion(), lockedVersion);
+}
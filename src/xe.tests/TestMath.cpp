@@ -144,3 +144,53 @@ BOOST_FIXTURE_TEST_CASE(VectorTest, VectorFixture)
     BOOST_CHECK_EQUAL(-4.0f, dot(v2, v4));
 }
 
+
+BOOST_AUTO_TEST_CASE(FastNormalizeTest)
+{
+    // from tiny to huge vectors, in all the directions
+    for (int exponent=-30; exponent<=30; exponent+=3) {
+        const float length = std::pow(2.0f, static_cast<float>(exponent)) * 1.37f;
+
+        for (int i=0; i<64; i++) {
+            const Vector3f direction = normalize(Vector3f(std::sin(i*0.7f), std::cos(i*1.3f), std::sin(i*2.9f + 0.5f)));
+            const Vector3f v = length * direction;
+
+            BOOST_REQUIRE_SMALL(abs(normalizeFast(v)) - 1.0f, 1e-6f);
+            BOOST_REQUIRE_SMALL(abs(normalizeFast(v) - normalize(v)), 1e-6f);
+        }
+
+        BOOST_REQUIRE_CLOSE(rsqrtFast(length), 1.0f / std::sqrt(length), 1e-4f);
+    }
+}
+
+namespace {
+    constexpr Boxf makeBox() {
+        Boxf box;
+
+        box.expand(Vector3f(1.0f, -2.0f, 3.0f));
+        box.expand(Vector3f(-1.0f, 2.0f, 0.0f));
+
+        return box;
+    }
+
+    // tables built by the compiler
+    constexpr Vector3f a(1.0f, 2.0f, 3.0f);
+    constexpr Vector3f b(4.0f, 5.0f, 6.0f);
+    constexpr Boxf box = makeBox();
+
+    static_assert(dot(a, b) == 32.0f, "");
+    static_assert(cross(a, b) == Vector3f(-3.0f, 6.0f, -3.0f), "");
+    static_assert((2.0f*a - b)[1] == -1.0f, "");
+    static_assert(Vector4f(a, 1.0f)[3] == 1.0f, "");
+    static_assert(maximize(a, b)[0] == 4.0f, "");
+    static_assert(box.getMinEdge()[1] == -2.0f, "");
+    static_assert(box.getMaxEdge()[2] == 3.0f, "");
+    static_assert(box.isInside(Vector3f(0.0f)), "");
+}
+
+BOOST_AUTO_TEST_CASE(ConstexprTest)
+{
+    BOOST_CHECK_EQUAL(box.getCenter(), Vector3f(0.0f, 0.0f, 1.5f));
+    BOOST_CHECK_EQUAL(Boxf(b, a), Boxf(a, b));
+    BOOST_CHECK_EQUAL(Boxf(b, a).getMinEdge(), a);
+}
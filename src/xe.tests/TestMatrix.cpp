@@ -2,6 +2,7 @@
 #include <iostream>
 #include <iomanip>
 #include <typeinfo>
+#include <random>
 
 #include <xe/Matrix.hpp>
 
@@ -9,6 +10,7 @@
 
 using xe::Matrix3f;
 using xe::Matrix4f;
+using xe::Matrix4d;
 using xe::Vector4f;
 using xe::Vector3f;
 
@@ -177,3 +179,102 @@ BOOST_FIXTURE_TEST_CASE(TestMatrix, MatrixFixture)
 	
 	BOOST_CHECK_EQUAL(position2_1, position2_2);
 }
+
+template<typename OtherType>
+xe::Matrix<OtherType, 4, 4> convert(const Matrix4f &m) {
+    xe::Matrix<OtherType, 4, 4> result;
+
+    for (int i=0; i<4; i++) {
+        for (int j=0; j<4; j++) {
+            result(i, j) = static_cast<OtherType>(m(i, j));
+        }
+    }
+
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(TestMatrixSpecializations)
+{
+    // the float 4x4 operations may be specialized, so they are checked against the generic double ones
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    const float tolerance = 1e-4f;
+
+    for (int k=0; k<256; k++) {
+        Matrix4f m, n;
+
+        for (int i=0; i<4; i++) {
+            for (int j=0; j<4; j++) {
+                m(i, j) = distribution(engine);
+                n(i, j) = distribution(engine);
+            }
+        }
+
+        // half of them are affine transformations, that have their own inverse
+        if (k % 2) {
+            m.setRow(3, Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+
+        const Matrix4d md = convert<double>(m);
+        const Matrix4d nd = convert<double>(n);
+
+        const Matrix4d product = convert<double>(m * n) - md * nd;
+        const Matrix4d transposed = convert<double>(transpose(m)) - transpose(md);
+
+        const Vector4f v = {distribution(engine), distribution(engine), distribution(engine), distribution(engine)};
+        const Vector3f p = {v.x, v.y, v.z};
+
+        const Vector4f tv = xe::transform(m, v);
+        const Vector3f tp = xe::transform(m, p);
+        const xe::Vector4d tvd = xe::transform(md, xe::Vector4d(v.x, v.y, v.z, v.w));
+        const xe::Vector3d tpd = xe::transform(md, xe::Vector3d(p.x, p.y, p.z));
+
+        for (int i=0; i<4; i++) {
+            for (int j=0; j<4; j++) {
+                BOOST_CHECK_SMALL(product(i, j), 1e-5);
+                BOOST_CHECK_EQUAL(transposed(i, j), 0.0);
+            }
+
+            BOOST_CHECK_SMALL(tv[i] - tvd[i], 1e-5);
+        }
+
+        for (int i=0; i<3; i++) {
+            BOOST_CHECK_SMALL(tp[i] - tpd[i], 1e-5);
+        }
+
+        // the inverse is compared only for well conditioned matrices
+        if (std::abs(abs(md)) < 0.5) {
+            continue;
+        }
+
+        const Matrix4d inv = convert<double>(inverse(m));
+        const Matrix4d invd = inverse(md);
+        const Matrix4d invDet = convert<double>(inverse(m, abs(m))) - invd;
+
+        for (int i=0; i<4; i++) {
+            for (int j=0; j<4; j++) {
+                BOOST_CHECK_SMALL((inv(i, j) - invd(i, j)) / (1.0 + std::abs(invd(i, j))), double(tolerance));
+                BOOST_CHECK_SMALL(invDet(i, j) / (1.0 + std::abs(invd(i, j))), double(tolerance));
+            }
+        }
+    }
+}
+
+namespace {
+    constexpr Matrix4f translation = xe::translate<float>({1.0f, 2.0f, 3.0f});
+    constexpr Matrix4f scaling = xe::scale<float, 4>({2.0f, 3.0f, 4.0f});
+
+    static_assert(translation(1, 3) == 2.0f && translation(3, 3) == 1.0f && translation(1, 0) == 0.0f, "");
+    static_assert((scaling + xe::identity<float, 4>())(2, 2) == 5.0f, "");
+    static_assert(xe::zero<float, 4, 4>() == Matrix4f(0.0f), "");
+    static_assert(translation.getColumn(3) == xe::Vector4f(1.0f, 2.0f, 3.0f, 1.0f), "");
+}
+
+BOOST_AUTO_TEST_CASE(TestMatrixConstexpr)
+{
+	const Matrix4f expected = xe::translate<float>({1.0f, 2.0f, 3.0f}) * xe::scale<float, 4>({2.0f, 3.0f, 4.0f});
+
+	BOOST_CHECK_EQUAL(translation * scaling, expected);
+	BOOST_CHECK_EQUAL(-translation, translation * -1.0f);
+}
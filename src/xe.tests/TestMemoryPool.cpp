@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <xe/MemoryPool.hpp>
+
+using namespace xe;
+
+BOOST_AUTO_TEST_CASE(MemoryPoolTest)
+{
+	MemoryPool<24, 8, 16> pool;
+
+	// more blocks than a single slab holds, all of them different and aligned
+	std::vector<void*> blocks;
+	std::set<void*> unique;
+
+	for (int i=0; i<40; i++) {
+		void *block = pool.allocate();
+
+		BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(block) % 8, 0u);
+
+		blocks.push_back(block);
+		unique.insert(block);
+	}
+
+	BOOST_CHECK_EQUAL(unique.size(), 40u);
+	BOOST_CHECK_EQUAL(pool.getBlockCount(), 40u);
+	BOOST_CHECK_EQUAL(pool.getSlabCount(), 3u);
+
+	// the blocks of a new slab are given in address order
+	BOOST_CHECK_EQUAL(static_cast<char*>(blocks[1]) - static_cast<char*>(blocks[0]), 24);
+
+	// the freed blocks are reused before growing again
+	pool.deallocate(blocks[5]);
+	pool.deallocate(nullptr);
+	BOOST_CHECK_EQUAL(pool.getBlockCount(), 39u);
+	BOOST_CHECK_EQUAL(pool.allocate(), blocks[5]);
+	BOOST_CHECK_EQUAL(pool.getSlabCount(), 3u);
+
+	for (void *block : blocks) {
+		pool.deallocate(block);
+	}
+
+	BOOST_CHECK_EQUAL(pool.getBlockCount(), 0u);
+}
@@ -0,0 +1,225 @@
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include <xe/sg/PacketIntersect.hpp>
+#include <xe/sg/InstanceBVH.hpp>
+#include <xe/sg/TSolidGeometry.hpp>
+#include <xe/sg/Sphere.hpp>
+#include <xe/sg/Plane.hpp>
+
+using namespace xe;
+using namespace xe::sg;
+
+static std::vector<const PacketKernels*> getAvailableKernels()
+{
+	std::vector<const PacketKernels*> kernels = {&getScalarPacketKernels()};
+
+	if (getSSEPacketKernels()) {
+		kernels.push_back(getSSEPacketKernels());
+	}
+
+	if (getAVX2PacketKernels()) {
+		kernels.push_back(getAVX2PacketKernels());
+	}
+
+	return kernels;
+}
+
+static RayPacket makePacket(std::mt19937 &engine, int size)
+{
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	RayPacket packet;
+
+	for (int i=0; i<size; i++) {
+		const Vector3f point(distribution(engine), distribution(engine), -5.0f);
+		const Vector3f target(distribution(engine), distribution(engine), 0.0f);
+
+		packet.add(Ray(point, target - point), 100.0f);
+	}
+
+	return packet;
+}
+
+BOOST_AUTO_TEST_CASE(PacketKernelsTest)
+{
+	std::mt19937 engine(42);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	const auto kernels = getAvailableKernels();
+
+	BOOST_CHECK(&getPacketKernels() == kernels.back());
+
+	for (int i=0; i<200; i++) {
+		const RayPacket packet = makePacket(engine, 1 + i % RayPacket::MaxSize);
+
+		const Vector3f p0(distribution(engine), distribution(engine), distribution(engine));
+		const Vector3f e1(distribution(engine), distribution(engine), distribution(engine));
+		const Vector3f e2(distribution(engine), distribution(engine), distribution(engine));
+
+		Boxf box;
+		box.expand(p0);
+		box.expand(p0 + e1);
+		box.expand(p0 + e2);
+
+		// compare each lane against the single ray tests
+		RayPacket reference = packet;
+		const int triangleMask = getScalarPacketKernels().intersectTriangle(reference, p0, e1, e2);
+		const int boxMask = getScalarPacketKernels().intersectBox(packet, box);
+
+		BOOST_CHECK_EQUAL(triangleMask & ~packet.getActiveMask(), 0);
+		BOOST_CHECK_EQUAL(boxMask & ~packet.getActiveMask(), 0);
+
+		// a ray can't hit the triangle without hitting its box
+		BOOST_CHECK_EQUAL(triangleMask & ~boxMask, 0);
+
+		for (int lane=0; lane<packet.size; lane++) {
+			const Vector3f invDirection(packet.invDirectionX[lane], packet.invDirectionY[lane], packet.invDirectionZ[lane]);
+
+			float distance = 0.0f;
+			const bool boxHit = intersectSlab(packet.getPoint(lane), invDirection, box, 100.0f, &distance);
+
+			BOOST_CHECK_EQUAL(boxHit, (boxMask & (1 << lane)) != 0);
+		}
+
+		// the other instruction sets must give the same results
+		for (const PacketKernels *kernel : kernels) {
+			RayPacket current = packet;
+
+			BOOST_CHECK_EQUAL(kernel->intersectBox(packet, box), boxMask);
+			BOOST_CHECK_EQUAL(kernel->intersectTriangle(current, p0, e1, e2), triangleMask);
+
+			for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+				BOOST_CHECK_CLOSE(current.maxDistance[lane], reference.maxDistance[lane], 0.001f);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(PacketKernelsFacePlaneTest)
+{
+	const Boxf box(Vector3f(0.0f), Vector3f(1.0f));
+	const float offsets[] = {-5.0f, 0.0f, 0.5f, 1.0f, 6.0f};
+	const float planes[] = {0.0f, 1.0f};
+
+	// axis parallel rays lying on the plane of a face, starting at both sides of the box and pointing toward and away from it
+	std::vector<Ray> rays;
+
+	for (int axis=0; axis<3; axis++) {
+		const int planeAxis = (axis + 1) % 3;
+		const int otherAxis = (axis + 2) % 3;
+
+		for (float start : {-5.0f, 6.0f}) {
+			for (float sign : {-1.0f, 1.0f}) {
+				for (float plane : planes) {
+					for (float offset : offsets) {
+						Vector3f point, direction(0.0f);
+						point[axis] = start;
+						point[planeAxis] = plane;
+						point[otherAxis] = offset;
+						direction[axis] = sign;
+
+						rays.push_back(Ray(point, direction));
+					}
+				}
+			}
+		}
+	}
+
+	for (const PacketKernels *kernel : getAvailableKernels()) {
+		for (std::size_t first=0; first<rays.size(); first+=RayPacket::MaxSize) {
+			RayPacket packet;
+
+			for (std::size_t i=first; i<std::min(first + RayPacket::MaxSize, rays.size()); i++) {
+				packet.add(rays[i], 100.0f);
+			}
+
+			const int mask = kernel->intersectBox(packet, box);
+
+			for (int lane=0; lane<packet.size; lane++) {
+				Ray ray = rays[first + lane];
+				ray.setMaxDistance(100.0f);
+
+				float distance = 0.0f;
+				const bool hit = intersectSlab(ray, box, &distance);
+
+				BOOST_CHECK_MESSAGE(hit == ((mask & (1 << lane)) != 0), kernel->name << " lane " << lane << " of packet " << first);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(PacketMinDistanceTest)
+{
+	const Boxf box(Vector3f(-1.0f, -1.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f));
+
+	// the rays start at z = -5, so the box spans the distances [5, 6]
+	const float minDistances[] = {0.0f, 4.0f, 5.5f, 7.0f};
+
+	RayPacket packet;
+
+	for (float minDistance : minDistances) {
+		packet.add(Ray(Vector3f(0.0f, 0.0f, -5.0f), Vector3f(0.0f, 0.0f, 1.0f), minDistance), 100.0f);
+	}
+
+	for (const PacketKernels *kernel : getAvailableKernels()) {
+		BOOST_CHECK_EQUAL(kernel->intersectBox(packet, box), 0x7);
+
+		// the triangle lies at z = 0, at distance 5
+		RayPacket current = packet;
+		BOOST_CHECK_EQUAL(kernel->intersectTriangle(current, Vector3f(-1.0f, -1.0f, 0.0f), Vector3f(4.0f, 0.0f, 0.0f), Vector3f(0.0f, 4.0f, 0.0f)), 0x3);
+		BOOST_CHECK_CLOSE(current.maxDistance[1], 5.0f, 0.001f);
+		BOOST_CHECK_EQUAL(current.maxDistance[2], 100.0f);
+	}
+
+	// the geometries tested one ray at a time skip the hits before the minimum distance, like the one of a ray that starts on the plane
+	TSolidGeometry<Plane> wall(Plane(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, -1.0f)), nullptr);
+
+	InstanceBVH instances;
+	instances.add(&wall, identity<float, 4>());
+	instances.build();
+
+	IntersectInfo infos[RayPacket::MaxSize];
+
+	BOOST_CHECK_EQUAL(instances.intersect(packet, infos), 0x3);
+	BOOST_CHECK_CLOSE(infos[1].distance, 5.0f, 0.01f);
+}
+
+BOOST_AUTO_TEST_CASE(PacketInstanceBVHTest)
+{
+	std::mt19937 engine(7);
+
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+	TSolidGeometry<Plane> floor(Plane(Vector3f(0.0f, 0.0f, 20.0f), Vector3f(0.0f, 0.0f, -1.0f)), nullptr);
+
+	InstanceBVH instances;
+	instances.add(&floor, identity<float, 4>());
+
+	for (int i=-2; i<=2; i++) {
+		instances.add(&sphere, translate<float>(Vector3f(0.4f*i, 0.0f, 5.0f + 2.0f*i)) * scale<float, 4>(Vector3f(0.5f)));
+	}
+
+	instances.build();
+
+	for (int i=0; i<50; i++) {
+		RayPacket packet = makePacket(engine, RayPacket::MaxSize);
+
+		IntersectInfo infos[RayPacket::MaxSize];
+		const int mask = instances.intersect(packet, infos);
+
+		for (int lane=0; lane<packet.size; lane++) {
+			IntersectInfo info;
+			const bool hit = instances.intersect(Ray(packet.getPoint(lane), packet.getDirection(lane)), &info);
+
+			BOOST_REQUIRE_EQUAL(hit, (mask & (1 << lane)) != 0);
+
+			if (hit) {
+				BOOST_CHECK_CLOSE(infos[lane].distance, info.distance, 0.01f);
+				BOOST_CHECK_SMALL(abs(infos[lane].point - info.point), 0.001f);
+				BOOST_CHECK_SMALL(abs(infos[lane].normal - info.normal), 0.001f);
+			}
+		}
+	}
+}
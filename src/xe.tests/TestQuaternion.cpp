@@ -0,0 +1,123 @@
+
+#include <cmath>
+
+#include <xe/Quaternion.hpp>
+#include <xe/Transform.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace xe;
+
+namespace {
+	void checkClose(const Matrix4f &m1, const Matrix4f &m2) {
+		for (int i=0; i<4; i++) {
+			for (int j=0; j<4; j++) {
+				BOOST_CHECK_SMALL(m1(i, j) - m2(i, j), 1e-5f);
+			}
+		}
+	}
+
+	void checkClose(const Vector3f &v1, const Vector3f &v2) {
+		BOOST_CHECK_SMALL(abs(v1 - v2), 1e-5f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(QuaternionRotationTest)
+{
+	const Vector3f axis = normalize(Vector3f(1.0f, -2.0f, 0.5f));
+	const float angle = rad(75.0f);
+
+	const Quaternionf q(Rotation<float>{angle, axis});
+
+	BOOST_CHECK_CLOSE(norm(q), 1.0f, 1e-4f);
+
+	// same matrix than the trigonometric version
+	checkClose(rotate(q), rotate(angle, axis));
+	checkClose(rotate(Quaternionf(Rotation<float>{rad(30.0f), Vector3f(0.0f, 0.0f, 1.0f)})), rotatez(rad(30.0f)));
+
+	const Vector3f v(3.0f, 1.0f, -2.0f);
+	checkClose(transform(q, v), transform(rotate(q), v));
+
+	// round trips
+	const Rotation<float> r = q;
+	BOOST_CHECK_CLOSE(r.angle, angle, 1e-3f);
+	checkClose(r.axis, axis);
+
+	const Quaternionf fromMatrix(rotate(angle, axis));
+	BOOST_CHECK_CLOSE(std::abs(dot(fromMatrix, q)), 1.0f, 1e-4f);
+
+	// composition and inverse
+	const Quaternionf q2(Rotation<float>{rad(-40.0f), Vector3f(0.0f, 1.0f, 0.0f)});
+
+	checkClose(rotate(q * q2), rotate(q) * rotate(q2));
+	checkClose(transform(q * inverse(q), v), v);
+	checkClose(transform(conj(q), transform(q, v)), v);
+}
+
+BOOST_AUTO_TEST_CASE(QuaternionInterpolationTest)
+{
+	const Vector3f axis(0.0f, 1.0f, 0.0f);
+	const Quaternionf q1(Rotation<float>{rad(10.0f), axis});
+	const Quaternionf q2(Rotation<float>{rad(130.0f), axis});
+
+	// the end points
+	BOOST_CHECK_CLOSE(dot(slerp(q1, q2, 0.0f), q1), 1.0f, 1e-4f);
+	BOOST_CHECK_CLOSE(dot(slerp(q1, q2, 1.0f), q2), 1.0f, 1e-4f);
+	BOOST_CHECK_CLOSE(dot(nlerp(q1, q2, 1.0f), q2), 1.0f, 1e-4f);
+
+	// slerp goes at constant angular speed
+	for (int i=0; i<=8; i++) {
+		const float t = i / 8.0f;
+		const Rotation<float> r = slerp(q1, q2, t);
+
+		BOOST_CHECK_CLOSE(r.angle, rad(10.0f + 120.0f*t), 1e-2f);
+		BOOST_CHECK_CLOSE(norm(nlerp(q1, q2, t)), 1.0f, 1e-4f);
+	}
+
+	// the shortest path, even if the quaternions are in opposite hemispheres
+	const Rotation<float> middle = slerp(q1, -q2, 0.5f);
+	BOOST_CHECK_CLOSE(middle.angle, rad(70.0f), 1e-2f);
+	BOOST_CHECK_CLOSE(dot(nlerp(q1, -q2, 0.5f), slerp(q1, q2, 0.5f)), 1.0f, 1e-4f);
+
+	// nearly equal quaternions
+	BOOST_CHECK_CLOSE(norm(slerp(q1, q1, 0.3f)), 1.0f, 1e-4f);
+}
+
+BOOST_AUTO_TEST_CASE(TransformTest)
+{
+	BOOST_CHECK_EQUAL(sizeof(Transformf), 40u);
+
+	const Transformf t (
+		Vector3f(1.0f, 2.0f, 3.0f),
+		Quaternionf(Rotation<float>{rad(60.0f), normalize(Vector3f(1.0f, 1.0f, 0.0f))}),
+		Vector3f(2.0f, 0.5f, 3.0f)
+	);
+
+	const Matrix4f m = translate(t.translation) * rotate(t.rotation) * scale<float, 4>(t.scaling);
+
+	checkClose(t.toMatrix(), m);
+	checkClose(Transformf().toMatrix(), identity<float, 4>());
+
+	const Vector3f point(-1.0f, 4.0f, 2.0f);
+	checkClose(transform(t, point), transform(m, point));
+
+	// decomposition
+	const Transformf decomposed(m);
+	checkClose(decomposed.translation, t.translation);
+	checkClose(decomposed.scaling, t.scaling);
+	checkClose(decomposed.toMatrix(), m);
+
+	const Matrix4f mirror = m * scale<float, 4>(Vector3f(-1.0f, 1.0f, 1.0f));
+	checkClose(Transformf(mirror).toMatrix(), mirror);
+
+	// composition and inverse, with uniform scales
+	const Transformf t1(Vector3f(0.0f, -1.0f, 5.0f), Quaternionf(Rotation<float>{rad(20.0f), Vector3f(0.0f, 0.0f, 1.0f)}), Vector3f(2.0f));
+
+	checkClose((t1 * t).toMatrix(), t1.toMatrix() * m);
+	checkClose((inverse(t1) * t1).toMatrix(), identity<float, 4>());
+
+	// interpolation
+	const Transformf middle = lerp(t1, t, 0.5f);
+	checkClose(middle.translation, Vector3f(0.5f, 0.5f, 4.0f));
+	checkClose(lerp(t1, t, 1.0f).toMatrix(), m);
+}
@@ -0,0 +1,173 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <xe/sg/Sampler.hpp>
+
+using namespace xe;
+using namespace xe::sg;
+
+static void checkRange(const Sampler &sampler)
+{
+	for (int y=0; y<4; y++) {
+		for (int x=0; x<4; x++) {
+			for (int dimension=0; dimension<4; dimension++) {
+				for (int i=0; i<64; i++) {
+					const Vector2f sample = sampler.sample({x, y}, i, dimension);
+
+					BOOST_REQUIRE(sample.x >= 0.0f && sample.x < 1.0f);
+					BOOST_REQUIRE(sample.y >= 0.0f && sample.y < 1.0f);
+
+					// no hidden state
+					BOOST_REQUIRE_EQUAL(sample, sampler.sample({x, y}, i, dimension));
+				}
+			}
+		}
+	}
+
+	// the pixels and the dimensions get different sequences
+	BOOST_CHECK(sampler.sample({0, 0}, 0, 0) != sampler.sample({1, 0}, 0, 0));
+	BOOST_CHECK(sampler.sample({0, 0}, 0, 0) != sampler.sample({0, 1}, 0, 0));
+	BOOST_CHECK(sampler.sample({0, 0}, 0, 0) != sampler.sample({0, 0}, 0, 1));
+}
+
+/**
+ * @brief Root mean square error of the integral of a smooth function over the unit square, estimated in many pixels.
+ */
+template<typename Generator>
+static float integrationError(Generator generator, int sampleCount)
+{
+	const float reference = (1.0f - std::cos(1.0f)) * (1.0f - std::cos(1.0f));
+
+	float error = 0.0f;
+	const int pixelCount = 256;
+
+	for (int pixel=0; pixel<pixelCount; pixel++) {
+		float sum = 0.0f;
+
+		for (int i=0; i<sampleCount; i++) {
+			const Vector2f sample = generator(Vector2i(pixel % 16, pixel / 16), i);
+			sum += std::sin(sample.x) * std::sin(sample.y);
+		}
+
+		const float difference = sum / sampleCount - reference;
+		error += difference * difference;
+	}
+
+	return std::sqrt(error / pixelCount);
+}
+
+BOOST_AUTO_TEST_CASE(SamplerRangeTest)
+{
+	checkRange(HaltonSampler());
+	checkRange(SobolSampler());
+	checkRange(BlueNoiseSampler());
+
+	BOOST_CHECK_EQUAL(radicalInverse(0, 2), 0.0f);
+	BOOST_CHECK_EQUAL(radicalInverse(1, 2), 0.5f);
+	BOOST_CHECK_EQUAL(radicalInverse(3, 2), 0.75f);
+	BOOST_CHECK_CLOSE(radicalInverse(1, 3), 1.0f / 3.0f, 0.001f);
+	BOOST_CHECK_CLOSE(radicalInverse(5, 3), 7.0f / 9.0f, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(SamplerStratificationTest)
+{
+	const SobolSampler sobol;
+	const HaltonSampler halton;
+
+	for (int dimension=0; dimension<4; dimension++) {
+		const Vector2i pixel = {dimension, 7};
+
+		// the first 16 Sobol samples have one point in each elementary interval of area 1/16
+		std::vector<int> cells(16, 0), rows(16, 0), columns(16, 0);
+
+		for (int i=0; i<16; i++) {
+			const Vector2f sample = sobol.sample(pixel, i, dimension);
+
+			cells[static_cast<int>(sample.y * 4)*4 + static_cast<int>(sample.x * 4)]++;
+			columns[static_cast<int>(sample.x * 16)]++;
+			rows[static_cast<int>(sample.y * 16)]++;
+		}
+
+		for (int i=0; i<16; i++) {
+			BOOST_CHECK_EQUAL(cells[i], 1);
+			BOOST_CHECK_EQUAL(columns[i], 1);
+			BOOST_CHECK_EQUAL(rows[i], 1);
+		}
+	}
+
+	// the rotated Halton points keep their one dimensional strata, in base 2 and 3
+	std::vector<int> stratumX(8, 0), stratumY(9, 0);
+
+	for (int i=0; i<8; i++) {
+		stratumX[static_cast<int>(halton.sample({5, 3}, i, 0).x * 8)]++;
+	}
+
+	for (int i=0; i<9; i++) {
+		stratumY[static_cast<int>(halton.sample({5, 3}, i, 0).y * 9)]++;
+	}
+
+	for (int count : stratumX) {
+		BOOST_CHECK_EQUAL(count, 1);
+	}
+
+	for (int count : stratumY) {
+		BOOST_CHECK_EQUAL(count, 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BlueNoiseMaskTest)
+{
+	const BlueNoiseSampler sampler;
+	const int size = BlueNoiseSampler::TileSize;
+
+	// each level appears once
+	std::vector<int> levels(size*size, 0);
+
+	float difference = 0.0f;
+
+	for (int y=0; y<size; y++) {
+		for (int x=0; x<size; x++) {
+			const float value = sampler.getMaskValue(x, y);
+
+			levels[static_cast<int>(value * size * size)]++;
+			difference += std::abs(value - sampler.getMaskValue(x + 1, y));
+		}
+	}
+
+	for (int count : levels) {
+		BOOST_REQUIRE_EQUAL(count, 1);
+	}
+
+	// the mask wraps around
+	BOOST_CHECK_EQUAL(sampler.getMaskValue(-1, 2), sampler.getMaskValue(size - 1, 2));
+	BOOST_CHECK_EQUAL(sampler.getMaskValue(3, size), sampler.getMaskValue(3, 0));
+
+	// neighbours are less alike than in white noise, where the mean difference is 1/3
+	BOOST_CHECK_GT(difference / (size*size), 0.4f);
+}
+
+BOOST_AUTO_TEST_CASE(SamplerConvergenceTest)
+{
+	std::mt19937 engine(11);
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+	const float randomError = integrationError([&](const Vector2i &, int) {
+		return Vector2f(distribution(engine), distribution(engine));
+	}, 16);
+
+	const SobolSampler sobol;
+	const HaltonSampler halton;
+	const BlueNoiseSampler blueNoise;
+
+	const float sobolError = integrationError([&](const Vector2i &pixel, int i) { return sobol.sample(pixel, i, 0); }, 16);
+	const float haltonError = integrationError([&](const Vector2i &pixel, int i) { return halton.sample(pixel, i, 0); }, 16);
+	const float blueNoiseError = integrationError([&](const Vector2i &pixel, int i) { return blueNoise.sample(pixel, i, 0); }, 16);
+
+	// with the same number of samples, the low discrepancy sequences get at least twice as close
+	BOOST_CHECK_LT(sobolError, 0.5f * randomError);
+	BOOST_CHECK_LT(haltonError, 0.5f * randomError);
+	BOOST_CHECK_LT(blueNoiseError, 0.5f * randomError);
+}
@@ -10,6 +10,13 @@
 
 #include <xe/sg/Scene.hpp>
 #include <xe/sg/SceneNode.hpp>
+#include <xe/sg/TSolidGeometry.hpp>
+#include <xe/sg/Intersect.hpp>
+#include <xe/sg/Frustum.hpp>
+#include <xe/sg/RenderQueue.hpp>
+
+#include <cmath>
+#include <limits>
 
 using namespace xe;
 using namespace xe::sg;
@@ -112,8 +119,444 @@ BOOST_AUTO_TEST_CASE( RayTest )
 	BOOST_CHECK_EQUAL( ray1.getPointAt(0.5f), ray1.getPoint() + 0.5f * ray1.getDirection() );
 }
 
+BOOST_AUTO_TEST_CASE(RayIntervalTest)
+{
+	Ray ray(Vector3f(1.0f, 2.0f, 3.0f), Vector3f(0.0f, -2.0f, 4.0f));
+
+	// the whole ray by default
+	BOOST_CHECK_EQUAL(ray.getMinDistance(), 0.0f);
+	BOOST_CHECK_EQUAL(ray.getMaxDistance(), std::numeric_limits<float>::max());
+
+	for (int coord=0; coord<3; coord++) {
+		BOOST_CHECK_EQUAL(ray.getInvDirection()[coord], 1.0f / ray.getDirection()[coord]);
+		BOOST_CHECK_EQUAL(ray.getSign(coord), ray.getDirection()[coord] < 0.0f ? 1 : 0);
+	}
+
+	BOOST_CHECK_EQUAL(ray.getSign(0), 0);
+	BOOST_CHECK_EQUAL(ray.getSign(1), 1);
+	BOOST_CHECK_EQUAL(ray.getSign(2), 0);
+
+	// clipping only shrinks the ray
+	ray.setMinDistance(1.0f);
+	BOOST_CHECK(!ray.contains(0.5f));
+	BOOST_CHECK(!ray.clip(0.5f));
+
+	BOOST_CHECK(ray.clip(10.0f));
+	BOOST_CHECK_EQUAL(ray.getMaxDistance(), 10.0f);
+	BOOST_CHECK(!ray.clip(20.0f));
+	BOOST_CHECK_EQUAL(ray.getMaxDistance(), 10.0f);
+	BOOST_CHECK(!ray.contains(10.0f));
+	BOOST_CHECK(ray.contains(1.0f));
+
+	// the boxes outside of the ray are ignored
+	Boxf box;
+	box.expand(Vector3f(0.0f, -10.0f, 5.0f));
+	box.expand(Vector3f(2.0f, 10.0f, 6.0f));
+	IntersectInfo info;
+
+	ray.clip(2.0f);
+	BOOST_CHECK(!intersect(ray, box, &info));
+
+	ray.setMaxDistance(100.0f);
+	BOOST_CHECK(intersect(ray, box, &info));
+	BOOST_CHECK_CLOSE(info.distance, std::sqrt(5.0f), 0.001f);
+}
+
 BOOST_AUTO_TEST_CASE(ScenegraphTest)
 {
 	auto root = std::make_unique<SceneNode>();
 
 }
+
+BOOST_AUTO_TEST_CASE(SceneIntersectTest)
+{
+	Scene scene;
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+	TSolidGeometry<Plane> floor(Plane(Vector3f(0.0f, -10.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f)), nullptr);
+
+	scene.getRootNode()->addChild(identity<float, 4>(), &floor);
+
+	SceneNode *group = scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)), nullptr);
+	SceneNode *nearNode = group->addChild(translate<float>(Vector3f(0.0f, 0.0f, -5.0f)), &sphere);
+	group->addChild(translate<float>(Vector3f(0.0f, 0.0f, 5.0f)), &sphere);
+
+	IntersectInfo info;
+
+	// the nearest sphere is at z=5, with radius 1
+	BOOST_CHECK(scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f)), &info));
+	BOOST_CHECK_CLOSE(info.distance, 4.0f, 0.001f);
+	BOOST_CHECK_CLOSE(info.point.z, 4.0f, 0.001f);
+
+	// only the floor plane below
+	BOOST_CHECK(scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, -1.0f, 0.0f)), &info));
+	BOOST_CHECK_CLOSE(info.distance, 10.0f, 0.001f);
+
+	BOOST_CHECK(!scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, -1.0f)), &info));
+
+	// move a node, and a the whole group, scaling it
+	nearNode->setTransform(translate<float>(Vector3f(3.0f, 0.0f, -5.0f)));
+	BOOST_CHECK(scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f)), &info));
+	BOOST_CHECK_CLOSE(info.distance, 14.0f, 0.001f);
+
+	group->setTransform(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)) * scale<float, 4>(Vector3f(2.0f)));
+	BOOST_CHECK(scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f)), &info));
+	BOOST_CHECK_CLOSE(info.distance, 18.0f, 0.001f);
+
+	// remove the far sphere
+	group->removeChild(group->getChild(1));
+	BOOST_CHECK(!scene.intersect(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f)), &info));
+}
+
+BOOST_AUTO_TEST_CASE(SceneOccludedTest)
+{
+	Scene scene;
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+	TSolidGeometry<Plane> floor(Plane(Vector3f(0.0f, -10.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f)), nullptr);
+
+	scene.getRootNode()->addChild(identity<float, 4>(), &floor);
+	scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)) * scale<float, 4>(Vector3f(2.0f)), &sphere);
+
+	const Ray forward(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f));
+	const Ray down(Vector3f(0.0f), Vector3f(0.0f, -1.0f, 0.0f));
+
+	// the scaled sphere starts at z=8
+	BOOST_CHECK(scene.occluded(Ray(forward.getPoint(), forward.getDirection(), 0.0f, 100.0f)));
+	BOOST_CHECK(scene.occluded(Ray(forward.getPoint(), forward.getDirection(), 0.0f, 8.5f)));
+	BOOST_CHECK(!scene.occluded(Ray(forward.getPoint(), forward.getDirection(), 0.0f, 7.5f)));
+
+	// starting past the sphere
+	BOOST_CHECK(!scene.occluded(Ray(forward.getPoint(), forward.getDirection(), 12.5f, 100.0f)));
+
+	BOOST_CHECK(scene.occluded(Ray(down.getPoint(), down.getDirection(), 0.0f, 11.0f)));
+	BOOST_CHECK(!scene.occluded(Ray(down.getPoint(), down.getDirection(), 0.0f, 9.0f)));
+
+	BOOST_CHECK(!scene.occluded(Ray(Vector3f(0.0f), Vector3f(0.0f, 0.0f, -1.0f), 0.0f, 100.0f)));
+	BOOST_CHECK(!scene.occluded(Ray(Vector3f(0.0f), Vector3f(0.0f, 1.0f, 0.0f))));
+}
+
+BOOST_AUTO_TEST_CASE(SceneNodeTransformComponentsTest)
+{
+	Scene scene;
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+
+	SceneNode *node = scene.getRootNode()->addChild(identity<float, 4>(), &sphere);
+
+	const Ray forward(Vector3f(0.0f), Vector3f(0.0f, 0.0f, 1.0f));
+	IntersectInfo info;
+
+	// the matrix is built from the components when the scene needs it
+	Transformf transform(Vector3f(0.0f, 0.0f, 10.0f), Quaternionf(), Vector3f(2.0f));
+	node->setTransform(transform);
+
+	BOOST_CHECK(scene.intersect(forward, &info));
+	BOOST_CHECK_CLOSE(info.distance, 8.0f, 0.001f);
+
+	// update only the translation, as an animator would do
+	transform.translation.z = 20.0f;
+	node->setTransform(transform);
+
+	BOOST_CHECK(scene.intersect(forward, &info));
+	BOOST_CHECK_CLOSE(info.distance, 18.0f, 0.001f);
+	BOOST_CHECK_CLOSE(node->getTransformComponents().translation.z, 20.0f, 0.001f);
+
+	// a matrix set directly is decomposed on request
+	node->setTransform(translate<float>(Vector3f(0.0f, 0.0f, 5.0f)) * rotatey<float>(rad(90.0f)));
+
+	const Transformf components = node->getTransformComponents();
+	BOOST_CHECK_CLOSE(components.translation.z, 5.0f, 0.001f);
+	BOOST_CHECK_CLOSE(components.scaling.x, 1.0f, 0.001f);
+	BOOST_CHECK_CLOSE(Rotation<float>(components.rotation).angle, rad(90.0f), 0.01f);
+}
+
+BOOST_AUTO_TEST_CASE(SceneTransformHierarchyTest)
+{
+	Scene scene;
+
+	SceneNode *group = scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)), nullptr);
+	SceneNode *child = group->addChild(translate<float>(Vector3f(1.0f, 0.0f, 0.0f)), nullptr);
+	SceneNode *grandChild = child->addChild(scale<float, 4>(Vector3f(2.0f)), nullptr);
+	SceneNode *sibling = scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 5.0f, 0.0f)), nullptr);
+
+	const TransformHierarchy &hierarchy = scene.getTransformHierarchy();
+
+	// depth first order, with the descendants of each node right after it
+	BOOST_REQUIRE_EQUAL(hierarchy.getNodeCount(), 5);
+	BOOST_CHECK_EQUAL(hierarchy.getNode(0), scene.getRootNode());
+	BOOST_CHECK_EQUAL(hierarchy.getNode(1), group);
+	BOOST_CHECK_EQUAL(hierarchy.getNode(3), grandChild);
+	BOOST_CHECK_EQUAL(hierarchy.getNode(4), sibling);
+	BOOST_CHECK_EQUAL(hierarchy.getParent(3), 2);
+	BOOST_CHECK_EQUAL(hierarchy.getParent(4), 0);
+	BOOST_CHECK_EQUAL(hierarchy.getSubtreeEnd(1), 4);
+	BOOST_CHECK_EQUAL(hierarchy.getSubtreeEnd(0), 5);
+
+	BOOST_CHECK_EQUAL(scene.getWorldTransform(grandChild), (translate<float>(Vector3f(1.0f, 0.0f, 10.0f)) * scale<float, 4>(Vector3f(2.0f))));
+
+	// moving a node updates its descendants only
+	group->setTransform(translate<float>(Vector3f(0.0f, 0.0f, 20.0f)));
+
+	BOOST_CHECK_EQUAL(scene.getWorldTransform(child), translate<float>(Vector3f(1.0f, 0.0f, 20.0f)));
+	BOOST_CHECK_EQUAL(scene.getWorldTransform(grandChild), (translate<float>(Vector3f(1.0f, 0.0f, 20.0f)) * scale<float, 4>(Vector3f(2.0f))));
+	BOOST_CHECK_EQUAL(scene.getWorldTransform(sibling), translate<float>(Vector3f(0.0f, 5.0f, 0.0f)));
+
+	// nothing has changed, so nothing is recomputed
+	TransformHierarchy copy = scene.getTransformHierarchy();
+	BOOST_CHECK(!copy.update());
+
+	// structural changes rebuild the hierarchy
+	group->removeChild(child);
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getNodeCount(), 3);
+	BOOST_CHECK_EQUAL(scene.getWorldTransform(sibling), translate<float>(Vector3f(0.0f, 5.0f, 0.0f)));
+}
+
+BOOST_AUTO_TEST_CASE(FrustumBoxTest)
+{
+	// looking down the negative z axis, from z=10
+	const Matrix4f view = lookat<float>(Vector3f(0.0f, 0.0f, 10.0f), Vector3f(0.0f), Vector3f(0.0f, 1.0f, 0.0f));
+	const Matrix4f proj = perspective<float>(rad(60.0f), 1.0f, 1.0f, 100.0f);
+	const Frustum frustum(proj * view);
+
+	BOOST_CHECK(frustum.isInside(Vector3f(0.0f)));
+	BOOST_CHECK(!frustum.isInside(Vector3f(0.0f, 0.0f, 20.0f)));
+
+	BOOST_CHECK_EQUAL(frustum.test(Boxf(Vector3f(-1.0f), Vector3f(1.0f))), FrustumTest::Inside);
+	BOOST_CHECK_EQUAL(frustum.test(Boxf(Vector3f(-1.0f, -1.0f, 15.0f), Vector3f(1.0f, 1.0f, 20.0f))), FrustumTest::Outside);
+	BOOST_CHECK_EQUAL(frustum.test(Boxf(Vector3f(50.0f, -1.0f, -1.0f), Vector3f(60.0f, 1.0f, 1.0f))), FrustumTest::Outside);
+	BOOST_CHECK_EQUAL(frustum.test(Boxf(Vector3f(-1.0f, -1.0f, -1.0f), Vector3f(1.0f, 1.0f, 20.0f))), FrustumTest::Intersect);
+	BOOST_CHECK_EQUAL(frustum.test(Boxf()), FrustumTest::Outside);
+
+	// without planes, everything is inside
+	BOOST_CHECK_EQUAL(Frustum().test(Boxf(Vector3f(1000.0f), Vector3f(2000.0f))), FrustumTest::Inside);
+}
+
+BOOST_AUTO_TEST_CASE(SceneTransformHierarchyBoundsTest)
+{
+	Scene scene;
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+	TSolidGeometry<Plane> floor(Plane(Vector3f(0.0f, -10.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f)), nullptr);
+
+	SceneNode *group = scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)), nullptr);
+	group->addChild(translate<float>(Vector3f(-5.0f, 0.0f, 0.0f)), &sphere);
+	SceneNode *right = group->addChild(translate<float>(Vector3f(5.0f, 0.0f, 0.0f)) * scale<float, 4>(Vector3f(2.0f)), &sphere);
+
+	const TransformHierarchy &hierarchy = scene.getTransformHierarchy();
+
+	BOOST_CHECK(!hierarchy.getBox(1).isValid());
+	BOOST_CHECK_EQUAL(hierarchy.getBox(3), Boxf(Vector3f(3.0f, -2.0f, 8.0f), Vector3f(7.0f, 2.0f, 12.0f)));
+	BOOST_CHECK_EQUAL(hierarchy.getSubtreeBox(1), Boxf(Vector3f(-6.0f, -2.0f, 8.0f), Vector3f(7.0f, 2.0f, 12.0f)));
+	BOOST_CHECK_EQUAL(hierarchy.getSubtreeBox(0), hierarchy.getSubtreeBox(1));
+
+	// moved nodes update the boxes of their ancestors
+	right->setTransform(translate<float>(Vector3f(5.0f, 10.0f, 0.0f)));
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getSubtreeBox(1), Boxf(Vector3f(-6.0f, -1.0f, 9.0f), Vector3f(6.0f, 11.0f, 11.0f)));
+
+	// geometries without bounds cover everything
+	scene.getRootNode()->addChild(identity<float, 4>(), &floor);
+	BOOST_CHECK(scene.getTransformHierarchy().getSubtreeBox(0).isInside(Vector3f(1.0e30f)));
+}
+
+// sphere that counts its edits, like a mesh does with its vertex buffers
+struct EditableSphere : public TSolidGeometry<Sphere> {
+	EditableSphere() : TSolidGeometry<Sphere>(Sphere(1.0f), nullptr) {}
+
+	virtual std::uint32_t getVersion() const override {
+		return version;
+	}
+
+	std::uint32_t version = 0;
+};
+
+BOOST_AUTO_TEST_CASE(SceneTransformHierarchyGeometryEditTest)
+{
+	Scene scene;
+	EditableSphere sphere;
+
+	SceneNode *group = scene.getRootNode()->addChild(translate<float>(Vector3f(0.0f, 0.0f, 10.0f)), nullptr);
+	group->addChild(identity<float, 4>(), &sphere);
+
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getSubtreeBox(1), Boxf(Vector3f(-1.0f, -1.0f, 9.0f), Vector3f(1.0f, 1.0f, 11.0f)));
+
+	// the shape changes without moving the node
+	sphere.solid.setRadius(3.0f);
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getSubtreeBox(1), Boxf(Vector3f(-1.0f, -1.0f, 9.0f), Vector3f(1.0f, 1.0f, 11.0f)));
+
+	sphere.version++;
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getBox(2), Boxf(Vector3f(-3.0f, -3.0f, 7.0f), Vector3f(3.0f, 3.0f, 13.0f)));
+	BOOST_CHECK_EQUAL(scene.getTransformHierarchy().getSubtreeBox(0), Boxf(Vector3f(-3.0f, -3.0f, 7.0f), Vector3f(3.0f, 3.0f, 13.0f)));
+}
+
+BOOST_AUTO_TEST_CASE(RenderQueueTest)
+{
+	RenderQueue queue;
+
+	// the identifiers are given in order of appearance
+	const int subsets[3] = {};
+	BOOST_CHECK_EQUAL(queue.getMaterialId(nullptr), 0);
+	BOOST_CHECK_EQUAL(queue.getSubsetId(&subsets[2]), 0);
+	BOOST_CHECK_EQUAL(queue.getSubsetId(&subsets[0]), 1);
+	BOOST_CHECK_EQUAL(queue.getSubsetId(&subsets[2]), 0);
+
+	auto add = [&queue](std::uint64_t key, int node) {
+		RenderItem item;
+		item.node = node;
+		queue.add(key, item);
+	};
+
+	add(RenderQueue::makeTransparentKey(1, 0, 5.0f), 0);
+	add(RenderQueue::makeOpaqueKey(2, 0, 1.0f), 1);
+	add(RenderQueue::makeOpaqueKey(1, 1, 1.0f), 2);
+	add(RenderQueue::makeTransparentKey(2, 0, 20.0f), 3);
+	add(RenderQueue::makeSetupKey(0), 4);
+	add(RenderQueue::makeOpaqueKey(1, 0, 8.0f), 5);
+	add(RenderQueue::makeOpaqueKey(1, 0, 2.0f), 6);
+	add(RenderQueue::makeSetupKey(1), 7);
+	add(RenderQueue::makeOpaqueKey(1, 0, 2.0f), 8);
+	add(RenderQueue::makeOpaqueKey(1, 0, -3.0f), 9);
+
+	queue.sort();
+
+	// setup in order, opaque by material, subset and front to back, and then transparent back to front
+	const int expected[] = {4, 7, 9, 6, 8, 5, 2, 1, 3, 0};
+
+	BOOST_REQUIRE_EQUAL(queue.getItemCount(), 10);
+
+	for (int i=0; i<queue.getItemCount(); i++) {
+		BOOST_CHECK_EQUAL(queue.getItem(i).node, expected[i]);
+
+		if (i > 0) {
+			BOOST_CHECK(queue.getKey(i - 1) <= queue.getKey(i));
+		}
+	}
+
+	queue.clear();
+	BOOST_CHECK_EQUAL(queue.getItemCount(), 0);
+	BOOST_CHECK_EQUAL(queue.getSubsetId(&subsets[0]), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SceneNodeNameIndexTest)
+{
+	Scene scene;
+	SceneNode *root = scene.getRootNode();
+
+	SceneNode *level = root->addChild(std::make_unique<SceneNode>("level"));
+	SceneNode *enemies = level->addChild(std::make_unique<SceneNode>("enemies"));
+	SceneNode *boss = enemies->addChild(std::make_unique<SceneNode>("boss"));
+	SceneNode *items = level->addChild(std::make_unique<SceneNode>("items"));
+
+	BOOST_CHECK_EQUAL(scene.findNode("boss"), boss);
+	BOOST_CHECK_EQUAL(root->findNode("items"), items);
+	BOOST_CHECK_EQUAL(level->getChild("enemies"), enemies);
+	BOOST_CHECK_EQUAL(level->getChild("boss"), static_cast<SceneNode*>(nullptr));
+	BOOST_CHECK_EQUAL(scene.findNodeByPath("level/enemies/boss"), boss);
+	BOOST_CHECK_EQUAL(scene.findNodeByPath(boss->toString()), boss);
+	BOOST_CHECK_EQUAL(scene.findNodeByPath("level/boss"), static_cast<SceneNode*>(nullptr));
+
+	// the searches from a node are limited to its subtree
+	BOOST_CHECK_EQUAL(items->findNode("boss"), static_cast<SceneNode*>(nullptr));
+
+	// renamed nodes are found only by their new name
+	boss->setName("dragon");
+	BOOST_CHECK_EQUAL(scene.findNode("boss"), static_cast<SceneNode*>(nullptr));
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), boss);
+	BOOST_CHECK_EQUAL(enemies->getChild("dragon"), boss);
+
+	// with repeated names, the node that got the name first is found
+	SceneNode *itemsDragon = items->addChild(std::make_unique<SceneNode>("dragon"));
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), boss);
+	BOOST_CHECK_EQUAL(items->findNode("dragon"), itemsDragon);
+
+	// removed subtrees leave the index
+	SceneNodePtr removed = level->removeChild(enemies);
+	BOOST_CHECK_EQUAL(scene.findNode("enemies"), static_cast<SceneNode*>(nullptr));
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), itemsDragon);
+	BOOST_CHECK_EQUAL(level->getChild("enemies"), static_cast<SceneNode*>(nullptr));
+
+	level->addChild(std::move(removed));
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), itemsDragon);
+	BOOST_CHECK_EQUAL(scene.findNodeByPath("/level/enemies/dragon"), boss);
+
+	// renamed nodes go after the ones that already had the name, and searches from a node skip the ones outside of its subtree
+	itemsDragon->setName("shield");
+	SceneNode *nested = itemsDragon->addChild(std::make_unique<SceneNode>("dragon"));
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), boss);
+	BOOST_CHECK_EQUAL(items->findNode("dragon"), nested);
+
+	itemsDragon->setName("dragon");
+	BOOST_CHECK_EQUAL(scene.findNode("dragon"), boss);
+	BOOST_CHECK_EQUAL(items->findNode("dragon"), nested);
+	BOOST_CHECK_EQUAL(itemsDragon->findNode("dragon"), itemsDragon);
+	BOOST_CHECK_EQUAL(enemies->findNode("dragon"), boss);
+}
+
+BOOST_AUTO_TEST_CASE(SceneNodePoolTest)
+{
+	SceneNodePtr removed;
+
+	{
+		Scene scene;
+		SceneNode *node = nullptr;
+
+		for (int i=0; i<3000; i++) {
+			node = scene.getRootNode()->addChild(translate<float>(Vector3f(float(i), 0.0f, 0.0f)), nullptr);
+		}
+
+		node->addChild(identity<float, 4>(), nullptr)->setName("child");
+
+		removed = scene.getRootNode()->removeChild(node);
+	}
+
+	// the nodes taken out of a scene keep its pool alive
+	BOOST_CHECK_EQUAL(removed->getTransform(), translate<float>(Vector3f(2999.0f, 0.0f, 0.0f)));
+	BOOST_CHECK_EQUAL(removed->getChild("child")->getParent(), removed.get());
+
+	removed->addChild(std::make_unique<SceneNode>("heap"));
+	removed.reset();
+}
+
+BOOST_AUTO_TEST_CASE(SceneParallelUpdateTest)
+{
+	TSolidGeometry<Sphere> sphere(Sphere(1.0f), nullptr);
+
+	Scene serialScene, parallelScene;
+	parallelScene.setSplitDepth(2);
+
+	std::vector<SceneNode*> serialNodes, parallelNodes;
+
+	auto build = [&sphere](Scene &scene, std::vector<SceneNode*> &nodes) {
+		nodes.push_back(scene.getRootNode());
+
+		for (int i=1; i<2000; i++) {
+			SceneNode *parent = nodes[(i - 1) / 6];
+			const Matrix4f transform = translate<float>(Vector3f(float(i % 7), float(i % 5) - 2.0f, float(i % 3))) * scale<float, 4>(Vector3f(1.0f + 0.1f*(i % 4)));
+
+			nodes.push_back(parent->addChild(transform, (i % 3) ? &sphere : nullptr));
+		}
+	};
+
+	build(serialScene, serialNodes);
+	build(parallelScene, parallelNodes);
+
+	auto check = [&serialScene, &parallelScene]() {
+		const TransformHierarchy &serial = serialScene.getTransformHierarchy();
+		const TransformHierarchy &parallel = parallelScene.getTransformHierarchy();
+
+		BOOST_REQUIRE_EQUAL(serial.getNodeCount(), parallel.getNodeCount());
+
+		for (int index=0; index<serial.getNodeCount(); index++) {
+			BOOST_CHECK_EQUAL(serial.getWorldTransform(index), parallel.getWorldTransform(index));
+			BOOST_CHECK_EQUAL(serial.getSubtreeBox(index), parallel.getSubtreeBox(index));
+		}
+	};
+
+	check();
+
+	// moving nodes above, at and below the split depth
+	for (int i : {1, 9, 300, 1500}) {
+		serialNodes[i]->setTransform(translate<float>(Vector3f(0.0f, 10.0f, 0.0f)));
+		parallelNodes[i]->setTransform(translate<float>(Vector3f(0.0f, 10.0f, 0.0f)));
+	}
+
+	check();
+
+	BOOST_CHECK_EQUAL(parallelScene.getTransformHierarchy().getDepth(2), 2);
+}
@@ -0,0 +1,62 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <xe/sys/ThreadPool.hpp>
+
+using namespace xe::sys;
+
+BOOST_AUTO_TEST_CASE(ThreadPoolParallelForTest)
+{
+	ThreadPool pool(4);
+
+	BOOST_CHECK_EQUAL(pool.getThreadCount(), 4);
+
+	// every element must be visited exactly once
+	std::vector<int> values(10000, 0);
+
+	pool.parallelFor(0, static_cast<int>(values.size()), 64, [&](int begin, int end) {
+		for (int i=begin; i<end; i++) {
+			values[i]++;
+		}
+	});
+
+	for (int value : values) {
+		BOOST_CHECK_EQUAL(value, 1);
+	}
+
+	// empty and single chunk ranges
+	int calls = 0;
+	pool.parallelFor(0, 0, 16, [&](int, int) { calls++; });
+	BOOST_CHECK_EQUAL(calls, 0);
+
+	pool.parallelFor(0, 10, 16, [&](int begin, int end) { calls += end - begin; });
+	BOOST_CHECK_EQUAL(calls, 10);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPoolNestedTest)
+{
+	ThreadPool pool(2);
+
+	std::atomic<int> count(0);
+
+	pool.parallelFor(0, 16, 1, [&](int, int) {
+		pool.parallelFor(0, 100, 10, [&](int begin, int end) {
+			count += end - begin;
+		});
+	});
+
+	BOOST_CHECK_EQUAL(count, 1600);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPoolExceptionTest)
+{
+	ThreadPool pool(2);
+
+	BOOST_CHECK_THROW(pool.parallelFor(0, 100, 1, [](int begin, int) {
+		if (begin == 50) {
+			throw std::runtime_error("failed");
+		}
+	}), std::runtime_error);
+}
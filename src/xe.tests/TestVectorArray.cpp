@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include <xe/VectorArray.hpp>
+
+using namespace xe;
+
+BOOST_AUTO_TEST_CASE(VectorArrayAccessTest)
+{
+	Vector3fArray array(2, Vector3f(1.0f, 2.0f, 3.0f));
+
+	BOOST_REQUIRE_EQUAL(array.size(), 2u);
+	BOOST_CHECK_EQUAL(array.get(1), Vector3f(1.0f, 2.0f, 3.0f));
+
+	array.push_back({4.0f, 5.0f, 6.0f});
+	array[0] = Vector3f(7.0f, 8.0f, 9.0f);
+	array[1][2] = 10.0f;
+
+	BOOST_CHECK_EQUAL(array.get(0), Vector3f(7.0f, 8.0f, 9.0f));
+	BOOST_CHECK_EQUAL(array.get(1), Vector3f(1.0f, 2.0f, 10.0f));
+	BOOST_CHECK_EQUAL(array.get(2), Vector3f(4.0f, 5.0f, 6.0f));
+
+	// each coordinate has its own stream, starting at a cache line
+	for (int i=0; i<3; i++) {
+		BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(array.getStream(i)) % 64, 0u);
+	}
+
+	BOOST_CHECK_EQUAL(array.getStream(0)[2], 4.0f);
+	BOOST_CHECK_EQUAL(array.getStream(1)[2], 5.0f);
+	BOOST_CHECK_EQUAL(array.getStream(2)[2], 6.0f);
+
+	array[2] = array[0];
+	BOOST_CHECK_EQUAL(array.get(2), Vector3f(7.0f, 8.0f, 9.0f));
+}
+
+BOOST_AUTO_TEST_CASE(VectorArrayOperationsTest)
+{
+	std::mt19937 engine(3);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	// not a multiple of any SIMD width
+	std::vector<Vector3f> values1(1027), values2(1027);
+
+	for (size_t i=0; i<values1.size(); i++) {
+		values1[i] = {distribution(engine), distribution(engine), distribution(engine)};
+		values2[i] = {distribution(engine), distribution(engine), distribution(engine)};
+	}
+
+	const Vector3fArray array1(values1.begin(), values1.end());
+	const Vector3fArray array2(values2.begin(), values2.end());
+
+	const AlignedVector<float> dots = dot(array1, array2);
+	const Vector3fArray crosses = cross(array1, array2);
+	const Vector3fArray normals = normalize(array1);
+	const Vector3fArray maximums = maximize(array1, array2);
+	const Vector3fArray minimums = minimize(array1, array2);
+
+	BOOST_REQUIRE_EQUAL(dots.size(), values1.size());
+	BOOST_REQUIRE_EQUAL(crosses.size(), values1.size());
+
+	for (size_t i=0; i<values1.size(); i++) {
+		BOOST_REQUIRE_CLOSE(dots[i], dot(values1[i], values2[i]), 0.001f);
+		BOOST_REQUIRE_SMALL(abs(crosses[i] - cross(values1[i], values2[i])), 1e-6f);
+		BOOST_REQUIRE_SMALL(abs(normals[i] - normalize(values1[i])), 1e-6f);
+		BOOST_REQUIRE_EQUAL(maximums[i], maximize(values1[i], values2[i]));
+		BOOST_REQUIRE_EQUAL(minimums[i], minimize(values1[i], values2[i]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(VectorArrayFastNormalizeTest)
+{
+	Vector3fArray values;
+
+	for (int i=0; i<1027; i++) {
+		values.push_back(Vector3f(std::sin(i*0.7f), std::cos(i*1.3f), std::sin(i*2.9f + 0.5f)) * (1.0f + i));
+	}
+
+	const Vector3fArray normals = normalizeFast(values);
+
+	for (size_t i=0; i<values.size(); i++) {
+		BOOST_REQUIRE_SMALL(abs(normals[i] - normalizeFast(values.get(i))), 1e-6f);
+		BOOST_REQUIRE_SMALL(abs(normals[i] - normalize(values.get(i))), 1e-6f);
+	}
+}
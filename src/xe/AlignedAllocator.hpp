@@ -0,0 +1,88 @@
+/**
+ * @file AlignedAllocator.hpp
+ * @brief Standard allocator for over-aligned memory.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_ALIGNEDALLOCATOR_HPP__
+#define __EXENG_ALIGNEDALLOCATOR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace xe {
+
+    /**
+     * @brief Allocator whose memory blocks start at a multiple of the specified alignment.
+     *
+     * Useful for arrays processed with SIMD instructions, or to keep hot data starting at a cache line.
+     */
+    template<typename Type, std::size_t Alignment = 64>
+    class AlignedAllocator {
+    public:
+        static_assert((Alignment & (Alignment - 1)) == 0, "The alignment must be a power of two");
+        static_assert(Alignment >= sizeof(void*), "The alignment must be large enough to hold a pointer");
+
+        typedef Type value_type;
+
+        template<typename Other>
+        struct rebind {
+            typedef AlignedAllocator<Other, Alignment> other;
+        };
+
+        AlignedAllocator() {}
+
+        template<typename Other>
+        AlignedAllocator(const AlignedAllocator<Other, Alignment> &) {}
+
+        Type* allocate(std::size_t count) {
+            // the original address is stored just before the aligned block
+            void *block = std::malloc(count*sizeof(Type) + Alignment + sizeof(void*));
+
+            if (!block) {
+                throw std::bad_alloc();
+            }
+
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block) + sizeof(void*);
+            const std::uintptr_t aligned = (address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+
+            reinterpret_cast<void**>(aligned)[-1] = block;
+
+            return reinterpret_cast<Type*>(aligned);
+        }
+
+        void deallocate(Type *pointer, std::size_t) {
+            if (pointer) {
+                std::free(reinterpret_cast<void**>(pointer)[-1]);
+            }
+        }
+    };
+
+    template<typename Type1, typename Type2, std::size_t Alignment>
+    bool operator== (const AlignedAllocator<Type1, Alignment> &, const AlignedAllocator<Type2, Alignment> &) {
+        return true;
+    }
+
+    template<typename Type1, typename Type2, std::size_t Alignment>
+    bool operator!= (const AlignedAllocator<Type1, Alignment> &, const AlignedAllocator<Type2, Alignment> &) {
+        return false;
+    }
+
+    /**
+     * @brief std::vector whose elements start at a cache line boundary.
+     */
+    template<typename Type, std::size_t Alignment = 64>
+    using AlignedVector = std::vector<Type, AlignedAllocator<Type, Alignment>>;
+}
+
+#endif  //__EXENG_ALIGNEDALLOCATOR_HPP__
@@ -37,54 +37,55 @@ namespace xe {
 		enum { PointCount = Power<2, Size>::Value };
 
 	public:
-		Boundary() {
-            minEdge = Vector<Type, Size>(std::numeric_limits<Type>::max());
-            maxEdge = Vector<Type, Size>(-std::numeric_limits<Type>::max());		
-		}
+		/**
+		 * @brief Initialize the boundary as empty, so the first expand sets both edges.
+		 */
+		constexpr Boundary() : 
+			minEdge(std::numeric_limits<Type>::max()), 
+			maxEdge(-std::numeric_limits<Type>::max()) {}
 
-		Boundary(const Vector<Type, Size> &value1, const Vector<Type, Size> &value2) {
-			expand(value1);
-			expand(value2);
-		}
+		constexpr Boundary(const Vector<Type, Size> &value1, const Vector<Type, Size> &value2) : 
+			minEdge(minimize(value1, value2)), 
+			maxEdge(maximize(value1, value2)) {}
 
 		template<typename ContainerType>
-		explicit Boundary(const ContainerType& values) {
+		explicit Boundary(const ContainerType& values) : Boundary() {
 			for (const auto &value : values) {
 				expand(value);
 			}
 		}
 
-		void expand(const Vector<Type, Size> &value) {
+		constexpr void expand(const Vector<Type, Size> &value) {
 			minEdge = minimize(minEdge, value);
 			maxEdge = maximize(maxEdge, value);
 		}
 
-		void expand(const Boundary<Type, Size>& other) {
+		constexpr void expand(const Boundary<Type, Size>& other) {
 			expand(other.getMinEdge());
 			expand(other.getMaxEdge());
 		}
 
-		Vector<Type, Size> getMinEdge() const {
+		constexpr Vector<Type, Size> getMinEdge() const {
 			return minEdge;
 		}
 
-		Vector<Type, Size> getMaxEdge() const {
+		constexpr Vector<Type, Size> getMaxEdge() const {
 			return maxEdge;
 		}
 
-		Vector<Type, Size> getSize() const {
+		constexpr Vector<Type, Size> getSize() const {
 			assert(isValid());
 
 			return maxEdge - minEdge;
 		}
 
-		Vector<Type, Size> getCenter() const {
+		constexpr Vector<Type, Size> getCenter() const {
 			assert(isValid());
 
 			return minEdge + ((maxEdge - minEdge) / Type(2));
 		}
 
-		bool isValid() const {
+		constexpr bool isValid() const {
 			for (int i=0; i<Size; i++) {
 				if (minEdge[i] > maxEdge[i]) {
 					return false;
@@ -94,7 +95,7 @@ namespace xe {
 			return true;
 		}
 
-		bool isInside(const Vector<Type, Size> &point) const {
+		constexpr bool isInside(const Vector<Type, Size> &point) const {
 			assert(isValid());
 
 			for(int i=0; i<Size; ++i) { 
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <array>
+#include <atomic>
 #include <xe/Forward.hpp>
 
 namespace xe {
@@ -45,6 +46,26 @@ namespace xe {
 		 * @brief Write a user-defined memory region to the buffer
 		 */
 		virtual void write(const void *source, const int size = 0, const int offset = 0, const int source_offset = 0) = 0;
+
+		/**
+		 * @brief Get a counter that is incremented each time the contents of the buffer change.
+		 *
+		 * Lets the users of the buffer data, like acceleration structures, detect when they are out of date.
+		 */
+		std::uint32_t getVersion() const {
+			return this->version;
+		}
+
+	protected:
+		/**
+		 * @brief Must be called by the implementations after a write, or after unlocking the buffer for writing.
+		 */
+		void notifyChange() {
+			this->version++;
+		}
+
+	private:
+		std::atomic<std::uint32_t> version = {0};
 	};
 
     template<std::size_t N>
@@ -54,12 +54,12 @@ namespace xe {
         };
     };
 
-	template<typename T> struct Pi { static const T Value; };
-	template<typename T> struct PiHalf { static const T Value; };
-	template<typename T> struct PiDouble { static const T Value; };
-	template<typename T> struct Deg { static const T Value; };
-	template<typename T> struct Rad { static const T Value; };
-	template<typename T> struct Epsilon { static const T Value; };
+	template<typename T> struct Pi { static constexpr T Value = static_cast<T>(3.14159265358979); };
+	template<typename T> struct PiHalf { static constexpr T Value = static_cast<T>(Pi<T>::Value*static_cast<T>(0.5)); };
+	template<typename T> struct PiDouble { static constexpr T Value = static_cast<T>(Pi<T>::Value*static_cast<T>(2)); };
+	template<typename T> struct Deg { static constexpr T Value = static_cast<T>(180) / Pi<T>::Value; };
+	template<typename T> struct Rad { static constexpr T Value = Pi<T>::Value / static_cast<T>(180); };
+	template<typename T> struct Epsilon { static constexpr T Value = static_cast<T>(0.00001); };
 
     //http://irshu.blogspot.com/2005/08/check-if-number-is-power-of-2-easier.html
     inline bool isPowerOf2(unsigned int x) {
@@ -67,56 +67,57 @@ namespace xe {
     }
 
     template<typename T>
-    const T Pi<T>::Value = static_cast<T>(3.14159265358979);
+    constexpr T Pi<T>::Value;
 
 	template<typename T>
-    const T PiHalf<T>::Value = static_cast<T>(Pi<T>::Value*static_cast<T>(0.5));
+    constexpr T PiHalf<T>::Value;
 
 	template<typename T>
-    const T PiDouble<T>::Value = static_cast<T>(Pi<T>::Value*static_cast<T>(2));
+    constexpr T PiDouble<T>::Value;
 
     template<typename T>
-    const T Deg<T>::Value = static_cast<T>(180) / Pi<T>::Value;
+    constexpr T Deg<T>::Value;
 
     template<typename T>
-    const T Rad<T>::Value = Pi<T>::Value / static_cast<T>(180);
+    constexpr T Rad<T>::Value;
 
     template<typename T>
-    const T Epsilon<T>::Value = static_cast<T>(0.00001);
+    constexpr T Epsilon<T>::Value;
 
     template<typename T>
-    inline T deg(T Rads) {
+    constexpr T deg(T Rads) {
         return Rads * Deg<T>::Value;
     }
 
     template<typename T>
-    inline T rad(T Degs) {
+    constexpr T rad(T Degs) {
         return Degs * Rad<T>::Value;
     }
 
     //Implementacion funcion Equals
     template<typename T>
-    inline bool equals(T Val1, T Val2) {
+    constexpr bool equals(T Val1, T Val2) {
         return Val1 == Val2;
     }
 
     template<typename Type>
-    inline bool EqualsFloating(Type In1, Type In2) {
-        return ::fabs(In1 - In2) < Epsilon<Type>::Value;
+    constexpr bool EqualsFloating(Type In1, Type In2) {
+        // |In1 - In2| < Epsilon, written without fabs to be usable in constant expressions
+        return (In1 - In2) < Epsilon<Type>::Value && (In2 - In1) < Epsilon<Type>::Value;
     }
 
     template<>
-    inline bool equals<float>(float Val1, float Val2) {
+    constexpr bool equals<float>(float Val1, float Val2) {
         return EqualsFloating<float>(Val1, Val2);
     }
 
     template<>
-    inline bool equals<double>(double Val1, double Val2) {
+    constexpr bool equals<double>(double Val1, double Val2) {
         return EqualsFloating<double>(Val1, Val2);
     }
 
     template<typename T, int Size>
-    bool arrayCompare(const T* Arr1, const T* Arr2) {
+    constexpr bool arrayCompare(const T* Arr1, const T* Arr2) {
         for(int i=0; i<Size; ++i)  {
             if (equals<T>(Arr1[i], Arr2[i]) == false) {
                 return false;
@@ -36,6 +36,13 @@
 #  define EXENG_IMPORT
 #endif
 
+// tells the compiler that a pointer doesn't alias any other one in the same scope
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#  define EXENG_RESTRICT __restrict
+#else
+#  define EXENG_RESTRICT
+#endif
+
 // define EXENGAPI
 #ifdef EXENG_BUILD
 #  ifdef EXENG_WINDOWS
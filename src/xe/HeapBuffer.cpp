@@ -34,6 +34,8 @@ namespace xe {
 		if (data) {
 			this->data = data;
 			this->size = size;
+
+			this->notifyChange();
 		}
 	}
 
@@ -66,5 +68,7 @@ namespace xe {
 		const std::uint8_t* srcData = static_cast<const std::uint8_t*>(data) + dataOffset;
 		std::uint8_t* dstData = static_cast<std::uint8_t*>(this->data) + bufferOffset;
 		std::memcpy(dstData, srcData, size);
+
+		this->notifyChange();
 	}
 }
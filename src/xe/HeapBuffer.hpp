@@ -54,7 +54,9 @@ namespace xe {
 		}
 
 		virtual void unlock() const override {}
-		virtual void unlock() override {}
+		virtual void unlock() override {
+			this->notifyChange();
+		}
 
 		/* Buffer class overrided methods*/
 		virtual int getSize() const override {
@@ -10,7 +10,80 @@
 #include <xe/Vector.hpp>
 #include <xe/Boundary.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EXENG_MATRIX_SSE
+#  include <emmintrin.h>
+#endif
+
 namespace xe {
+	template<typename Type, int RowCount, int ColumnCount>
+	class Matrix;
+
+	/**
+	 * @brief Matrix operations that have faster implementations for some element types and sizes.
+	 *
+	 * These are the generic implementations, used by any matrix without a specialization.
+	 */
+	template<typename Type, int RowCount, int ColumnCount>
+	struct MatrixOps {
+		typedef Matrix<Type, RowCount, ColumnCount> MatrixType;
+
+		static MatrixType multiply(const MatrixType &a, const MatrixType &b) {
+			MatrixType result;
+
+			for (int i=0; i<RowCount; i++) {
+				for (int j=0; j<ColumnCount; j++) {
+					result(i, j) = dot(a.getRow(i), b.getColumn(j));
+				}
+			}
+
+			return result;
+		}
+
+		static MatrixType transpose(const MatrixType &m) {
+			auto result = m;
+			int baseColumn = 1;
+
+			for(int i=0; i<RowCount-1; ++i) {
+				for(int j=baseColumn; j<ColumnCount; ++j) {
+					std::swap( result(i, j), result(j, i) );
+				}
+
+				++baseColumn;
+			}
+        
+			return result;
+		}
+
+		static MatrixType inverse(const MatrixType &m, Type det) {
+			return transpose(adjoint(m)) / det;
+		}
+
+		static MatrixType inverse(const MatrixType &m) {
+			return inverse(m, abs(m));
+		}
+
+		static Vector<Type, RowCount> transform(const MatrixType &m, const Vector<Type, ColumnCount> &v) {
+			Vector<Type, RowCount> result;
+
+			for (int i=0; i<RowCount; i++) {
+				result[i] = dot(m.getRow(i), v);
+			}
+
+			return result;
+		}
+
+		static Vector<Type, RowCount - 1> transformPoint(const MatrixType &m, const Vector<Type, ColumnCount - 1> &v) {
+			Vector<Type, RowCount - 1> result;
+
+			for (int i=0; i<RowCount - 1; i++) {
+				result[i] = dot(m.getRow(i), Vector<Type, ColumnCount>(v, Type(1)));
+			}
+
+			return result;
+		}
+	};
+
 	template<typename Type, int RowCount, int ColumnCount>
 	class Matrix {
 	public:
@@ -20,30 +93,39 @@ namespace xe {
 	public:
 		Matrix() {}
 
+		/**
+		 * @brief Initialize all the values of the matrix with the same value.
+		 */
+		constexpr explicit Matrix(Type value) : values{} {
+			for (int i=0; i<ValueCount; i++) {
+				values[i] = value;
+			}
+		}
+
 		// accessors
-		const Type& get(const int i, const int j) const {
+		constexpr const Type& get(const int i, const int j) const {
 			return values[offset(i, j)];
 		}
 
-		Type& get(const int i, const int j) {
+		constexpr Type& get(const int i, const int j) {
 			return values[offset(i, j)];
 		}
 		
 		template<int i, int j>
-		const Type& get() const {
+		constexpr const Type& get() const {
 			return values[offset(i, j)];
 		}
 
 		template<int i, int j>
-		Type& get() {
+		constexpr Type& get() {
 			return values[offset(i, j)];
 		}
 
-		Vector<Type, RowCount> getColumn(const int j) const {
+		constexpr Vector<Type, RowCount> getColumn(const int j) const {
 			assert(j >= 0);
 			assert(j < RowCount);
 
-			Vector<Type, RowCount> result;
+			Vector<Type, RowCount> result(Type(0));
 
 			for (int i=0; i<RowCount; i++) {
 				result[i] = this->get(i, j);
@@ -52,11 +134,11 @@ namespace xe {
 			return result;
 		}
 
-		Vector<Type, ColumnCount> getRow(const int i) const {
+		constexpr Vector<Type, ColumnCount> getRow(const int i) const {
 			assert(i >= 0);
 			assert(i < RowCount);
 
-			Vector<Type, ColumnCount> result;
+			Vector<Type, ColumnCount> result(Type(0));
 
 			for (int j=0; j<ColumnCount; j++) {
 				result[j] = this->get(i, j);
@@ -65,7 +147,7 @@ namespace xe {
 			return result;
 		}
 
-		void setColumn(const int j, const Vector<Type, RowCount> &v) {
+		constexpr void setColumn(const int j, const Vector<Type, RowCount> &v) {
 			assert(j >= 0);
 			assert(j < RowCount);
 
@@ -74,7 +156,7 @@ namespace xe {
 			}
 		}
 
-		void setRow(const int i, const Vector<Type, ColumnCount> &v) {
+		constexpr void setRow(const int i, const Vector<Type, ColumnCount> &v) {
 			assert(i >= 0);
 			assert(i < RowCount);
 
@@ -83,14 +165,14 @@ namespace xe {
 			}
 		}
 
-		Matrix2<Type, RowCount - 1, ColumnCount - 1> getSubMatrix(const int row, const int column) const {
+		Matrix<Type, RowCount - 1, ColumnCount - 1> getSubMatrix(const int row, const int column) const {
 			assert(row >= 0);
 			assert(row < RowCount);
 
 			assert(column >= 0);
 			assert(column < ColumnCount);
 
-			Matrix2<Type, RowCount-1, ColumnCount-1> result;
+			Matrix<Type, RowCount-1, ColumnCount-1> result;
 
 			int ii = 0, jj = 0;
 
@@ -125,7 +207,7 @@ namespace xe {
 		}
 
 		// operators
-		friend std::ostream& operator<< (std::ostream &os, const Matrix2<Type, RowCount, ColumnCount>& Other) {
+		friend std::ostream& operator<< (std::ostream &os, const Matrix<Type, RowCount, ColumnCount>& Other) {
 			os << std::endl;
 
 			for (int i=0; i<RowCount; ++i) {
@@ -146,73 +228,65 @@ namespace xe {
 			return os;
 		}
 
-		const Type& operator() (const int i, const int j) const {
+		constexpr const Type& operator() (const int i, const int j) const {
 			return this->get(i, j);
 		}
 
-		Type& operator() (const int i, const int j) {
+		constexpr Type& operator() (const int i, const int j) {
 			return this->get(i, j);
 		}
 
-		MatrixType operator*(const Type factor) const {
-			MatrixType result;
+		constexpr MatrixType operator*(const Type factor) const {
+			MatrixType result = *this;
 
 			for (int i=0; i<ValueCount; i++) {
-				result.values[i] = factor * values[i];
+				result.values[i] *= factor;
 			}
 			
 			return result;
 		}
 
-		friend MatrixType operator*(const Type factor, const MatrixType &m) {
+		friend constexpr MatrixType operator*(const Type factor, const MatrixType &m) {
 			return m * factor;
 		}
 
-		MatrixType operator/(const Type factor) const {
+		constexpr MatrixType operator/(const Type factor) const {
 			return (*this) * (Type(1)/factor);
 		}
 
-		MatrixType operator+() const {
+		constexpr MatrixType operator+() const {
 			return *this;
 		}
 
-		MatrixType operator-() const {
+		constexpr MatrixType operator-() const {
 			return (*this) * Type(-1);
 		}
 
-		MatrixType operator+(const MatrixType &other) const {
-			MatrixType result;
+		constexpr MatrixType operator+(const MatrixType &other) const {
+			MatrixType result = *this;
 
 			for (int i=0; i<ValueCount; i++) {
-				result.values[i] = values[i] + other.values[i];
+				result.values[i] += other.values[i];
 			}
 			
 			return result;
 		}
 
-		MatrixType operator-(const MatrixType &other) const {
+		constexpr MatrixType operator-(const MatrixType &other) const {
 			return *this + (-other);
 		}
 
 		MatrixType operator*(const MatrixType &other) const {
-			MatrixType result;
-
-			for (int i=0; i<RowCount; i++) {
-				for (int j=0; j<ColumnCount; j++) {
-					result(i, j) = dot(this->getRow(i), other.getColumn(j));
-				}
-			}
-
-			return result;
+			return MatrixOps<Type, RowCount, ColumnCount>::multiply(*this, other);
 		}
 
-		MatrixType& operator+= (const MatrixType &other) {
+		constexpr MatrixType& operator+= (const MatrixType &other) {
 			*this = *this + other;
 
 			return *this;
 		}
 
-		MatrixType& operator-= (const MatrixType &other) {
+		constexpr MatrixType& operator-= (const MatrixType &other) {
 			*this = *this - other;
 
 			return *this;
@@ -230,13 +304,13 @@ namespace xe {
 			return *this;
 		}
 
-		MatrixType& operator*= (Type factor) {
+		constexpr MatrixType& operator*= (Type factor) {
 			*this = *this * factor;
 
 			return *this;
 		}
 
-		MatrixType& operator/= (Type factor) {
+		constexpr MatrixType& operator/= (Type factor) {
 			*this = *this / factor;
 
 			return *this;
@@ -246,7 +320,7 @@ namespace xe {
 			return (*this) * inverse(other);
 		}
 
-		bool operator== (const MatrixType &other) const {
+		constexpr bool operator== (const MatrixType &other) const {
 			for (int i=0; i<ValueCount; i++) {
 				if (values[i] != other.values[i]) {
 					return false;
@@ -256,14 +330,14 @@ namespace xe {
 			return true;
 		}
 
-		bool operator!= (const MatrixType &other) const {
+		constexpr bool operator!= (const MatrixType &other) const {
 			return ! (*this == other);
 		}
 
 	private:
 		template<typename Type_, int Count>
 		struct Determinant {
-			static Type_ compute(const Matrix2<Type_, Count, Count> &m) {
+			static Type_ compute(const Matrix<Type_, Count, Count> &m) {
 				Type_ factor = Type_(1);
 				Type_ result = Type_(0);
                 
@@ -283,20 +357,20 @@ namespace xe {
 
 		template<typename Type_>
 		struct Determinant<Type_, 2> {
-			static Type_ compute(const Matrix2<Type_, 2, 2> &m) {
+			static Type_ compute(const Matrix<Type_, 2, 2> &m) {
 				return m(0, 0)*m(1, 1) - m(1, 0)*m(0, 1);
 			}
 		};
 
 	public:
-		friend Type abs(const Matrix2<Type, RowCount, ColumnCount> &m) {
+		friend Type abs(const Matrix<Type, RowCount, ColumnCount> &m) {
 			static_assert(RowCount == ColumnCount, "");
 
 			return Determinant<Type, RowCount>::compute(m);
 		}
 
 		friend MatrixType adjoint(const MatrixType &matrix) {
-			Matrix2<Type, RowCount, ColumnCount> result;
+			Matrix<Type, RowCount, ColumnCount> result;
         
 			for(int i=0; i<RowCount; ++i) {
 				for(int j=0; j<ColumnCount; ++j) {
@@ -309,30 +383,19 @@ namespace xe {
 		}
 
 		friend MatrixType transpose(const MatrixType &other) {
-			auto result = other;
-			int baseColumn = 1;
-
-			for(int i=0; i<RowCount-1; ++i) {
-				for(int j=baseColumn; j<ColumnCount; ++j) {
-					std::swap( result(i, j), result(j, i) );
-				}
-
-				++baseColumn;
-			}
-        
-			return result;
+			return MatrixOps<Type, RowCount, ColumnCount>::transpose(other);
 		}
 
 		friend MatrixType inverse(const MatrixType &m, Type det) {
-			return transpose(adjoint(m)) / det;
+			return MatrixOps<Type, RowCount, ColumnCount>::inverse(m, det);
 		}
 		
 		friend MatrixType inverse(const MatrixType &m) {
-			return inverse(m, abs(m));
+			return MatrixOps<Type, RowCount, ColumnCount>::inverse(m);
 		}
 
 	private:
-		int offset(const int i, const int j) const {
+		constexpr int offset(const int i, const int j) const {
 			assert(i >= 0);
 			assert(i < RowCount);
 
@@ -343,7 +406,7 @@ namespace xe {
 		}
 		
 		template<int i, int j>
-		int offset() const {
+		constexpr int offset() const {
 			static_assert(i >= 0, "");
 			static_assert(i < RowCount, "");
 
@@ -356,24 +419,221 @@ namespace xe {
 	private:
 		Type values[ValueCount];
 	};
+
+#if defined(EXENG_MATRIX_SSE)
+	/**
+	 * @brief SSE implementation of the operations for 4x4 float matrices. 
+	 *
+	 * The values are stored by columns, so each column is loaded directly into a register.
+	 */
+	template<>
+	struct MatrixOps<float, 4, 4> {
+		typedef Matrix<float, 4, 4> MatrixType;
+
+		static MatrixType multiply(const MatrixType &a, const MatrixType &b) {
+			const float *values = a.getPtr();
+			const float *otherValues = b.getPtr();
+
+			const __m128 c0 = _mm_loadu_ps(values + 0);
+			const __m128 c1 = _mm_loadu_ps(values + 4);
+			const __m128 c2 = _mm_loadu_ps(values + 8);
+			const __m128 c3 = _mm_loadu_ps(values + 12);
+
+			MatrixType result;
+
+			// each column of the result is a combination of the columns of a, weighted by a column of b
+			for (int j=0; j<4; j++) {
+				const float *weights = otherValues + 4*j;
+
+				_mm_storeu_ps(result.getPtr() + 4*j, combine(c0, c1, c2, c3, weights[0], weights[1], weights[2], weights[3]));
+			}
+
+			return result;
+		}
+
+		static MatrixType transpose(const MatrixType &m) {
+			const float *values = m.getPtr();
+
+			__m128 c0 = _mm_loadu_ps(values + 0);
+			__m128 c1 = _mm_loadu_ps(values + 4);
+			__m128 c2 = _mm_loadu_ps(values + 8);
+			__m128 c3 = _mm_loadu_ps(values + 12);
+
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+			return store(c0, c1, c2, c3);
+		}
+
+		/**
+		 * @brief Closed form inverse, from the cross products of the columns (Lengyel, "Foundations of Game Engine 
+		 * Development", 2016). The affine transformations, the most common ones, take a shorter path.
+		 */
+		static MatrixType inverse(const MatrixType &m) {
+			const float *values = m.getPtr();
+
+			if (values[3] == 0.0f && values[7] == 0.0f && values[11] == 0.0f && values[15] == 1.0f) {
+				return inverseAffine(m);
+			}
+
+			const Cofactors cofactors = computeCofactors(m);
+
+			return inverse(m, cofactors, dot(cofactors.s, cofactors.v) + dot(cofactors.t, cofactors.u));
+		}
+
+		static MatrixType inverse(const MatrixType &m, float det) {
+			return inverse(m, computeCofactors(m), det);
+		}
+
+		static Vector<float, 4> transform(const MatrixType &m, const Vector<float, 4> &v) {
+			const float *values = m.getPtr();
+
+			Vector<float, 4> result;
+
+			_mm_storeu_ps(result.getPtr(), combine (
+				_mm_loadu_ps(values + 0), _mm_loadu_ps(values + 4), _mm_loadu_ps(values + 8), _mm_loadu_ps(values + 12), 
+				v.x, v.y, v.z, v.w
+			));
+
+			return result;
+		}
+
+		static Vector<float, 3> transformPoint(const MatrixType &m, const Vector<float, 3> &v) {
+			const Vector<float, 4> result = transform(m, Vector<float, 4>(v, 1.0f));
+
+			return Vector<float, 3>(result.x, result.y, result.z);
+		}
+
+	private:
+		/**
+		 * @brief Cross products of the first three rows of the columns, and the combinations of the columns 
+		 * weighted by the last row. Their fourth components are always zero.
+		 */
+		struct Cofactors {
+			__m128 c0, c1, c2, c3;
+			__m128 s, t, u, v;
+		};
+
+		static __m128 combine(__m128 c0, __m128 c1, __m128 c2, __m128 c3, float w0, float w1, float w2, float w3) {
+			return _mm_add_ps (
+				_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(w0)), _mm_mul_ps(c1, _mm_set1_ps(w1))),
+				_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(w2)), _mm_mul_ps(c3, _mm_set1_ps(w3)))
+			);
+		}
+
+		static MatrixType store(__m128 c0, __m128 c1, __m128 c2, __m128 c3) {
+			MatrixType result;
+
+			_mm_storeu_ps(result.getPtr() + 0, c0);
+			_mm_storeu_ps(result.getPtr() + 4, c1);
+			_mm_storeu_ps(result.getPtr() + 8, c2);
+			_mm_storeu_ps(result.getPtr() + 12, c3);
+
+			return result;
+		}
+
+		static __m128 cross(__m128 a, __m128 b) {
+			const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+
+			return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+
+		static float dot(__m128 a, __m128 b) {
+			const __m128 product = _mm_mul_ps(a, b);
+			const __m128 shuffled = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+			const __m128 sums = _mm_add_ps(product, shuffled);
+
+			return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(shuffled, sums)));
+		}
+
+		static __m128 clearW(__m128 v) {
+			return _mm_and_ps(v, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+		}
+
+		static Cofactors computeCofactors(const MatrixType &m) {
+			const float *values = m.getPtr();
+
+			Cofactors cofactors;
+
+			cofactors.c0 = _mm_loadu_ps(values + 0);
+			cofactors.c1 = _mm_loadu_ps(values + 4);
+			cofactors.c2 = _mm_loadu_ps(values + 8);
+			cofactors.c3 = _mm_loadu_ps(values + 12);
+
+			cofactors.s = cross(cofactors.c0, cofactors.c1);
+			cofactors.t = cross(cofactors.c2, cofactors.c3);
+			cofactors.u = clearW(_mm_sub_ps(_mm_mul_ps(cofactors.c0, _mm_set1_ps(values[7])), _mm_mul_ps(cofactors.c1, _mm_set1_ps(values[3]))));
+			cofactors.v = clearW(_mm_sub_ps(_mm_mul_ps(cofactors.c2, _mm_set1_ps(values[15])), _mm_mul_ps(cofactors.c3, _mm_set1_ps(values[11]))));
+
+			return cofactors;
+		}
+
+		static MatrixType inverse(const MatrixType &m, const Cofactors &cofactors, float det) {
+			const float *values = m.getPtr();
+
+			const __m128 c0 = clearW(cofactors.c0);
+			const __m128 c1 = clearW(cofactors.c1);
+			const __m128 c2 = clearW(cofactors.c2);
+			const __m128 c3 = clearW(cofactors.c3);
+
+			const __m128 &s = cofactors.s;
+			const __m128 &t = cofactors.t;
+			const __m128 &u = cofactors.u;
+			const __m128 &v = cofactors.v;
+
+			// rows of the inverse, without the last column
+			__m128 r0 = _mm_add_ps(cross(c1, v), _mm_mul_ps(t, _mm_set1_ps(values[7])));
+			__m128 r1 = _mm_sub_ps(cross(v, c0), _mm_mul_ps(t, _mm_set1_ps(values[3])));
+			__m128 r2 = _mm_add_ps(cross(c3, u), _mm_mul_ps(s, _mm_set1_ps(values[15])));
+			__m128 r3 = _mm_sub_ps(cross(u, c2), _mm_mul_ps(s, _mm_set1_ps(values[11])));
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			const __m128 lastColumn = _mm_setr_ps(-dot(c1, t), dot(c0, t), -dot(c3, s), dot(c2, s));
+			const __m128 invDet = _mm_set1_ps(1.0f / det);
+
+			return store(_mm_mul_ps(r0, invDet), _mm_mul_ps(r1, invDet), _mm_mul_ps(r2, invDet), _mm_mul_ps(lastColumn, invDet));
+		}
+
+		static MatrixType inverseAffine(const MatrixType &m) {
+			const float *values = m.getPtr();
+
+			const __m128 c0 = clearW(_mm_loadu_ps(values + 0));
+			const __m128 c1 = clearW(_mm_loadu_ps(values + 4));
+			const __m128 c2 = clearW(_mm_loadu_ps(values + 8));
+
+			// the rows of the inverse of the linear part are the cross products of its columns
+			__m128 r0 = cross(c1, c2);
+			__m128 r1 = cross(c2, c0);
+			__m128 r2 = cross(c0, c1);
+			__m128 r3 = _mm_setzero_ps();
+
+			const float invDet = 1.0f / dot(r2, c2);
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			r0 = _mm_mul_ps(r0, _mm_set1_ps(invDet));
+			r1 = _mm_mul_ps(r1, _mm_set1_ps(invDet));
+			r2 = _mm_mul_ps(r2, _mm_set1_ps(invDet));
+
+			// the translation is moved back by the inverse of the linear part
+			const __m128 translation = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), combine(r0, r1, r2, _mm_setzero_ps(), values[12], values[13], values[14], 0.0f));
+
+			return store(r0, r1, r2, translation);
+		}
+	};
+#endif
 	
 	// matrix factory functions
 
 	template<typename Type, int RowCount, int ColumnCount>
-    Matrix2<Type, RowCount, ColumnCount> zero() {
-        Matrix2<Type, RowCount, ColumnCount> result;
-        
-        for(int i=0; i<RowCount; ++i) {
-			for(int j=0; j<ColumnCount; ++j) {
-				result(i, j) = Type(0);
-			}
-        }
-        
-        return result;
+    constexpr Matrix<Type, RowCount, ColumnCount> zero() {
+        return Matrix<Type, RowCount, ColumnCount>(Type(0));
     }
 
     template<typename Type, int Size>
-    Matrix2<Type, Size, Size> identity() {
+    constexpr Matrix<Type, Size, Size> identity() {
         auto result = zero<Type, Size, Size>();
         
         for(int i=0; i<Size; ++i) {
@@ -384,7 +644,7 @@ namespace xe {
     }
     
     template<typename Type, int Size>
-    Matrix2<Type, Size, Size> scale(const Vector<Type, 3> &scale) {
+    constexpr Matrix<Type, Size, Size> scale(const Vector<Type, 3> &scale) {
         auto result = identity<Type, Size>();
         
         for(int i=0; i<3; ++i) {
@@ -395,18 +655,18 @@ namespace xe {
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> translate(const Vector<Type, 3> &RelPos) {
+    constexpr Matrix<Type, 4, 4> translate(const Vector<Type, 3> &RelPos) {
         auto result = identity<Type, 4>();
         
-        result.get(0, 3) = RelPos.x;
-        result.get(1, 3) = RelPos.y;
-        result.get(2, 3) = RelPos.z;
+        result.get(0, 3) = RelPos[0];
+        result.get(1, 3) = RelPos[1];
+        result.get(2, 3) = RelPos[2];
         
         return result;
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> rotatex(const Type radians) {
+    Matrix<Type, 4, 4> rotatex(const Type radians) {
         auto result = identity<Type, 4>();
         
         Type Cos = std::cos(radians);
@@ -421,7 +681,7 @@ namespace xe {
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> rotatey(const Type radians) {
+    Matrix<Type, 4, 4> rotatey(const Type radians) {
         auto result = identity<Type, 4>();
         
         Type Cos = std::cos(radians);
@@ -436,7 +696,7 @@ namespace xe {
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> rotatez(const Type radians) {
+    Matrix<Type, 4, 4> rotatez(const Type radians) {
         auto result = identity<Type, 4>();
         
         Type Cos = std::cos(radians);
@@ -451,7 +711,7 @@ namespace xe {
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> rotate(Type radians, const Vector<Type, 3> &Axis) {
+    Matrix<Type, 4, 4> rotate(Type radians, const Vector<Type, 3> &Axis) {
         Type Cos = std::cos(radians);
         Type Sin = std::sin(radians);
         
@@ -498,7 +758,7 @@ namespace xe {
     }
 
     template<typename Type>
-    Matrix2<Type, 4, 4> lookat(const Vector<Type, 3> &Eye, const Vector<Type, 3> &At, const Vector<Type, 3> &Up) {
+    Matrix<Type, 4, 4> lookat(const Vector<Type, 3> &Eye, const Vector<Type, 3> &At, const Vector<Type, 3> &Up) {
         auto forward = normalize(At - Eye);
         auto side = normalize(cross(forward, Up));
         auto up = cross(side, forward);
@@ -523,7 +783,7 @@ namespace xe {
     }
     
     template<typename Type>
-    Matrix2<Type, 4, 4> perspective(Type fov_radians, Type aspect, Type znear, Type zfar) {
+    Matrix<Type, 4, 4> perspective(Type fov_radians, Type aspect, Type znear, Type zfar) {
         Type f = Type(1) / std::tan(fov_radians / Type(2));
         // Type zdiff = zfar - znear;	// Reverse the projection (far objects appear in front of those near)
 		Type zdiff = znear - zfar;
@@ -541,7 +801,7 @@ namespace xe {
     
     //!Orthographic projection
     template<typename Type>
-    Matrix2<Type, 4, 4> ortho(const Boundary<Type, 3>& Volume) {
+    Matrix<Type, 4, 4> ortho(const Boundary<Type, 3>& Volume) {
         Type left = Volume.GetSide(Side3::Left);
         Type right = Volume.GetSide(Side3::Right);
         
@@ -566,25 +826,16 @@ namespace xe {
     }
 
 	template<typename Type, int Size>
-	Vector<Type, Size> transform(const Matrix2<Type, Size, Size> &m, Vector<Type, Size> &v) {
-		Vector<Type, Size> result;
-
-		for (int i=0; i<Size; i++) {
-			result[i] = dot(m.getRow(i), v);
-		}
-
-		return result;
+	Vector<Type, Size> transform(const Matrix<Type, Size, Size> &m, const Vector<Type, Size> &v) {
+		return MatrixOps<Type, Size, Size>::transform(m, v);
 	}
 
+	/**
+	 * @brief Transform a point, extended with an unit homogeneous coordinate.
+	 */
 	template<typename Type, int Size>
-	Vector<Type, Size - 1> transform(const Matrix2<Type, Size, Size> &m, Vector<Type, Size - 1> &v) {
-		Vector<Type, Size - 1> result;
-
-		for (int i=0; i<Size - 1; i++) {
-			result[i] = dot(m.getRow(i), Vector<Type, Size>(v, Type(1)));
-		}
-
-		return result;
+	Vector<Type, Size - 1> transform(const Matrix<Type, Size, Size> &m, const Vector<Type, Size - 1> &v) {
+		return MatrixOps<Type, Size, Size>::transformPoint(m, v);
 	}
 
 	typedef Matrix<float, 2, 2> Matrix2f;
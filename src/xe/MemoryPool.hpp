@@ -0,0 +1,126 @@
+/**
+ * @file MemoryPool.hpp
+ * @brief Fixed size block allocator.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_MEMORYPOOL_HPP__
+#define __EXENG_MEMORYPOOL_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+
+namespace xe {
+
+    /**
+     * @brief Allocates blocks of a fixed size from slabs of contiguous memory.
+     *
+     * The freed blocks are kept in a list, to be reused by the following allocations, and the slabs are
+     * released all at once along with the pool. Consecutive allocations from a new slab are adjacent in
+     * memory, so the objects created together are traversed together without cache misses.
+     * The allocation and deallocation are thread safe.
+     */
+    template<std::size_t BlockSize, std::size_t Alignment = alignof(std::max_align_t), std::size_t SlabBlockCount = 1024>
+    class MemoryPool {
+    public:
+        static_assert(SlabBlockCount > 0, "The slabs must hold at least one block");
+        static_assert(Alignment <= alignof(std::max_align_t), "The slabs are allocated with the default alignment");
+
+        MemoryPool() {}
+
+        MemoryPool(const MemoryPool &) = delete;
+        MemoryPool& operator= (const MemoryPool &) = delete;
+
+        /**
+         * @brief Get a block of BlockSize bytes, aligned to Alignment.
+         */
+        void* allocate() {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            if (!this->freeList) {
+                this->grow();
+            }
+
+            Block *block = this->freeList;
+
+            this->freeList = block->next;
+            this->blockCount++;
+
+            return block;
+        }
+
+        /**
+         * @brief Give back a block to the pool. The null pointer is ignored.
+         */
+        void deallocate(void *pointer) {
+            if (!pointer) {
+                return;
+            }
+
+            Block *block = static_cast<Block*>(pointer);
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            assert(this->blockCount > 0);
+
+            block->next = this->freeList;
+
+            this->freeList = block;
+            this->blockCount--;
+        }
+
+        /**
+         * @brief Get the number of blocks currently allocated.
+         */
+        std::size_t getBlockCount() const {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            return this->blockCount;
+        }
+
+        std::size_t getSlabCount() const {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            return this->slabs.size();
+        }
+
+    private:
+        union Block {
+            Block *next;
+            typename std::aligned_storage<BlockSize, Alignment>::type storage;
+        };
+
+        void grow() {
+            std::unique_ptr<Block[]> slab(new Block[SlabBlockCount]);
+
+            // linked in address order, so the next allocations are contiguous
+            for (std::size_t i=0; i<SlabBlockCount - 1; i++) {
+                slab[i].next = &slab[i + 1];
+            }
+
+            slab[SlabBlockCount - 1].next = this->freeList;
+
+            this->freeList = slab.get();
+            this->slabs.push_back(std::move(slab));
+        }
+
+    private:
+        std::vector<std::unique_ptr<Block[]>> slabs;
+        Block *freeList = nullptr;
+        std::size_t blockCount = 0;
+        mutable std::mutex mutex;
+    };
+}
+
+#endif  //__EXENG_MEMORYPOOL_HPP__
@@ -1,74 +1,143 @@
+/**
+ * @file Quaternion.hpp
+ * @brief Quaternion class and companion functions, used to represent rotations.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
 
 #pragma once
 
 #ifndef __xe_quaternion_hpp__
 #define __xe_quaternion_hpp__
 
+#include <cmath>
 #include <xe/Vector.hpp>
+#include <xe/Matrix.hpp>
 
 namespace xe {
 
+    /**
+     * @brief Rotation of some angle (in radians) around an axis.
+     */
     template<typename Type>
     struct Rotation {
         Type angle;
         Vector<Type, 3> axis;
     };
 
+    /**
+     * @brief Quaternion, with a vector and a scalar part.
+     *
+     * The unit quaternions represent rotations in four values, compose with fewer operations than the matrices,
+     * and can be interpolated without trigonometric functions (see nlerp).
+     */
     template<typename Type>
     struct Quaternion {
-        
-        union {
-            struct {
-                xe::Vector<Type, 3> v;
-                Type w;
-            };
+        Vector<Type, 3> v;
+        Type w;
 
-            xe::Vector<Type, 4> q;
-        };
+        Quaternion() : v(Type(0)), w(Type(1)) {}
 
-        Quaternion(const xe::Vector<Type, 3> &v_={0, 0, 0}, Type w_=Type(0)) {
-            v = v_;
-            w = w_;
-        }
+        Quaternion(const Vector<Type, 3> &v_, Type w_) : v(v_), w(w_) {}
 
-        explicit Quaternion(const xe::Vector<Type, 4> &q) {
-            q = q_;
-        }
+        explicit Quaternion(const Vector<Type, 4> &q) : v(q[0], q[1], q[2]), w(q[3]) {}
 
         explicit Quaternion(const Rotation<Type> &r) {
-            v = r.axis;
-            w = std::cos(r.angle * Type(0.5);
+            const Type halfAngle = r.angle * Type(0.5);
+
+            v = normalize(r.axis) * std::sin(halfAngle);
+            w = std::cos(halfAngle);
+        }
+
+        /**
+         * @brief Build the quaternion from the rotation part of a matrix, assumed to be orthonormal.
+         */
+        explicit Quaternion(const Matrix<Type, 4, 4> &m) {
+            const Type trace = m(0, 0) + m(1, 1) + m(2, 2);
+
+            // take the square root of the largest of the four candidates, to avoid the cancellation
+            if (trace > Type(0)) {
+                const Type s = Type(0.5) / std::sqrt(trace + Type(1));
 
-            *this = normalize(*this);
+                v = Vector<Type, 3>(m(2, 1) - m(1, 2), m(0, 2) - m(2, 0), m(1, 0) - m(0, 1)) * s;
+                w = Type(0.25) / s;
+
+            } else if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2)) {
+                const Type s = Type(2) * std::sqrt(Type(1) + m(0, 0) - m(1, 1) - m(2, 2));
+
+                v = Vector<Type, 3>(Type(0.25) * s, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s);
+                w = (m(2, 1) - m(1, 2)) / s;
+
+            } else if (m(1, 1) > m(2, 2)) {
+                const Type s = Type(2) * std::sqrt(Type(1) + m(1, 1) - m(0, 0) - m(2, 2));
+
+                v = Vector<Type, 3>((m(0, 1) + m(1, 0)) / s, Type(0.25) * s, (m(1, 2) + m(2, 1)) / s);
+                w = (m(0, 2) - m(2, 0)) / s;
+
+            } else {
+                const Type s = Type(2) * std::sqrt(Type(1) + m(2, 2) - m(0, 0) - m(1, 1));
+
+                v = Vector<Type, 3>((m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, Type(0.25) * s);
+                w = (m(1, 0) - m(0, 1)) / s;
+            }
         }
 
         operator Rotation<Type>() const {
-            Type angle = Type(2) * std::acos(w);
+            const Type angle = Type(2) * std::acos(std::max(Type(-1), std::min(w, Type(1))));
 
-            if (angle == Type(0)) {
-                return {angle, {Type(1), Type(0), Type(0)}};
-            } else {    
+            if (abs2(v) == Type(0)) {
+                return {Type(0), {Type(1), Type(0), Type(0)}};
+            } else {
                 return {angle, normalize(v)};
             }
         }
 
+        operator Vector<Type, 4>() const {
+            return Vector<Type, 4>(v, w);
+        }
+
+        Quaternion<Type> operator+ (const Quaternion<Type> &other) const {
+            return Quaternion<Type>(v + other.v, w + other.w);
+        }
+
+        Quaternion<Type> operator- (const Quaternion<Type> &other) const {
+            return Quaternion<Type>(v - other.v, w - other.w);
+        }
+
+        Quaternion<Type> operator- () const {
+            return Quaternion<Type>(-v, -w);
+        }
+
+        /**
+         * @brief Compose two rotations. The right hand one is applied first.
+         */
         Quaternion<Type> operator* (const Quaternion<Type> &other) const {
-            return Quaternion (
+            return Quaternion<Type> (
                 cross(v, other.v) + other.v*w + v*other.w,
                 w*other.w - dot(v, other.v)
             );
         }
 
-        Quaternion<Type> operator* (const Quaternion<Type> &other) const {
+        Quaternion<Type> operator/ (const Quaternion<Type> &other) const {
             return *this * inverse(other);
         }
 
         Quaternion<Type> operator* (Type s) const {
-            return Quaternion(v * s);
+            return Quaternion<Type>(v * s, w * s);
+        }
+
+        friend Quaternion<Type> operator* (Type s, const Quaternion<Type> &q) {
+            return q * s;
         }
-        
+
         Quaternion<Type> operator/ (Type s) const {
-            return Quaternion(v * (Type(1) / s));
+            return *this * (Type(1) / s);
         }
 
         Quaternion<Type>& operator*= (const Quaternion<Type> &other) {
@@ -76,30 +145,117 @@ namespace xe {
             return *this;
         }
 
-        friend Quaternion<Type> inverse(const Quaternion<Type> &q) {
-            return conj(q) * norm_pow2(q);
+        bool operator== (const Quaternion<Type> &other) const {
+            return v == other.v && equals(w, other.w);
         }
 
-        friend Quaternion<Type> conj(const Quaternion<Type> &q) {
-            return {-q.v, q.w}
+        bool operator!= (const Quaternion<Type> &other) const {
+            return !(*this == other);
         }
 
-        friend Type norm_pow2(const Quaternion<Type> &q) {
-            return dot(q.q, q.q);
+        friend Type dot(const Quaternion<Type> &q1, const Quaternion<Type> &q2) {
+            return dot(q1.v, q2.v) + q1.w*q2.w;
+        }
+
+        friend Type norm2(const Quaternion<Type> &q) {
+            return dot(q, q);
         }
 
         friend Type norm(const Quaternion<Type> &q) {
-            return std::abs(norm_pow2(q));
+            return std::sqrt(norm2(q));
+        }
+
+        friend Quaternion<Type> conj(const Quaternion<Type> &q) {
+            return Quaternion<Type>(-q.v, q.w);
         }
 
-        friend Quaternion<Type> normalize(Quaternion<Type> &q) {
+        friend Quaternion<Type> inverse(const Quaternion<Type> &q) {
+            return conj(q) / norm2(q);
+        }
+
+        friend Quaternion<Type> normalize(const Quaternion<Type> &q) {
             return q / norm(q);
         }
 
-        friend Vector<Type, 3> transform (Quaternion<Type> &q, const Vector<Type, 3> &v) const {
-            return q * Quaternion(v, Type(0)) * inverse(q);
+        /**
+         * @brief Rotate a vector by an unit quaternion.
+         *
+         * Computes q*(v, 0)*conj(q) expanded, with two cross products instead of the two full products.
+         */
+        friend Vector<Type, 3> transform(const Quaternion<Type> &q, const Vector<Type, 3> &v) {
+            const Vector<Type, 3> t = Type(2) * cross(q.v, v);
+
+            return v + q.w*t + cross(q.v, t);
+        }
+
+        friend std::ostream& operator<< (std::ostream &os, const Quaternion<Type> &q) {
+            return os << static_cast<Vector<Type, 4>>(q);
         }
     };
+
+    /**
+     * @brief Rotation matrix of an unit quaternion.
+     */
+    template<typename Type>
+    Matrix<Type, 4, 4> rotate(const Quaternion<Type> &q) {
+        const Type x = q.v.x, y = q.v.y, z = q.v.z, w = q.w;
+
+        auto result = identity<Type, 4>();
+
+        result(0, 0) = Type(1) - Type(2)*(y*y + z*z);
+        result(0, 1) = Type(2)*(x*y - w*z);
+        result(0, 2) = Type(2)*(x*z + w*y);
+
+        result(1, 0) = Type(2)*(x*y + w*z);
+        result(1, 1) = Type(1) - Type(2)*(x*x + z*z);
+        result(1, 2) = Type(2)*(y*z - w*x);
+
+        result(2, 0) = Type(2)*(x*z - w*y);
+        result(2, 1) = Type(2)*(y*z + w*x);
+        result(2, 2) = Type(1) - Type(2)*(x*x + y*y);
+
+        return result;
+    }
+
+    /**
+     * @brief Normalized linear interpolation, along the shortest path.
+     *
+     * The angular velocity isn't constant, but it's much cheaper than slerp and good enough for the
+     * interpolation between near keyframes.
+     */
+    template<typename Type>
+    Quaternion<Type> nlerp(const Quaternion<Type> &q1, const Quaternion<Type> &q2, Type t) {
+        const Quaternion<Type> end = dot(q1, q2) < Type(0) ? -q2 : q2;
+
+        return normalize(q1*(Type(1) - t) + end*t);
+    }
+
+    /**
+     * @brief Spherical linear interpolation, along the shortest path.
+     */
+    template<typename Type>
+    Quaternion<Type> slerp(const Quaternion<Type> &q1, const Quaternion<Type> &q2, Type t) {
+        Type cosAngle = dot(q1, q2);
+        Quaternion<Type> end = q2;
+
+        if (cosAngle < Type(0)) {
+            cosAngle = -cosAngle;
+            end = -q2;
+        }
+
+        // nearly parallel quaternions: the sine below goes to zero, but the arc is almost a straight line
+        if (cosAngle > Type(1) - Epsilon<Type>::Value) {
+            return nlerp(q1, end, t);
+        }
+
+        const Type angle = std::acos(cosAngle);
+        const Type invSin = Type(1) / std::sin(angle);
+
+        return q1*(std::sin((Type(1) - t)*angle) * invSin) + end*(std::sin(t*angle) * invSin);
+    }
+
+    typedef Quaternion<float> Quaternionf;
+    typedef Quaternion<double> Quaterniond;
 }
 
-#endif 
+#endif
@@ -3,6 +3,32 @@
 
 #include <xe/Exception.hpp>
 
+#include <cstring>
+
 namespace xe {
 
+	void StaticBuffer::read(void* data, const int size, const int dataOffset, const int bufferOffset) const {
+#if defined (EXENG_DEBUG)
+		if (bufferOffset + size > this->getSize()) {
+			EXENG_THROW_EXCEPTION("Buffer overrun.");
+		}
+#endif
+		const std::uint8_t* srcData = static_cast<const std::uint8_t*>(this->data) + bufferOffset;
+		std::uint8_t* dstData = static_cast<std::uint8_t*>(data) + dataOffset;
+
+		std::memcpy(dstData, srcData, size);
+	}
+
+	void StaticBuffer::write(const void *data, const int size, const int dataOffset, const int bufferOffset) {
+#if defined (EXENG_DEBUG)
+		if (bufferOffset + size > this->getSize()) {
+			EXENG_THROW_EXCEPTION("Buffer overrun.");
+		}
+#endif
+		const std::uint8_t* srcData = static_cast<const std::uint8_t*>(data) + dataOffset;
+		std::uint8_t* dstData = static_cast<std::uint8_t*>(this->data) + bufferOffset;
+		std::memcpy(dstData, srcData, size);
+
+		this->notifyChange();
+	}
 }
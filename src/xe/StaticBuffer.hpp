@@ -22,7 +22,9 @@ namespace xe {
             return data;
         }
         
-        virtual void unlock() override {}
+        virtual void unlock() override {
+            this->notifyChange();
+        }
         
         virtual const void* lock() const override {
             return data;
@@ -33,6 +35,10 @@ namespace xe {
         virtual int getHandle() const override {
             return 0;
         }
+
+        virtual void read(void* data, const int dataSize, const int dataOffset, const int bufferOffset) const override;
+
+        virtual void write(const void* data, const int dataSize, const int dataOffset, const int bufferOffset) override;
         
 	private:
 		void* data = nullptr;
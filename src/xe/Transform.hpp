@@ -0,0 +1,134 @@
+/**
+ * @file Transform.hpp
+ * @brief Affine transformation stored as separated translation, rotation and scale.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#pragma once
+
+#ifndef __xe_transform_hpp__
+#define __xe_transform_hpp__
+
+#include <xe/Vector.hpp>
+#include <xe/Matrix.hpp>
+#include <xe/Quaternion.hpp>
+
+namespace xe {
+
+    /**
+     * @brief Translation, rotation and scale, applied in reverse order (T * R * S).
+     *
+     * Takes 40 bytes in single precision instead of the 64 of a 4x4 matrix, every component can be animated
+     * by itself, and two transforms can be interpolated without decomposing matrices. Shear can't be
+     * represented.
+     */
+    template<typename Type>
+    struct Transform {
+        Quaternion<Type> rotation;
+        Vector<Type, 3> translation;
+        Vector<Type, 3> scaling;
+
+        Transform() : translation(Type(0)), scaling(Type(1)) {}
+
+        Transform(const Vector<Type, 3> &translation_, const Quaternion<Type> &rotation_, const Vector<Type, 3> &scaling_=Vector<Type, 3>(Type(1)))
+            : rotation(rotation_), translation(translation_), scaling(scaling_) {}
+
+        /**
+         * @brief Decompose an affine matrix, without shear.
+         */
+        explicit Transform(const Matrix<Type, 4, 4> &m) {
+            Matrix<Type, 4, 4> rotationMatrix = identity<Type, 4>();
+
+            for (int j=0; j<3; j++) {
+                const Vector<Type, 3> column(m(0, j), m(1, j), m(2, j));
+
+                scaling[j] = abs(column);
+                translation[j] = m(j, 3);
+
+                for (int i=0; i<3; i++) {
+                    rotationMatrix(i, j) = column[i] / scaling[j];
+                }
+            }
+
+            // a reflection is kept in the scale, so the rest stays a rotation
+            if (abs(rotationMatrix) < Type(0)) {
+                scaling.x = -scaling.x;
+
+                for (int i=0; i<3; i++) {
+                    rotationMatrix(i, 0) = -rotationMatrix(i, 0);
+                }
+            }
+
+            rotation = Quaternion<Type>(rotationMatrix);
+        }
+
+        /**
+         * @brief Build the equivalent matrix. The rotation must be an unit quaternion.
+         */
+        Matrix<Type, 4, 4> toMatrix() const {
+            Matrix<Type, 4, 4> result = rotate(rotation);
+
+            for (int j=0; j<3; j++) {
+                for (int i=0; i<3; i++) {
+                    result(i, j) *= scaling[j];
+                }
+
+                result(j, 3) = translation[j];
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Compose two transforms. The right hand one is applied first.
+         *
+         * The result is exact only when the left hand transform has an uniform scale, since otherwise the
+         * composition has shear.
+         */
+        Transform<Type> operator* (const Transform<Type> &other) const {
+            return Transform<Type> (
+                translation + transform(rotation, scaling * other.translation),
+                rotation * other.rotation,
+                scaling * other.scaling
+            );
+        }
+
+        friend Vector<Type, 3> transform(const Transform<Type> &t, const Vector<Type, 3> &point) {
+            return t.translation + transform(t.rotation, t.scaling * point);
+        }
+
+        /**
+         * @brief Inverse transform. Like the composition, exact only for uniform scales.
+         */
+        friend Transform<Type> inverse(const Transform<Type> &t) {
+            const Quaternion<Type> rotation = conj(t.rotation);
+            const Vector<Type, 3> scaling = Vector<Type, 3>(Type(1)) / t.scaling;
+
+            return Transform<Type>(-(scaling * transform(rotation, t.translation)), rotation, scaling);
+        }
+    };
+
+    /**
+     * @brief Interpolate each component, with nlerp for the rotation.
+     */
+    template<typename Type>
+    Transform<Type> lerp(const Transform<Type> &t1, const Transform<Type> &t2, Type t) {
+        return Transform<Type> (
+            lerp(t1.translation, t2.translation, t),
+            nlerp(t1.rotation, t2.rotation, t),
+            lerp(t1.scaling, t2.scaling, t)
+        );
+    }
+
+    typedef Transform<float> Transformf;
+    typedef Transform<double> Transformd;
+}
+
+#endif
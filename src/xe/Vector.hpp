@@ -27,10 +27,25 @@
 #include <stdexcept>
 #endif
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  define EXENG_VECTOR_SSE
+#  include <xmmintrin.h>
+#endif
+
 namespace xe { 
+    /**
+     * @brief Storage of the vectors. 
+     * 
+     * The four component constructors initialize the first components of the array, so they can be used 
+     * in constant expressions. The extra values are ignored by the smaller vectors.
+     */
     template<typename Type, int size>
     struct VectorBase {
         Type data[size];
+
+        VectorBase() {}
+
+        constexpr VectorBase(Type x, Type y, Type z, Type w) : data{x, y, z, w} {}
     };
 
 	template<typename Type> 
@@ -40,6 +55,10 @@ namespace xe {
             struct { Type x; };
         };
 
+        VectorBase() {}
+
+        constexpr VectorBase(Type x, Type, Type, Type) : data{x} {}
+
 		void set(Type x) {
             this->x = x;
         }
@@ -64,6 +83,10 @@ namespace xe {
             struct { Type x, y; };
         };
 
+        VectorBase() {}
+
+        constexpr VectorBase(Type x, Type y, Type, Type) : data{x, y} {}
+
         void set(Type x, Type y) {
             this->x = x;
             this->y = y;
@@ -85,6 +108,10 @@ namespace xe {
             struct { Type x, y, z; };
         };
 
+        VectorBase() {}
+
+        constexpr VectorBase(Type x, Type y, Type z, Type) : data{x, y, z} {}
+
         void set(Type x, Type y, Type z) {
             this->x = x;
             this->y = y;
@@ -103,6 +130,10 @@ namespace xe {
             struct { Type x, y, z, w; };
         };
 
+        VectorBase() {}
+
+        constexpr VectorBase(Type x, Type y, Type z, Type w) : data{x, y, z, w} {}
+
         void set(Type x, Type y, Type z, Type w) {
             this->x = x;
             this->y = y;
@@ -129,45 +160,29 @@ namespace xe {
 
 		Vector() {}
 
-		Vector( const Vector<Type, Size - 1> &v, Type value) {
+		constexpr Vector(const Vector<Type, Size - 1> &v, Type value) : VectorBase<Type, Size>(Type(), Type(), Type(), Type()) {
 			for (int i=0; i<Size-1; i++) {
-				VectorBase<Type, Size>::data[i] = v[i];
+				this->data[i] = v[i];
 			}
 
-			VectorBase<Type, Size>::data[Size-1] = value;
+			this->data[Size-1] = value;
 		}
 
         explicit Vector(const Type *arrayValues) {
 			this->set(arrayValues);
 		}
 
-        explicit Vector(Type value) {
-			this->set(value);
-		}
-
-        Vector(Type x, Type y) {
-			this->set(Type());
-
-			this->x = x;
-			this->y = y;
+        constexpr explicit Vector(Type value) : VectorBase<Type, Size>(value, value, value, value) {
+			for (int i=4; i<Size; i++) {
+				this->data[i] = value;
+			}
 		}
 
-        Vector(Type x, Type y, Type z) {
-			this->set(Type());
-
-			this->x = x;
-			this->y = y;
-			this->z = z;
-		}
+        constexpr Vector(Type x, Type y) : VectorBase<Type, Size>(x, y, Type(), Type()) {}
 
-        Vector(Type x, Type y, Type z, Type w) {
-			this->set(Type());
+        constexpr Vector(Type x, Type y, Type z) : VectorBase<Type, Size>(x, y, z, Type()) {}
 
-			this->x = x;
-			this->y = y;
-			this->z = z;
-			this->w = w;
-		}
+        constexpr Vector(Type x, Type y, Type z, Type w) : VectorBase<Type, Size>(x, y, z, w) {}
 
         void set(const Type *values) {
 #if defined(EXENG_DEBUG)
@@ -192,7 +207,7 @@ namespace xe {
 			return this->data;
 		}
 		
-        Type& operator[] (int index) {
+        constexpr Type& operator[] (int index) {
 #if defined(EXENG_DEBUG)
 			if (index < 0 || index >= Size) {
 				throw std::runtime_error("Vector<Type, Size>::operator[]: Index out of bounds.");
@@ -201,7 +216,7 @@ namespace xe {
 			return this->data[index];
 		}
 
-        const Type& operator[] (int index) const {
+        constexpr const Type& operator[] (int index) const {
 #if defined(EXENG_DEBUG)
 			if (index < 0 || index >= Size) {
 				throw std::runtime_error("Vector<Type, Size>::operator[]: Index out of bounds.");
@@ -210,125 +225,125 @@ namespace xe {
 			return this->data[index];
 		}
 
-        Vector operator+ (const Vector &rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator+ (const Vector &rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for(int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] + rhs.data[i];
+				result.data[i] += rhs.data[i];
 			}
     
 			return result;
 		}
 
-        Vector& operator+= (const Vector &rhs) {
+        constexpr Vector& operator+= (const Vector &rhs) {
 			*this = *this + rhs;
 
 			return *this;
 		}
 
-        Vector operator- (const Vector &rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator- (const Vector &rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for(int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] - rhs.data[i];
+				result.data[i] -= rhs.data[i];
 			}
     
 			return result;
 		}
 		
-        Vector& operator-= (const Vector &rhs) {
+        constexpr Vector& operator-= (const Vector &rhs) {
 			*this = *this - rhs;
 
 			return *this;
 		}
 
-        Vector operator* (Type rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator* (Type rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for(int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] * rhs;
+				result.data[i] *= rhs;
 			}
     
 			return result;
 		}
 
-        Vector& operator*= (Type rhs) {
+        constexpr Vector& operator*= (Type rhs) {
 			*this = *this * rhs;
 
 			return *this;
 		}
 
         template<typename OtherType>
-        friend Vector<OtherType, Size> operator* (Type Number, const Vector& Other)  {
+        friend constexpr Vector<OtherType, Size> operator* (Type Number, const Vector& Other)  {
             return Other*Number;
         }
     
-        Vector operator/ (Type rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator/ (Type rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for(int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] / rhs;
+				result.data[i] /= rhs;
 			}
     
 			return result;
 		}
     
-        Vector& operator/= (Type rhs) {
+        constexpr Vector& operator/= (Type rhs) {
 			*this = *this / rhs;
 
 			return *this;
 		}
 
-        Vector operator* (const Vector &rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator* (const Vector &rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for (int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] * rhs.data[i];
+				result.data[i] *= rhs.data[i];
 			}
     
 			return result;
 		}
 
-        Vector& operator*= (const Vector &rhs) {
+        constexpr Vector& operator*= (const Vector &rhs) {
 			*this = *this * rhs;
 
 			return *this;
 		}
 
-        Vector operator/ (const Vector &rhs) const {
-			Vector<Type, Size> result;
+        constexpr Vector operator/ (const Vector &rhs) const {
+			Vector<Type, Size> result = *this;
 
 			for(int i=0; i<Size; ++i) {
-				result.data[i] = this->data[i] / rhs.data[i];
+				result.data[i] /= rhs.data[i];
 			}
     
 			return result;
 		}
 
-        Vector& operator/= (const Vector rhs) {
+        constexpr Vector& operator/= (const Vector rhs) {
 			*this = *this / rhs;
 
 			return *this;
 		}
 
-        Vector operator- () const {
+        constexpr Vector operator- () const {
 			return Type(-1)* (*this);
 		}
 
-        bool operator== (const Vector &Other) const {
+        constexpr bool operator== (const Vector &Other) const {
 			return arrayCompare<Type, Size>(this->data, Other.data);
 		}
 
-        bool operator!= (const Vector &Other) const {
+        constexpr bool operator!= (const Vector &Other) const {
 			return !(*this == Other);
 		}
 
-        friend Vector<Type, Size> operator* (Type scalar, const Vector<Type, Size>& other)  {
+        friend constexpr Vector<Type, Size> operator* (Type scalar, const Vector<Type, Size>& other)  {
             return other * scalar;
         }
         
         template<typename OtherType, int OtherSize>
-        operator Vector<OtherType, OtherSize>() const  {
+        constexpr operator Vector<OtherType, OtherSize>() const  {
             Vector<OtherType, OtherSize> result(static_cast<OtherType>(0));
             int minSize = std::min(OtherSize, Size);
         
@@ -339,11 +354,11 @@ namespace xe {
             return result;
         }
     
-        bool isZero() const  {
+        constexpr bool isZero() const  {
 			return *this == Vector<Type, Size>::zero();
 		}
 		
-        static Vector zero() {
+        constexpr static Vector zero() {
 			return Vector<Type, Size>(Type());
 		}
 
@@ -361,7 +376,7 @@ namespace xe {
     };
 
 	template<typename Type, int Size>
-    Type dot(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2)  {
+    constexpr Type dot(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2)  {
 		Type result = static_cast<Type>(0);
 
 		for(int i=0; i<Size; ++i) {
@@ -372,11 +387,12 @@ namespace xe {
 	}
 
 	template<typename Type, int Size>
-    Vector<Type, Size> cross(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) {
+    constexpr Vector<Type, Size> cross(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) {
+		// by index, as the coordinate names can't be read in constant expressions
 		Vector<Type, Size> result = {
-			v1.y*v2.z - v1.z*v2.y, 
-			v1.z*v2.x - v1.x*v2.z, 
-			v1.x*v2.y - v1.y*v2.x
+			v1[1]*v2[2] - v1[2]*v2[1], 
+			v1[2]*v2[0] - v1[0]*v2[2], 
+			v1[0]*v2[1] - v1[1]*v2[0]
 		};
 
 		return result;
@@ -394,7 +410,7 @@ namespace xe {
 	}
 	
 	template<typename Type, int Size>
-    Type abs2(const Vector<Type, Size> &v) 
+    constexpr Type abs2(const Vector<Type, Size> &v) 
 	{
 		return dot(v, v);
 	}
@@ -405,16 +421,53 @@ namespace xe {
 		return std::sqrt(abs2(v));
 	}
 	
+	/**
+	 * @brief Scale the vector to unit length. 
+	 *
+	 * This is the exact variant, that should be used unless the profiler says otherwise. normalizeFast trades 
+	 * a couple of bits of precision for speed, and the VectorArray overloads normalize many vectors at once.
+	 */
 	template<typename Type, int Size>
     Vector<Type, Size> normalize(const Vector<Type, Size> &v)
 	{
 		return v / abs(v);
 	}
+
+	/**
+	 * @brief Approximation of 1/sqrt(value), refined with one Newton-Raphson step. 
+	 *
+	 * The relative error is below 1e-6, versus the 3e-4 of the hardware estimate alone.
+	 */
+	inline float rsqrtFast(float value) 
+	{
+#if defined(EXENG_VECTOR_SSE)
+		const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+
+		return estimate * (1.5f - 0.5f*value*estimate*estimate);
+#else
+		return 1.0f / std::sqrt(value);
+#endif
+	}
+
+	inline double rsqrtFast(double value) 
+	{
+		return 1.0 / std::sqrt(value);
+	}
+
+	/**
+	 * @brief Scale the vector to unit length, with a multiplication by an approximated reciprocal square root 
+	 * instead of a square root and a division. The length of the result differs from one by less than 1e-6.
+	 */
+	template<typename Type, int Size>
+    Vector<Type, Size> normalizeFast(const Vector<Type, Size> &v)
+	{
+		return v * rsqrtFast(abs2(v));
+	}
 	
 	template<typename Type, int Size>
-    Vector<Type, Size> maximize(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) 
+    constexpr Vector<Type, Size> maximize(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) 
 	{
-		Vector<Type, Size> result;
+		Vector<Type, Size> result = v1;
 
 		for (int i=0; i<Size; ++i) {
 			result.data[i] = std::max(v1[i], v2[i]);
@@ -424,9 +477,9 @@ namespace xe {
 	}
 	
 	template<typename Type, int Size>
-    Vector<Type, Size> minimize(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) 
+    constexpr Vector<Type, Size> minimize(const Vector<Type, Size> &v1, const Vector<Type, Size> &v2) 
 	{
-		Vector<Type, Size> result;
+		Vector<Type, Size> result = v1;
 
 		for (int i=0; i<Size; ++i) {
 			result.data[i] = std::min(v1[i], v2[i]);
@@ -436,7 +489,7 @@ namespace xe {
 	}
 	
 	template<typename Type, int Size>
-    Type max(const Vector<Type, Size> &v) 
+    constexpr Type max(const Vector<Type, Size> &v) 
 	{
 		Type result = v[0];
 
@@ -448,7 +501,7 @@ namespace xe {
 	}
 	
 	template<typename Type, int Size>
-    Type min(const Vector<Type, Size> &v) 
+    constexpr Type min(const Vector<Type, Size> &v) 
 	{
 		Type result = v[0];
 
@@ -467,13 +520,13 @@ namespace xe {
 	}
 	
 	template<typename Type, int Size>
-    Vector<Type, Size> lerp(const Vector<Type, Size>& v1, const Vector<Type, Size>& v2, Type t)
+    constexpr Vector<Type, Size> lerp(const Vector<Type, Size>& v1, const Vector<Type, Size>& v2, Type t)
 	{
 		return t*v2 + v1*(Type(1) - t);
 	}
 
     template<typename Type, typename Scalar>
-    Type lerp(const Type &v1, const Type &v2, Scalar t) {
+    constexpr Type lerp(const Type &v1, const Type &v2, Scalar t) {
         return t*v2 + v1*(Scalar(1) - t);
     }
 
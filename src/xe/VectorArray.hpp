@@ -0,0 +1,604 @@
+/**
+ * @file VectorArray.hpp
+ * @brief Array of vectors stored as a structure of arrays, and its companion functions.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_VECTORARRAY_HPP__
+#define __EXENG_VECTORARRAY_HPP__
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include <xe/Config.hpp>
+#include <xe/Vector.hpp>
+#include <xe/AlignedAllocator.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EXENG_VECTORARRAY_SSE
+#  include <emmintrin.h>
+#endif
+
+namespace xe {
+
+    /**
+     * @brief Array of vectors, with each coordinate stored in its own stream.
+     *
+     * Unlike std::vector<Vector<Type, Size>>, the loops over the same coordinate of consecutive elements
+     * read contiguous memory, so the compiler can process several elements per instruction. Each
+     * stream starts at a cache line.
+     *
+     * The elements are accessed by value, or through a proxy object when the array is modifiable.
+     */
+    template<typename Type, int Size>
+    class VectorArray {
+    public:
+        typedef Vector<Type, Size> VectorType;
+
+        /**
+         * @brief Proxy to an element of the array.
+         */
+        class Reference {
+        public:
+            Reference(VectorArray<Type, Size> *array, std::size_t index) : array(array), index(index) {}
+
+            operator VectorType() const {
+                return static_cast<const VectorArray<Type, Size>*>(this->array)->get(this->index);
+            }
+
+            Reference& operator= (const VectorType &value) {
+                this->array->set(this->index, value);
+
+                return *this;
+            }
+
+            Reference& operator= (const Reference &other) {
+                return *this = static_cast<VectorType>(other);
+            }
+
+            Type& operator[] (int coord) {
+                return this->array->getStream(coord)[this->index];
+            }
+
+            Type operator[] (int coord) const {
+                return this->array->getStream(coord)[this->index];
+            }
+
+        private:
+            VectorArray<Type, Size> *array;
+            std::size_t index;
+        };
+
+    public:
+        VectorArray() {}
+
+        explicit VectorArray(std::size_t count) {
+            this->resize(count);
+        }
+
+        VectorArray(std::size_t count, const VectorType &value) {
+            this->resize(count, value);
+        }
+
+        template<typename Iterator>
+        VectorArray(Iterator begin, Iterator end) {
+            for (Iterator it=begin; it!=end; ++it) {
+                this->push_back(*it);
+            }
+        }
+
+        std::size_t size() const {
+            return this->streams[0].size();
+        }
+
+        bool empty() const {
+            return this->streams[0].empty();
+        }
+
+        void clear() {
+            for (int i=0; i<Size; i++) {
+                this->streams[i].clear();
+            }
+        }
+
+        void reserve(std::size_t count) {
+            for (int i=0; i<Size; i++) {
+                this->streams[i].reserve(count);
+            }
+        }
+
+        /**
+         * @brief Change the number of elements. The new ones are set to zero.
+         */
+        void resize(std::size_t count) {
+            this->resize(count, VectorType(Type()));
+        }
+
+        void resize(std::size_t count, const VectorType &value) {
+            for (int i=0; i<Size; i++) {
+                this->streams[i].resize(count, value[i]);
+            }
+        }
+
+        void push_back(const VectorType &value) {
+            for (int i=0; i<Size; i++) {
+                this->streams[i].push_back(value[i]);
+            }
+        }
+
+        VectorType get(std::size_t index) const {
+            assert(index < this->size());
+
+            VectorType result;
+
+            for (int i=0; i<Size; i++) {
+                result[i] = this->streams[i][index];
+            }
+
+            return result;
+        }
+
+        void set(std::size_t index, const VectorType &value) {
+            assert(index < this->size());
+
+            for (int i=0; i<Size; i++) {
+                this->streams[i][index] = value[i];
+            }
+        }
+
+        Reference operator[] (std::size_t index) {
+            assert(index < this->size());
+
+            return Reference(this, index);
+        }
+
+        VectorType operator[] (std::size_t index) const {
+            return this->get(index);
+        }
+
+        /**
+         * @brief Get the values of the specified coordinate of all the elements.
+         */
+        Type* getStream(int coord) {
+            assert(coord >= 0 && coord < Size);
+
+            return this->streams[coord].data();
+        }
+
+        const Type* getStream(int coord) const {
+            assert(coord >= 0 && coord < Size);
+
+            return this->streams[coord].data();
+        }
+
+    private:
+        AlignedVector<Type> streams[Size];
+    };
+
+    /**
+     * @brief Element wise operations over streams of scalars.
+     *
+     * The streams never overlap, and telling it to the compiler is what allows it to vectorize the loops.
+     */
+    template<typename Type>
+    struct StreamOps {
+        static void multiply(std::size_t count, const Type * EXENG_RESTRICT a, const Type * EXENG_RESTRICT b, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] = a[i] * b[i];
+            }
+        }
+
+        static void multiplyAdd(std::size_t count, const Type * EXENG_RESTRICT a, const Type * EXENG_RESTRICT b, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] += a[i] * b[i];
+            }
+        }
+
+        //! result = a*b - c*d
+        static void multiplySubtract(std::size_t count, const Type * EXENG_RESTRICT a, const Type * EXENG_RESTRICT b, const Type * EXENG_RESTRICT c, const Type * EXENG_RESTRICT d, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] = a[i]*b[i] - c[i]*d[i];
+            }
+        }
+
+        //! result = result * a
+        static void scale(std::size_t count, const Type * EXENG_RESTRICT a, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] *= a[i];
+            }
+        }
+
+        //! values = 1 / sqrt(values)
+        static void reciprocalSqrt(std::size_t count, Type *values) {
+            for (std::size_t i=0; i<count; i++) {
+                values[i] = Type(1) / std::sqrt(values[i]);
+            }
+        }
+
+        static void reciprocalSqrtFast(std::size_t count, Type *values) {
+            for (std::size_t i=0; i<count; i++) {
+                values[i] = rsqrtFast(values[i]);
+            }
+        }
+
+        //! Normalization of three dimensional vectors, in a single pass
+        static void normalize(std::size_t count, const Type * EXENG_RESTRICT x, const Type * EXENG_RESTRICT y, const Type * EXENG_RESTRICT z, Type * EXENG_RESTRICT resultX, Type * EXENG_RESTRICT resultY, Type * EXENG_RESTRICT resultZ, bool fast) {
+            for (std::size_t i=0; i<count; i++) {
+                const Type lengthSq = x[i]*x[i] + y[i]*y[i] + z[i]*z[i];
+                const Type factor = fast ? rsqrtFast(lengthSq) : Type(1) / std::sqrt(lengthSq);
+
+                resultX[i] = x[i] * factor;
+                resultY[i] = y[i] * factor;
+                resultZ[i] = z[i] * factor;
+            }
+        }
+
+        static void maximize(std::size_t count, const Type * EXENG_RESTRICT a, const Type * EXENG_RESTRICT b, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] = a[i] > b[i] ? a[i] : b[i];
+            }
+        }
+
+        static void minimize(std::size_t count, const Type * EXENG_RESTRICT a, const Type * EXENG_RESTRICT b, Type * EXENG_RESTRICT result) {
+            for (std::size_t i=0; i<count; i++) {
+                result[i] = a[i] < b[i] ? a[i] : b[i];
+            }
+        }
+    };
+
+#if defined(EXENG_VECTORARRAY_SSE)
+    /**
+     * @brief SSE implementation of the stream operations for floats, that doesn't depend on the optimization
+     * settings of the compiler. The streams are assumed to start at a 16 byte boundary.
+     */
+    template<>
+    struct StreamOps<float> {
+        static void multiply(std::size_t count, const float *a, const float *b, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                _mm_store_ps(result + i, _mm_mul_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+            }
+
+            for (; i<count; i++) {
+                result[i] = a[i] * b[i];
+            }
+        }
+
+        static void multiplyAdd(std::size_t count, const float *a, const float *b, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                const __m128 product = _mm_mul_ps(_mm_load_ps(a + i), _mm_load_ps(b + i));
+
+                _mm_store_ps(result + i, _mm_add_ps(_mm_load_ps(result + i), product));
+            }
+
+            for (; i<count; i++) {
+                result[i] += a[i] * b[i];
+            }
+        }
+
+        static void multiplySubtract(std::size_t count, const float *a, const float *b, const float *c, const float *d, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                const __m128 ab = _mm_mul_ps(_mm_load_ps(a + i), _mm_load_ps(b + i));
+                const __m128 cd = _mm_mul_ps(_mm_load_ps(c + i), _mm_load_ps(d + i));
+
+                _mm_store_ps(result + i, _mm_sub_ps(ab, cd));
+            }
+
+            for (; i<count; i++) {
+                result[i] = a[i]*b[i] - c[i]*d[i];
+            }
+        }
+
+        static void scale(std::size_t count, const float *a, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                _mm_store_ps(result + i, _mm_mul_ps(_mm_load_ps(result + i), _mm_load_ps(a + i)));
+            }
+
+            for (; i<count; i++) {
+                result[i] *= a[i];
+            }
+        }
+
+        static void reciprocalSqrt(std::size_t count, float *values) {
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                _mm_store_ps(values + i, _mm_div_ps(one, _mm_sqrt_ps(_mm_load_ps(values + i))));
+            }
+
+            for (; i<count; i++) {
+                values[i] = 1.0f / std::sqrt(values[i]);
+            }
+        }
+
+        static void reciprocalSqrtFast(std::size_t count, float *values) {
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 threeHalves = _mm_set1_ps(1.5f);
+
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                const __m128 x = _mm_load_ps(values + i);
+                const __m128 estimate = _mm_rsqrt_ps(x);
+                const __m128 correction = _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, x), _mm_mul_ps(estimate, estimate)));
+
+                _mm_store_ps(values + i, _mm_mul_ps(estimate, correction));
+            }
+
+            for (; i<count; i++) {
+                values[i] = rsqrtFast(values[i]);
+            }
+        }
+
+        static void normalize(std::size_t count, const float *x, const float *y, const float *z, float *resultX, float *resultY, float *resultZ, bool fast) {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 threeHalves = _mm_set1_ps(1.5f);
+
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                const __m128 vx = _mm_load_ps(x + i);
+                const __m128 vy = _mm_load_ps(y + i);
+                const __m128 vz = _mm_load_ps(z + i);
+
+                const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+
+                __m128 factor;
+
+                if (fast) {
+                    const __m128 estimate = _mm_rsqrt_ps(lengthSq);
+                    factor = _mm_mul_ps(estimate, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, lengthSq), _mm_mul_ps(estimate, estimate))));
+                } else {
+                    factor = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+                }
+
+                _mm_store_ps(resultX + i, _mm_mul_ps(vx, factor));
+                _mm_store_ps(resultY + i, _mm_mul_ps(vy, factor));
+                _mm_store_ps(resultZ + i, _mm_mul_ps(vz, factor));
+            }
+
+            for (; i<count; i++) {
+                const float lengthSq = x[i]*x[i] + y[i]*y[i] + z[i]*z[i];
+                const float factor = fast ? rsqrtFast(lengthSq) : 1.0f / std::sqrt(lengthSq);
+
+                resultX[i] = x[i] * factor;
+                resultY[i] = y[i] * factor;
+                resultZ[i] = z[i] * factor;
+            }
+        }
+
+        static void maximize(std::size_t count, const float *a, const float *b, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                _mm_store_ps(result + i, _mm_max_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+            }
+
+            for (; i<count; i++) {
+                result[i] = a[i] > b[i] ? a[i] : b[i];
+            }
+        }
+
+        static void minimize(std::size_t count, const float *a, const float *b, float *result) {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                _mm_store_ps(result + i, _mm_min_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+            }
+
+            for (; i<count; i++) {
+                result[i] = a[i] < b[i] ? a[i] : b[i];
+            }
+        }
+    };
+#endif
+
+    /**
+     * @brief Dot product of each pair of elements. 
+     *
+     * Like the rest of the operations over arrays, it has a version that stores the result in an existing 
+     * array, to reuse its memory between calls.
+     */
+    template<typename Type, int Size>
+    void dot(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2, AlignedVector<Type> &result) {
+        assert(v1.size() == v2.size());
+
+        const std::size_t count = v1.size();
+
+        result.resize(count);
+
+        StreamOps<Type>::multiply(count, v1.getStream(0), v2.getStream(0), result.data());
+
+        for (int i=1; i<Size; i++) {
+            StreamOps<Type>::multiplyAdd(count, v1.getStream(i), v2.getStream(i), result.data());
+        }
+    }
+
+    template<typename Type, int Size>
+    AlignedVector<Type> dot(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2) {
+        AlignedVector<Type> result;
+
+        dot(v1, v2, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Cross product of each pair of elements. The result can't be one of the operands.
+     */
+    template<typename Type>
+    void cross(const VectorArray<Type, 3> &v1, const VectorArray<Type, 3> &v2, VectorArray<Type, 3> &result) {
+        assert(v1.size() == v2.size());
+        assert(&result != &v1 && &result != &v2);
+
+        const std::size_t count = v1.size();
+
+        result.resize(count);
+
+        for (int i=0; i<3; i++) {
+            const int j = (i + 1) % 3;
+            const int k = (i + 2) % 3;
+
+            StreamOps<Type>::multiplySubtract(count, v1.getStream(j), v2.getStream(k), v1.getStream(k), v2.getStream(j), result.getStream(i));
+        }
+    }
+
+    template<typename Type>
+    VectorArray<Type, 3> cross(const VectorArray<Type, 3> &v1, const VectorArray<Type, 3> &v2) {
+        VectorArray<Type, 3> result;
+
+        cross(v1, v2, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Scale each element by the reciprocal of its length, exact or approximated.
+     */
+    template<typename Type, int Size>
+    void scaleToUnitLength(const VectorArray<Type, Size> &v, VectorArray<Type, Size> &result, bool fast) {
+        assert(&result != &v);
+
+        const std::size_t count = v.size();
+
+        result.resize(count);
+
+        // the last stream of the result holds the reciprocal of the lengths, until it gets its own value
+        Type *factors = result.getStream(Size - 1);
+
+        StreamOps<Type>::multiply(count, v.getStream(0), v.getStream(0), factors);
+
+        for (int i=1; i<Size; i++) {
+            StreamOps<Type>::multiplyAdd(count, v.getStream(i), v.getStream(i), factors);
+        }
+
+        if (fast) {
+            StreamOps<Type>::reciprocalSqrtFast(count, factors);
+        } else {
+            StreamOps<Type>::reciprocalSqrt(count, factors);
+        }
+
+        for (int i=0; i<Size - 1; i++) {
+            StreamOps<Type>::multiply(count, v.getStream(i), factors, result.getStream(i));
+        }
+
+        StreamOps<Type>::scale(count, v.getStream(Size - 1), factors);
+    }
+
+    template<typename Type>
+    void scaleToUnitLength(const VectorArray<Type, 3> &v, VectorArray<Type, 3> &result, bool fast) {
+        assert(&result != &v);
+
+        result.resize(v.size());
+
+        StreamOps<Type>::normalize (
+            v.size(), 
+            v.getStream(0), v.getStream(1), v.getStream(2), 
+            result.getStream(0), result.getStream(1), result.getStream(2), 
+            fast
+        );
+    }
+
+    /**
+     * @brief Normalize each element. The result can't be the operand.
+     */
+    template<typename Type, int Size>
+    void normalize(const VectorArray<Type, Size> &v, VectorArray<Type, Size> &result) {
+        scaleToUnitLength(v, result, false);
+    }
+
+    template<typename Type, int Size>
+    VectorArray<Type, Size> normalize(const VectorArray<Type, Size> &v) {
+        VectorArray<Type, Size> result;
+
+        normalize(v, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Normalize each element, with the same precision as the normalizeFast function for single vectors.
+     */
+    template<typename Type, int Size>
+    void normalizeFast(const VectorArray<Type, Size> &v, VectorArray<Type, Size> &result) {
+        scaleToUnitLength(v, result, true);
+    }
+
+    template<typename Type, int Size>
+    VectorArray<Type, Size> normalizeFast(const VectorArray<Type, Size> &v) {
+        VectorArray<Type, Size> result;
+
+        normalizeFast(v, result);
+
+        return result;
+    }
+
+    template<typename Type, int Size>
+    void maximize(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2, VectorArray<Type, Size> &result) {
+        assert(v1.size() == v2.size());
+
+        result.resize(v1.size());
+
+        for (int i=0; i<Size; i++) {
+            StreamOps<Type>::maximize(v1.size(), v1.getStream(i), v2.getStream(i), result.getStream(i));
+        }
+    }
+
+    template<typename Type, int Size>
+    VectorArray<Type, Size> maximize(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2) {
+        VectorArray<Type, Size> result;
+
+        maximize(v1, v2, result);
+
+        return result;
+    }
+
+    template<typename Type, int Size>
+    void minimize(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2, VectorArray<Type, Size> &result) {
+        assert(v1.size() == v2.size());
+
+        result.resize(v1.size());
+
+        for (int i=0; i<Size; i++) {
+            StreamOps<Type>::minimize(v1.size(), v1.getStream(i), v2.getStream(i), result.getStream(i));
+        }
+    }
+
+    template<typename Type, int Size>
+    VectorArray<Type, Size> minimize(const VectorArray<Type, Size> &v1, const VectorArray<Type, Size> &v2) {
+        VectorArray<Type, Size> result;
+
+        minimize(v1, v2, result);
+
+        return result;
+    }
+
+    typedef VectorArray<float, 2> Vector2fArray;
+    typedef VectorArray<float, 3> Vector3fArray;
+    typedef VectorArray<float, 4> Vector4fArray;
+
+    typedef VectorArray<double, 2> Vector2dArray;
+    typedef VectorArray<double, 3> Vector3dArray;
+    typedef VectorArray<double, 4> Vector4dArray;
+}
+
+#endif  //__EXENG_VECTORARRAY_HPP__
@@ -1,35 +1,329 @@
 
 #include "Algorithm.hpp"
 
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <vector>
 #include <xe/Vector.hpp>
-#include <xe/HeapBuffer.hpp>
 #include <xe/gfx/Mesh.hpp>
 #include <xe/gfx/MeshSubset.hpp>
-#include <xe/gfx/VertexArray.hpp>
+#include <xe/sys/ThreadPool.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EXENG_ALGORITHM_SSE
+#  include <emmintrin.h>
+#endif
 
 namespace xe { namespace gfx {
+
+	//! Number of elements below which a sequence is transformed by the calling thread alone.
+	static const int TransformGrain = 16384;
+
+	//! Number of points reduced by each task of computeBox.
+	static const int BoxGrain = 65536;
+
+	/**
+	 * @brief The first three rows of a transformation, by rows.
+	 */
+	struct AffineRows {
+		float values[3][4];
+
+		explicit AffineRows(const Matrix4f &m) {
+			for (int i=0; i<3; i++) {
+				for (int j=0; j<4; j++) {
+					this->values[i][j] = m(i, j);
+				}
+			}
+		}
+	};
+
+	static void transformScalar(const AffineRows &m, std::uint8_t *data, int stride, int begin, int end, bool normalize) {
+		for (int i=begin; i<end; i++) {
+			float *v = reinterpret_cast<float*>(data + i*stride);
+
+			float result[3];
+
+			for (int row=0; row<3; row++) {
+				result[row] = m.values[row][0]*v[0] + m.values[row][1]*v[1] + m.values[row][2]*v[2] + m.values[row][3];
+			}
+
+			float factor = 1.0f;
+
+			if (normalize) {
+				const float length = std::sqrt(result[0]*result[0] + result[1]*result[1] + result[2]*result[2]);
+				factor = length > 0.0f ? 1.0f / length : 0.0f;
+			}
+
+			v[0] = result[0] * factor;
+			v[1] = result[1] * factor;
+			v[2] = result[2] * factor;
+		}
+	}
+
+#if defined(EXENG_ALGORITHM_SSE)
+	/**
+	 * @brief Transforms four elements per iteration. Their coordinates are gathered in structure of arrays form, 
+	 * so each register holds the same coordinate of the four elements.
+	 */
+	static void transformSSE(const AffineRows &m, std::uint8_t *data, int stride, int begin, int end, bool normalize) {
+		__m128 rows[3][4];
+
+		for (int i=0; i<3; i++) {
+			for (int j=0; j<4; j++) {
+				rows[i][j] = _mm_set1_ps(m.values[i][j]);
+			}
+		}
+
+		int i = begin;
+
+		// the last element is left to the scalar path, so the loads never go beyond the range
+		for (; i + 4 < end; i += 4) {
+			float *v0 = reinterpret_cast<float*>(data + (i + 0)*stride);
+			float *v1 = reinterpret_cast<float*>(data + (i + 1)*stride);
+			float *v2 = reinterpret_cast<float*>(data + (i + 2)*stride);
+			float *v3 = reinterpret_cast<float*>(data + (i + 3)*stride);
+
+			// the float that follows each element is loaded too, and stored back unchanged. When the elements
+			// are packed, it is the first coordinate of the next one, overwritten by the next store.
+			__m128 x = _mm_loadu_ps(v0);
+			__m128 y = _mm_loadu_ps(v1);
+			__m128 z = _mm_loadu_ps(v2);
+			__m128 w = _mm_loadu_ps(v3);
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			__m128 result[3];
+
+			for (int row=0; row<3; row++) {
+				result[row] = _mm_add_ps (
+					_mm_add_ps(_mm_mul_ps(rows[row][0], x), _mm_mul_ps(rows[row][1], y)), 
+					_mm_add_ps(_mm_mul_ps(rows[row][2], z), rows[row][3])
+				);
+			}
+
+			if (normalize) {
+				const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(result[0], result[0]), _mm_mul_ps(result[1], result[1])), _mm_mul_ps(result[2], result[2]));
+				const __m128 nonZero = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+				const __m128 factor = _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq)));
+
+				for (int row=0; row<3; row++) {
+					result[row] = _mm_mul_ps(result[row], factor);
+				}
+			}
+
+			// back to one element per register
+			_MM_TRANSPOSE4_PS(result[0], result[1], result[2], w);
+
+			_mm_storeu_ps(v0, result[0]);
+			_mm_storeu_ps(v1, result[1]);
+			_mm_storeu_ps(v2, result[2]);
+			_mm_storeu_ps(v3, w);
+		}
+
+		transformScalar(m, data, stride, i, end, normalize);
+	}
+#endif
+
+	static void transformRange(const AffineRows &m, std::uint8_t *data, int stride, int begin, int end, bool normalize) {
+#if defined(EXENG_ALGORITHM_SSE)
+		transformSSE(m, data, stride, begin, end, normalize);
+#else
+		transformScalar(m, data, stride, begin, end, normalize);
+#endif
+	}
+
+	static void transformSequence(const AffineRows &m, float *values, int stride, int count, bool normalize) {
+		assert(values);
+		assert(stride >= static_cast<int>(3*sizeof(float)));
+		assert(count >= 0);
+
+		std::uint8_t *data = reinterpret_cast<std::uint8_t*>(values);
+
+		if (count <= TransformGrain) {
+			transformRange(m, data, stride, 0, count, normalize);
+			return;
+		}
+
+		xe::sys::ThreadPool::getDefault()->parallelFor(0, count, TransformGrain, [&](int begin, int end) {
+			transformRange(m, data, stride, begin, end, normalize);
+		});
+	}
+
+	void transformPoints(const Matrix4f &transformation, float *points, int stride, int count) {
+		transformSequence(AffineRows(transformation), points, stride, count, false);
+	}
+
+	void transformNormals(const Matrix4f &transformation, float *normals, int stride, int count) {
+		// only the linear part affects the directions
+		Matrix4f linear = identity<float, 4>();
+
+		for (int i=0; i<3; i++) {
+			for (int j=0; j<3; j++) {
+				linear(i, j) = transformation(i, j);
+			}
+		}
+
+		transformSequence(AffineRows(transpose(inverse(linear))), normals, stride, count, true);
+	}
+
+	static Boxf computeBoxScalar(const std::uint8_t *data, int stride, int begin, int end) {
+		Boxf box;
+
+		for (int i=begin; i<end; i++) {
+			const float *v = reinterpret_cast<const float*>(data + i*stride);
+
+			box.expand(Vector3f(v[0], v[1], v[2]));
+		}
+
+		return box;
+	}
+
+#if defined(EXENG_ALGORITHM_SSE)
+	/**
+	 * @brief Reduces one point per register, with the fourth lane ignored. Two pairs of accumulators hide the 
+	 * latency of the min and max instructions.
+	 */
+	static Boxf computeBoxSSE(const std::uint8_t *data, int stride, int begin, int end) {
+		if (end - begin < 2) {
+			return computeBoxScalar(data, stride, begin, end);
+		}
+
+		const __m128 first = _mm_loadu_ps(reinterpret_cast<const float*>(data + begin*stride));
+
+		__m128 minimum[2] = {first, first};
+		__m128 maximum[2] = {first, first};
+
+		int i = begin + 1;
+
+		// as in transformSSE, the last point is left to the scalar path, so the loads never go beyond the range
+		for (; i + 2 < end; i += 2) {
+			const __m128 v0 = _mm_loadu_ps(reinterpret_cast<const float*>(data + (i + 0)*stride));
+			const __m128 v1 = _mm_loadu_ps(reinterpret_cast<const float*>(data + (i + 1)*stride));
+
+			minimum[0] = _mm_min_ps(minimum[0], v0);
+			maximum[0] = _mm_max_ps(maximum[0], v0);
+			minimum[1] = _mm_min_ps(minimum[1], v1);
+			maximum[1] = _mm_max_ps(maximum[1], v1);
+		}
+
+		alignas(16) float minEdge[4], maxEdge[4];
+
+		_mm_store_ps(minEdge, _mm_min_ps(minimum[0], minimum[1]));
+		_mm_store_ps(maxEdge, _mm_max_ps(maximum[0], maximum[1]));
+
+		Boxf box(Vector3f(minEdge[0], minEdge[1], minEdge[2]), Vector3f(maxEdge[0], maxEdge[1], maxEdge[2]));
+
+		box.expand(computeBoxScalar(data, stride, i, end));
+
+		return box;
+	}
+#endif
+
+	static Boxf computeBoxRange(const std::uint8_t *data, int stride, int begin, int end) {
+#if defined(EXENG_ALGORITHM_SSE)
+		return computeBoxSSE(data, stride, begin, end);
+#else
+		return computeBoxScalar(data, stride, begin, end);
+#endif
+	}
+
+	Boxf computeBox(const float *points, int stride, int count) {
+		assert(points || count == 0);
+		assert(stride >= static_cast<int>(3*sizeof(float)));
+		assert(count >= 0);
+
+		const std::uint8_t *data = reinterpret_cast<const std::uint8_t*>(points);
+
+		if (count <= BoxGrain) {
+			return computeBoxRange(data, stride, 0, count);
+		}
+
+		// each part is reduced on its own, and the partial boxes are merged in order
+		const int partCount = (count + BoxGrain - 1) / BoxGrain;
+
+		std::vector<Boxf> parts(partCount);
+
+		xe::sys::ThreadPool::getDefault()->parallelFor(0, partCount, 1, [&](int begin, int end) {
+			for (int part=begin; part<end; part++) {
+				parts[part] = computeBoxRange(data, stride, part*BoxGrain, std::min(count, (part + 1)*BoxGrain));
+			}
+		});
+
+		Boxf box = parts[0];
+
+		for (int part=1; part<partCount; part++) {
+			box.expand(parts[part]);
+		}
+
+		return box;
+	}
+
+	int getVectorAttribOffset(const VertexFormat *format, VertexAttrib::Enum attrib) {
+		if (!format->hasAttrib(attrib)) {
+			return VertexFormat::InvalidOffset;
+		}
+
+		const VertexField field = format->getAttrib(attrib);
+
+		if (field.dataType != DataType::Float32 || field.count < 3) {
+			return VertexFormat::InvalidOffset;
+		}
+
+		return format->getAttribOffset(attrib);
+	}
+
 	void transform(MeshSubset *subset, const Matrix4f &transformation) {
 		const VertexFormat *format = subset->getFormat();
 
+		const int positionOffset = getVectorAttribOffset(format, VertexAttrib::Position);
+		const int normalOffset = getVectorAttribOffset(format, VertexAttrib::Normal);
+
+		if (positionOffset == VertexFormat::InvalidOffset && normalOffset == VertexFormat::InvalidOffset) {
+			return;
+		}
+
 		Buffer *buffer = subset->getBuffer(0);
 
-		auto locker = buffer->getLocker();
+		const int stride = format->getSize();
+		const int count = static_cast<int>(buffer->getSize()) / stride;
+
+		// the whole buffer is transformed in a local copy, and written back at once
+		std::vector<std::uint8_t> data(buffer->getSize());
+		buffer->read(data.data(), static_cast<int>(data.size()));
+
+		if (positionOffset != VertexFormat::InvalidOffset) {
+			transformPoints(transformation, reinterpret_cast<float*>(data.data() + positionOffset), stride, count);
+		}
+
+		if (normalOffset != VertexFormat::InvalidOffset) {
+			transformNormals(transformation, reinterpret_cast<float*>(data.data() + normalOffset), stride, count);
+		}
 
-		VertexArray array(locker.getPointer(), format);
+		buffer->write(data.data(), static_cast<int>(data.size()));
+	}
 
-		for (int i=0; i<subset->getVertexCount(); i++) {
-			Vector4f position = {0.0f, 0.0f, 0.0f, 1.0f};
-			Vector4f normal = {0.0f, 0.0f, 0.0f, 0.0f};
+	Boxf computeBox(const MeshSubset *subset) {
+		const VertexFormat *format = subset->getFormat();
 
-			array.getAttribValue(i, VertexAttrib::Position, &position);
-			array.getAttribValue(i, VertexAttrib::Normal, &normal);
+		if (format == nullptr || subset->getBufferCount() == 0 || subset->getBuffer(0) == nullptr) {
+			return Boxf();
+		}
 
-			position	= xe::transform(transformation, position);
-			normal		= xe::transform(transformation, normal);
+		const int positionOffset = getVectorAttribOffset(format, VertexAttrib::Position);
+		const Buffer *buffer = subset->getBuffer(0);
 
-			array.setAttribValue(i, VertexAttrib::Position, &position);
-			array.setAttribValue(i, VertexAttrib::Normal, &normal);
+		if (positionOffset == VertexFormat::InvalidOffset) {
+			return Boxf();
 		}
+
+		const int stride = format->getSize();
+		const int count = static_cast<int>(buffer->getSize()) / stride;
+
+		std::vector<std::uint8_t> data(buffer->getSize());
+		buffer->read(data.data(), static_cast<int>(data.size()));
+
+		return computeBox(reinterpret_cast<const float*>(data.data() + positionOffset), stride, count);
 	}
 
     void transform(Mesh *mesh, const Matrix4f &transformation) {
@@ -8,6 +8,7 @@
 #include <xe/Buffer.hpp>
 #include <xe/Matrix.hpp>
 #include <xe/Vector.hpp>
+#include <xe/Boundary.hpp>
 #include <xe/gfx/Forward.hpp>
 #include <xe/gfx/IndexFormat.hpp>
 #include <xe/gfx/VertexFormat.hpp>
@@ -15,6 +16,47 @@
 namespace xe { namespace gfx {
     extern EXENGAPI void transform(MeshSubset *subset, const Matrix4f &transformation);
     extern EXENGAPI void transform(Mesh *mesh, const Matrix4f &transformation);
+
+    /**
+     * @brief Transform, in place, a sequence of points stored as three consecutive floats. 
+     *
+     * The points are transformed in groups of four, with their coordinates held in SIMD registers, and the long 
+     * sequences are split between the threads of the default thread pool. The last row of the transformation is ignored.
+     * @param stride Distance, in bytes, between the first coordinates of two consecutive points.
+     */
+    extern EXENGAPI void transformPoints(const Matrix4f &transformation, float *points, int stride, int count);
+
+    /**
+     * @brief Transform, in place, a sequence of normal vectors stored as three consecutive floats.
+     *
+     * The normals are transformed by the inverse transpose of the upper 3x3 part of the transformation, 
+     * so they stay perpendicular to the transformed surfaces, and normalized again.
+     * @param stride Distance, in bytes, between the first coordinates of two consecutive normals.
+     */
+    extern EXENGAPI void transformNormals(const Matrix4f &transformation, float *normals, int stride, int count);
+
+    /**
+     * @brief Compute the bounding box of a sequence of points stored as three consecutive floats.
+     *
+     * The minimum and maximum are reduced in SIMD registers, and the long sequences are split in fixed parts 
+     * between the threads of the default thread pool, so the result doesn't depend on the scheduling.
+     * @param stride Distance, in bytes, between the first coordinates of two consecutive points.
+     * @return A invalid box when the sequence is empty.
+     */
+    extern EXENGAPI Boxf computeBox(const float *points, int stride, int count);
+
+    /**
+     * @brief Compute the bounding box of the positions of all the vertices of the subset, referenced by the indices or not.
+     */
+    extern EXENGAPI Boxf computeBox(const MeshSubset *subset);
+
+    /**
+     * @brief Get the offset of an attribute stored as three or more floats, or VertexFormat::InvalidOffset.
+     *
+     * Also returns VertexFormat::InvalidOffset when the format doesn't have the attribute, 
+     * or when it isn't stored interleaved in a single buffer.
+     */
+    extern EXENGAPI int getVectorAttribOffset(const VertexFormat *format, VertexAttrib::Enum attrib);
 }}
 
 #endif	// __xe_gfx_transform_hpp__
@@ -13,11 +13,23 @@
 
 #include "Mesh.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <boost/checked_delete.hpp>
+#include <xe/Exception.hpp>
 #include <xe/Vector.hpp>
+#include <xe/AlignedAllocator.hpp>
 #include <xe/gfx/VertexArray.hpp>
+#include <xe/gfx/Algorithm.hpp>
+#include <xe/sg/BVH.hpp>
+#include <xe/sg/RayPacket.hpp>
+#include <xe/sg/PacketIntersect.hpp>
 #include <xe/sg/Pipeline.hpp>
 
 using namespace xe::sg;
@@ -46,7 +58,7 @@ namespace xe { namespace gfx {
      * triangle conformed by the points P1, P2, P3.
      */
     inline Vector3f computeNormal(const Vector3f &p1, const Vector3f &p2, const Vector3f &p3) {
-		return normalize(cross(p2 - p1, p3 - p1));
+		return normalizeFast(cross(p2 - p1, p3 - p1));
     }
     
     /**
@@ -65,59 +77,106 @@ namespace xe { namespace gfx {
     }
     
     /**
-     * @brief Check if the specified ray intersects with the triangle defined by the points p1, p2, p3 and the normal n.
+     * @brief Ray data used by the watertight triangle test, computed once per ray.
+     *
+     * The ray is transformed so its direction becomes the positive Z axis, with a shear along
+     * the two other axes, given by the dominant direction axis (kz).
      */
-    inline bool intersectWithTriangle(const Vector3f &p1, const Vector3f &p2, const Vector3f &p3, const Vector3f &n, 
-                                      const Ray &ray, 
-                                      IntersectInfo *intersectInfo=nullptr) 
-	{
-        IntersectInfo info;
-       
-        if (Plane(p1, n).intersect(ray, &info) == false) {
-            if (intersectInfo != nullptr) {
-                intersectInfo->intersect = false;
+    struct WatertightRay {
+        Vector3f point;
+        int kx, ky, kz;
+        float sx, sy, sz;
+
+        explicit WatertightRay(const Ray &ray) {
+            const Vector3f direction = ray.getDirection();
+
+            this->point = ray.getPoint();
+
+            this->kz = 0;
+
+            for (int coord=1; coord<3; coord++) {
+                if (std::abs(direction[coord]) > std::abs(direction[this->kz])) {
+                    this->kz = coord;
+                }
             }
-            
+
+            this->kx = (this->kz + 1) % 3;
+            this->ky = (this->kx + 1) % 3;
+
+            // keep the winding of the triangles
+            if (direction[this->kz] < 0.0f) {
+                std::swap(this->kx, this->ky);
+            }
+
+            this->sx = direction[this->kx] / direction[this->kz];
+            this->sy = direction[this->ky] / direction[this->kz];
+            this->sz = 1.0f / direction[this->kz];
+        }
+    };
+
+    /**
+     * @brief Watertight ray - triangle intersection test (Woop, Benthin and Wald, 2013).
+     *
+     * The rays that pass exactly over a edge shared by two triangles hit at least one of them, 
+     * with no epsilon involved. Both sides of the triangle are reported, between the specified distances.
+     */
+    inline bool intersectWatertight(const WatertightRay &ray, const Vector3f &v0, const Vector3f &v1, const Vector3f &v2, float minDistance, float maxDistance, float *distance) {
+        const Vector3f a = v0 - ray.point;
+        const Vector3f b = v1 - ray.point;
+        const Vector3f c = v2 - ray.point;
+
+        const float ax = a[ray.kx] - ray.sx*a[ray.kz];
+        const float ay = a[ray.ky] - ray.sy*a[ray.kz];
+        const float bx = b[ray.kx] - ray.sx*b[ray.kz];
+        const float by = b[ray.ky] - ray.sy*b[ray.kz];
+        const float cx = c[ray.kx] - ray.sx*c[ray.kz];
+        const float cy = c[ray.ky] - ray.sy*c[ray.kz];
+
+        // scaled barycentric coordinates
+        float u = cx*by - cy*bx;
+        float v = ax*cy - ay*cx;
+        float w = bx*ay - by*ax;
+
+        // over a edge, fallback to double precision to get the sign right
+        if (u == 0.0f || v == 0.0f || w == 0.0f) {
+            u = static_cast<float>(static_cast<double>(cx)*by - static_cast<double>(cy)*bx);
+            v = static_cast<float>(static_cast<double>(ax)*cy - static_cast<double>(ay)*cx);
+            w = static_cast<float>(static_cast<double>(bx)*ay - static_cast<double>(by)*ax);
+        }
+
+        if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f)) {
             return false;
         }
-        
-        // Check triangle collision
-        Vector3f r0 = ray.getPointAt(info.distance);
-        Vector3f p = ray.getPoint(), q=r0;
-        Vector3f a = p1, b=p2, c=p3;
-        
-        Vector3f pq = (q - p);
-        Vector3f pa = (a - p);
-        Vector3f pb = (b - p);
-        Vector3f pc = (c - p);
-        
-        float u = dot(pq, pc, pb);
-        float v = dot(pq, pa, pc);
-        float w = dot(pq, pb, pa);
-        
-        // Check collision exists
-        if ((u > 0.0f && v > 0.0f && w > 0.0f) == true || (u < 0.0f && v < 0.0f && w < 0.0f) == true) {
-            if (intersectInfo != nullptr) {
-                intersectInfo->intersect = true;
-                intersectInfo->distance = info.distance;
-                intersectInfo->material = nullptr;
-                intersectInfo->normal = n;
-            }
-            
-            return true;
-        } else {
-            //! TODO: Check with a epsilon
+
+        float det = u + v + w;
+
+        if (det == 0.0f) {
             return false;
         }
+
+        float t = u*ray.sz*a[ray.kz] + v*ray.sz*b[ray.kz] + w*ray.sz*c[ray.kz];
+
+        if (det < 0.0f) {
+            det = -det;
+            t = -t;
+        }
+
+        if (t < minDistance*det || t >= maxDistance*det) {
+            return false;
+        }
+
+        *distance = t / det;
+
+        return true;
     }
-    
+
     inline int getTriangleCount(int vertexCount, Primitive::Enum trianglePrimitive) {
         assert(Primitive::isTriangle(trianglePrimitive));
         
         switch (trianglePrimitive) {
             case Primitive::TriangleStrip:
             case Primitive::TriangleFan:
-                return vertexCount - 2;
+                return vertexCount < 3 ? 0 : vertexCount - 2;
                 
             case Primitive::TriangleList:
                 return vertexCount / 3;
@@ -130,136 +189,443 @@ namespace xe { namespace gfx {
     
     inline int getVertexIndex_TriangleList(int triangleIndex, int pointIndex) {
         assert(pointIndex >= 0);
-        assert(pointIndex <= 3);
+        assert(pointIndex < 3);
         
         return triangleIndex*3 + pointIndex;
     }
     
     inline int getVertexIndex_TriangleStrip(int triangleIndex, int pointIndex) {
         assert(pointIndex >= 0);
-        assert(pointIndex <= 3);
+        assert(pointIndex < 3);
         
-        if (triangleIndex%2 == 0) {
-            return triangleIndex*3 + pointIndex;
+        // odd triangles swap their first two points, to keep the same winding
+        if (triangleIndex%2 == 0 || pointIndex == 2) {
+            return triangleIndex + pointIndex;
         } else {
-            // TODO: Correct this approach
-            switch (pointIndex) {
-                case 0: return triangleIndex;
-                case 1: return triangleIndex + 2;
-                case 2: return triangleIndex + 1;
-                default: assert(false); return 0;
-            }
+            return triangleIndex + (1 - pointIndex);
         }
     }
     
     inline int getVertexIndex_TriangleFan(int triangleIndex, int pointIndex) {
         assert(pointIndex >= 0);
-        assert(pointIndex <= 3);
+        assert(pointIndex < 3);
         
         if (pointIndex == 0) {
             return 0;
         } else {
-            switch (pointIndex) {
-                case 1: return triangleIndex + 2;
-                case 2: return triangleIndex + 1;
-                default: assert(false);
-            }
+            return triangleIndex + pointIndex;
+        }
+    }
+
+    inline int getVertexIndex(Primitive::Enum type, int triangleIndex, int pointIndex) {
+        switch (type) {
+            case Primitive::TriangleList:   return getVertexIndex_TriangleList(triangleIndex, pointIndex);
+            case Primitive::TriangleStrip:  return getVertexIndex_TriangleStrip(triangleIndex, pointIndex);
+            case Primitive::TriangleFan:    return getVertexIndex_TriangleFan(triangleIndex, pointIndex);
+            default: assert(false); return 0;
         }
-        
-        return triangleIndex*3 + pointIndex;
     }
 
     /**
-     * @brief Detect intersection between a Ray and a MeshPart.
+     * @brief Triangles stored as a structure of arrays: each coordinate of the vertices 
+     * and normals has its own stream, starting at a cache line.
      */
-    inline bool meshSubsetIntersect(MeshSubset *subset, const Ray &ray, IntersectInfo *intersectInfo=nullptr) {
-        if (Primitive::isTriangle(subset->getPrimitive()) == false) {
-            return false;
+    class TriangleArray {
+    public:
+        enum Stream {
+            V0X, V0Y, V0Z, 
+            V1X, V1Y, V1Z, 
+            V2X, V2Y, V2Z, 
+            NX, NY, NZ,
+            StreamCount
+        };
+
+        void resize(int count) {
+            // round each stream up to a whole number of cache lines
+            const int FloatsPerLine = 16;
+
+            this->count = count;
+            this->stride = (count + FloatsPerLine - 1) / FloatsPerLine * FloatsPerLine;
+            this->data.assign(StreamCount*this->stride, 0.0f);
         }
-        
-        Primitive::Enum type = subset->getPrimitive();
-        Buffer *vertexBuffer = subset->getBuffer(0);
-        
+
+        int getCount() const {
+            return this->count;
+        }
+
+        void set(int index, const Vector3f &v0, const Vector3f &v1, const Vector3f &v2, const Vector3f &normal) {
+            this->setVector(V0X, index, v0);
+            this->setVector(V1X, index, v1);
+            this->setVector(V2X, index, v2);
+            this->setVector(NX, index, normal);
+        }
+
+        Vector3f getVertex(int index, int vertex) const {
+            assert(vertex >= 0 && vertex < 3);
+
+            return this->getVector(static_cast<Stream>(V0X + 3*vertex), index);
+        }
+
+        Vector3f getNormal(int index) const {
+            return this->getVector(NX, index);
+        }
+
+    private:
+        void setVector(Stream stream, int index, const Vector3f &value) {
+            assert(index >= 0 && index < this->count);
+
+            for (int coord=0; coord<3; coord++) {
+                this->data[(stream + coord)*this->stride + index] = value[coord];
+            }
+        }
+
+        Vector3f getVector(Stream stream, int index) const {
+            assert(index >= 0 && index < this->count);
+
+            const float *base = &this->data[stream*this->stride + index];
+
+            return {base[0], base[this->stride], base[2*this->stride]};
+        }
+
+    private:
+        int count = 0;
+        int stride = 0;
+        AlignedVector<float> data;
+    };
+
+    /**
+     * @brief Triangle data of a MeshSubset, extracted from its buffers and indexed with a BVH, 
+     * so a ray can be tested against the subset without walking all of his triangles.
+     *
+     * The data is rebuilt when the version of the vertex or index buffers of the subset changes.
+     */
+    struct MeshSubsetCache {
+        TriangleArray triangles;
+
+        //! Hierarchy over the triangles.
+        BVH bvh;
+
+        //! Versions of the buffers the data was extracted from.
+        bool built = false;
+        std::uint32_t vertexVersion = 0;
+        std::uint32_t indexVersion = 0;
+
+        bool isOutdated(const MeshSubset *subset) const;
+
+        void build(const MeshSubset *subset);
+
+        bool intersect(const Ray &ray, IntersectInfo *intersectInfo) const;
+
+        bool occluded(const Ray &ray) const;
+
+        int intersect(RayPacket &packet, const PacketKernels &kernels, IntersectInfo *intersectInfos) const;
+    };
+
+    inline std::uint32_t getBufferVersion(const Buffer *buffer) {
+        return buffer ? buffer->getVersion() : 0;
+    }
+
+    inline const Buffer* getVertexBuffer(const MeshSubset *subset) {
+        return subset->getBufferCount() > 0 ? subset->getBuffer(0) : nullptr;
+    }
+
+    bool MeshSubsetCache::isOutdated(const MeshSubset *subset) const {
+        return !this->built 
+            || this->vertexVersion != getBufferVersion(getVertexBuffer(subset)) 
+            || this->indexVersion != getBufferVersion(subset->getIndexBuffer());
+    }
+
+    void MeshSubsetCache::build(const MeshSubset *subset) {
+        this->built = true;
+        this->vertexVersion = getBufferVersion(getVertexBuffer(subset));
+        this->indexVersion = getBufferVersion(subset->getIndexBuffer());
+
+        this->triangles.resize(0);
+
         const VertexFormat *vertexFormat = subset->getFormat();
+        const Buffer *vertexBuffer = getVertexBuffer(subset);
 
-		auto locker = vertexBuffer->getLocker<void>();
+        if (vertexFormat != nullptr && vertexFormat->packaging != VertexPackaging::SingleBuffer) {
+            EXENG_THROW_EXCEPTION("MeshSubsetCache::build: Only vertex data stored interleaved in a single buffer is supported.");
+        }
+
+        // subsets without triangles, or without their positions stored as three floats, can't be hit
+        const int vertexOffset = vertexFormat ? getVectorAttribOffset(vertexFormat, VertexAttrib::Position) : VertexFormat::InvalidOffset;
+
+        if (Primitive::isTriangle(subset->getPrimitive()) == false || vertexBuffer == nullptr || vertexOffset == VertexFormat::InvalidOffset) {
+            this->bvh.build(std::vector<Boxf>());
+            return;
+        }
+
+        const Primitive::Enum type = subset->getPrimitive();
+        const int vertexStride = vertexFormat->getSize();
+        const int vertexCount = static_cast<int>(vertexBuffer->getSize()) / vertexStride;
+
+        std::vector<std::uint8_t> vertexData(vertexBuffer->getSize());
+        vertexBuffer->read(vertexData.data(), static_cast<int>(vertexData.size()));
+
+        auto getPoint = [&](int index) -> Vector3f {
+            assert(index >= 0 && index < vertexCount);
+            return *reinterpret_cast<const Vector3f*>(&vertexData[index*vertexStride + vertexOffset]);
+        };
+
+        // read the indices, if any
+        const Buffer *indexBuffer = subset->getIndexBuffer();
+        const IndexFormat::Enum indexFormat = subset->getIndexFormat();
+
+        std::vector<int> indices;
+
+        if (indexBuffer != nullptr && indexFormat != IndexFormat::Unknown) {
+            const int indexSize = static_cast<int>(IndexFormat::getSize(indexFormat));
+            const int indexCount = static_cast<int>(indexBuffer->getSize()) / indexSize;
+
+            std::vector<std::uint8_t> indexData(indexBuffer->getSize());
+            indexBuffer->read(indexData.data(), static_cast<int>(indexData.size()));
+
+            indices.resize(indexCount);
+
+            for (int i=0; i<indexCount; i++) {
+                if (indexFormat == IndexFormat::Index16) {
+                    indices[i] = reinterpret_cast<const std::uint16_t*>(indexData.data())[i];
+                } else {
+                    indices[i] = static_cast<int>(reinterpret_cast<const std::uint32_t*>(indexData.data())[i]);
+                }
+            }
+        }
+
+        const int elementCount = indices.size() > 0 ? static_cast<int>(indices.size()) : vertexCount;
+        const int triangleCount = getTriangleCount(elementCount, type);
+
+        this->triangles.resize(triangleCount);
+
+        std::vector<Boxf> boxes;
+        boxes.reserve(triangleCount);
 
-        const void* vertexData = locker.getPointer();
-        
-        int vertexOffset = vertexFormat->getAttribOffset(VertexAttrib::Position);
-        int vertexStride = vertexFormat->getSize();
-        
-        // TODO: Handle properly the vertex format
-        IntersectInfo info;
-        
-        int triangleCount = getTriangleCount(vertexBuffer->getSize() / vertexFormat->getSize(), subset->getPrimitive());
-        
         for (int triangleIndex=0; triangleIndex<triangleCount; triangleIndex++) {
-            IntersectInfo localInfo;
-            
-            // Get the triangle points, based on the triangle type and the vertex format
-            int i1, i2, i3;
-            
-            switch (type) {
-                case Primitive::TriangleList:
-                    i1 = getVertexIndex_TriangleList(triangleIndex, 0);
-                    i2 = getVertexIndex_TriangleList(triangleIndex, 1);
-                    i3 = getVertexIndex_TriangleList(triangleIndex, 2);
-                    break;
-                    
-                case Primitive::TriangleStrip:
-                    i1 = getVertexIndex_TriangleStrip(triangleIndex, 0);
-                    i2 = getVertexIndex_TriangleStrip(triangleIndex, 1);
-                    i3 = getVertexIndex_TriangleStrip(triangleIndex, 2);
-                    break;
-                    
-                case Primitive::TriangleFan:
-                    i1 = getVertexIndex_TriangleFan(triangleIndex, 0);
-                    i2 = getVertexIndex_TriangleFan(triangleIndex, 1);
-                    i3 = getVertexIndex_TriangleFan(triangleIndex, 2);
-                    break;
-                    
-                default: assert(false);
+            Vector3f p[3];
+
+            for (int point=0; point<3; point++) {
+                int index = getVertexIndex(type, triangleIndex, point);
+
+                if (indices.size() > 0) {
+                    index = indices[index];
+                }
+
+                p[point] = getPoint(index);
             }
-            
+
+            Boxf box;
+            box.expand(p[0]);
+            box.expand(p[1]);
+            box.expand(p[2]);
+
             // TODO: Get the normal vector from the mesh data, if exists.
-            const Vector3f &p1 = *reinterpret_cast<const Vector3f*>(static_cast<const float*>(vertexData) + i1*vertexStride + vertexOffset);
-            const Vector3f &p2 = *reinterpret_cast<const Vector3f*>(static_cast<const float*>(vertexData) + i2*vertexStride + vertexOffset);
-            const Vector3f &p3 = *reinterpret_cast<const Vector3f*>(static_cast<const float*>(vertexData) + i3*vertexStride + vertexOffset);
-            
-            Vector3f n = computeNormal(p1, p2, p3);
-            
-            if (intersectWithTriangle(p1, p2, p3, n, ray, &localInfo) && localInfo.distance >= 0.0f ) {
-                localInfo.material = subset->getMaterial();
-                if (localInfo.distance > info.distance) {
-                    info = localInfo;
-                }
+            this->triangles.set(triangleIndex, p[0], p[1], p[2], computeNormal(p[0], p[1], p[2]));
+
+            boxes.push_back(box);
+        }
+
+        this->bvh.build(boxes);
+    }
+
+    bool MeshSubsetCache::intersect(const Ray &ray, IntersectInfo *intersectInfo) const {
+        const WatertightRay watertightRay(ray);
+
+        int closest = -1;
+        Ray segment = ray;
+
+        this->bvh.traverse(segment, [&](int triangleIndex, Ray &current) {
+            float distance = 0.0f;
+
+            const Vector3f v0 = this->triangles.getVertex(triangleIndex, 0);
+            const Vector3f v1 = this->triangles.getVertex(triangleIndex, 1);
+            const Vector3f v2 = this->triangles.getVertex(triangleIndex, 2);
+
+            if (!intersectWatertight(watertightRay, v0, v1, v2, current.getMinDistance(), current.getMaxDistance(), &distance)) {
+                return false;
             }
+
+            current.clip(distance);
+            closest = triangleIndex;
+
+            return true;
+        });
+
+        // the remaining attributes are computed only for the closest hit
+        IntersectInfo info;
+
+        if (closest != -1) {
+            const float closestDistance = segment.getMaxDistance();
+
+            info.intersect = true;
+            info.distance = closestDistance;
+            info.normal = this->triangles.getNormal(closest);
+            info.point = ray.getPointAt(closestDistance);
         }
-        
+
         if (intersectInfo) {
             *intersectInfo = info;
         }
-        
+
         return info.intersect;
     }
+
+    bool MeshSubsetCache::occluded(const Ray &ray) const {
+        const WatertightRay watertightRay(ray);
+
+        return this->bvh.traverseAny(ray, [&](int triangleIndex) {
+            float distance = 0.0f;
+
+            const Vector3f v0 = this->triangles.getVertex(triangleIndex, 0);
+            const Vector3f v1 = this->triangles.getVertex(triangleIndex, 1);
+            const Vector3f v2 = this->triangles.getVertex(triangleIndex, 2);
+
+            return intersectWatertight(watertightRay, v0, v1, v2, ray.getMinDistance(), ray.getMaxDistance(), &distance);
+        });
+    }
+
+    int MeshSubsetCache::intersect(RayPacket &packet, const PacketKernels &kernels, IntersectInfo *intersectInfos) const {
+        return this->bvh.traverse(packet, kernels, [&](int triangleIndex, RayPacket &rays) {
+            const Vector3f v0 = this->triangles.getVertex(triangleIndex, 0);
+            const Vector3f v1 = this->triangles.getVertex(triangleIndex, 1);
+            const Vector3f v2 = this->triangles.getVertex(triangleIndex, 2);
+
+            // the edges are cheap to compute compared to the test of eight rays
+            const int mask = kernels.intersectTriangle(rays, v0, v1 - v0, v2 - v0);
+
+            for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+                if (mask & (1 << lane)) {
+                    IntersectInfo &info = intersectInfos[lane];
+
+                    info.intersect = true;
+                    info.distance = rays.maxDistance[lane];
+                    info.normal = this->triangles.getNormal(triangleIndex);
+                    info.point = rays.getPointAt(lane, info.distance);
+                    info.material = nullptr;
+                }
+            }
+
+            return mask;
+        });
+    }
 }}
 
 /*
  * Mesh implementation
  */
 namespace xe { namespace gfx {
+    /**
+     * @brief Bounding box of a subset, and the version of the vertex buffer it was computed from.
+     */
+    struct MeshSubsetBox {
+        Boxf box;
+        bool computed = false;
+        std::uint32_t vertexVersion = 0;
+    };
+
     struct Mesh::Private {
         MeshSubsetVector    subsets;    //! Vector of MeshPart pointers
         Boxf                box;        //! Mesh collision box.
+
+        //! Bounds of each subset. Cheaper to keep up to date than the caches, so they are computed on their own.
+        std::vector<MeshSubsetBox> subsetBoxes;
+        std::mutex boxesMutex;
+
+        /**
+         * @brief Recompute the boxes of the subsets whose vertices have been written since the last call. 
+         *
+         * Only the buffer versions are compared when nothing has changed.
+         */
+        void updateBoxes() {
+            std::lock_guard<std::mutex> lock(this->boxesMutex);
+
+            bool changed = this->subsetBoxes.size() != this->subsets.size();
+
+            this->subsetBoxes.resize(this->subsets.size());
+
+            for (std::size_t i=0; i<this->subsets.size(); i++) {
+                MeshSubsetBox &subsetBox = this->subsetBoxes[i];
+                const MeshSubset *subset = this->subsets[i].get();
+                const std::uint32_t vertexVersion = getBufferVersion(getVertexBuffer(subset));
+
+                if (!subsetBox.computed || subsetBox.vertexVersion != vertexVersion) {
+                    subsetBox.box = computeBox(subset);
+                    subsetBox.computed = true;
+                    subsetBox.vertexVersion = vertexVersion;
+
+                    changed = true;
+                }
+            }
+
+            if (!changed) {
+                return;
+            }
+
+            this->box = Boxf();
+
+            for (const MeshSubsetBox &subsetBox : this->subsetBoxes) {
+                if (subsetBox.box.isValid()) {
+                    this->box.expand(subsetBox.box);
+                }
+            }
+        }
+
+        //! Acceleration data for each subset, built on the first query, and rebuilt when the subset buffers change.
+        std::vector<MeshSubsetCache> caches;
+        std::mutex cachesMutex;
+        std::atomic<bool> cachesReady = {false};
+
+        bool isOutdated() const {
+            if (this->caches.size() != this->subsets.size()) {
+                return true;
+            }
+
+            for (std::size_t i=0; i<this->subsets.size(); i++) {
+                if (this->caches[i].isOutdated(this->subsets[i].get())) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Rebuilds the outdated caches. 
+         *
+         * The subset buffers must not be modified while the mesh is being queried from other threads.
+         */
+        void buildCaches() {
+            if (this->cachesReady && !this->isOutdated()) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(this->cachesMutex);
+
+            if (this->cachesReady && !this->isOutdated()) {
+                return;
+            }
+
+            this->cachesReady = false;
+            this->caches.resize(this->subsets.size());
+
+            for (std::size_t i=0; i<this->subsets.size(); i++) {
+                if (this->caches[i].isOutdated(this->subsets[i].get())) {
+                    this->caches[i].build(this->subsets[i].get());
+                }
+            }
+
+            this->cachesReady = true;
+        }
     };
     
     Mesh::Mesh(std::unique_ptr<xe::gfx::MeshSubset> subset) : impl(new Mesh::Private()) {
         this->impl->subsets.push_back(std::move(subset));
+        this->impl->updateBoxes();
     }
 
     Mesh::Mesh(std::vector<std::unique_ptr<xe::gfx::MeshSubset>> subsets) : impl(new Mesh::Private()) {
         this->impl->subsets = std::move(subsets);
+        this->impl->updateBoxes();
     }
     
     Mesh::~Mesh() {
@@ -269,30 +635,48 @@ namespace xe { namespace gfx {
     Boxf Mesh::getBox() const {
         assert(this->impl != nullptr);
         
-        /*
-        MeshParVector &parts = this->impl->parts;
-        Boxf box = parts[0].getBox();
-    
-        for(MeshPart &part : parts) {
-            box.expand(part. );
+        this->impl->updateBoxes();
+
+        return this->impl->box;
+    }
+
+    std::uint32_t Mesh::getVersion() const {
+        assert(this->impl != nullptr);
+
+        std::uint32_t version = 0;
+
+        for (const auto &subset : this->impl->subsets) {
+            version += getBufferVersion(getVertexBuffer(subset.get()));
         }
-        
-        return box;
-        */
-        
-        return Boxf();
+
+        return version;
+    }
+
+    Boxf Mesh::getSubsetBox(int index) const {
+        assert(this->impl != nullptr);
+        assert(index >= 0 && index < this->getSubsetCount());
+
+        this->impl->updateBoxes();
+
+        return this->impl->subsetBoxes[index].box;
     }
     
     bool Mesh::hit(const Ray &ray, IntersectInfo *intersectInfo) {
         assert(this->impl != nullptr);
         
+        this->impl->buildCaches();
+
 		IntersectInfo info = {}, bestInfo = {};
         
-        for (auto &subset : this->impl->subsets) {
-            if (meshSubsetIntersect(subset.get(), ray, &info) && info.distance >= 0.0f ) {
-                if (info.distance > bestInfo.distance) {
-                    bestInfo = info;
-                }
+        // the next subsets only look for closer hits
+        Ray segment = ray;
+        
+        for (std::size_t i=0; i<this->impl->subsets.size(); i++) {
+            if (this->impl->caches[i].intersect(segment, &info)) {
+                segment.clip(info.distance);
+                
+                bestInfo = info;
+                bestInfo.material = this->impl->subsets[i]->getMaterial();
             }
         }
         
@@ -303,6 +687,46 @@ namespace xe { namespace gfx {
         return bestInfo.intersect;
     }
     
+    bool Mesh::occluded(const Ray &ray) {
+        assert(this->impl != nullptr);
+        
+        this->impl->buildCaches();
+        
+        for (const MeshSubsetCache &cache : this->impl->caches) {
+            if (cache.occluded(ray)) {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    int Mesh::hitPacket(RayPacket &packet, IntersectInfo *intersectInfos) {
+        assert(this->impl != nullptr);
+        assert(intersectInfos != nullptr);
+        
+        this->impl->buildCaches();
+        
+        const PacketKernels &kernels = getPacketKernels();
+        
+        int mask = 0;
+        
+        // the maximum distances of the packet are shared, so each subset only reports the hits closer than the previous ones
+        for (std::size_t i=0; i<this->impl->subsets.size(); i++) {
+            const int subsetMask = this->impl->caches[i].intersect(packet, kernels, intersectInfos);
+            
+            for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+                if (subsetMask & (1 << lane)) {
+                    intersectInfos[lane].material = this->impl->subsets[i]->getMaterial();
+                }
+            }
+            
+            mask |= subsetMask;
+        }
+        
+        return mask;
+    }
+    
     int Mesh::getSubsetCount() const {
         assert(this->impl != nullptr);
         return static_cast<int>(this->impl->subsets.size());
@@ -35,15 +35,39 @@ namespace xe { namespace gfx {
         virtual ~Mesh();
         
         /**
-         * @brief Computes and returns the corresponding bounding box of the mesh.
+         * @brief Get the bounding box of the vertices of all the subsets.
+         *
+         * The boxes are computed on construction, and again only for the subsets whose vertex buffer has 
+         * been written since, so this is cheap to call every frame.
          */
         virtual Boxf getBox() const override;
+
+        /**
+         * @brief Get the bounding box of the vertices of a subset, kept up to date like getBox.
+         */
+        Boxf getSubsetBox(int index) const;
+
+        /**
+         * @brief Get the sum of the versions of the vertex buffers of the subsets, that changes with each write to them.
+         */
+        virtual std::uint32_t getVersion() const override;
         
         /**
-         * @brief Checks if the specified ray intersects with the Mesh.
+         * @brief Checks if the specified ray intersects with the Mesh, reporting the closest intersection.
          */
         virtual bool hit(const xe::sg::Ray &ray, xe::sg::IntersectInfo *intersectInfo) override;
         
+        /**
+         * @brief Checks if the specified ray intersects with any triangle of the Mesh, between its minimum and maximum distances.
+         */
+        virtual bool occluded(const xe::sg::Ray &ray) override;
+        
+        /**
+         * @brief Checks the intersections of a packet of coherent rays with the Mesh, using the SIMD kernels 
+         * supported by the CPU.
+         */
+        virtual int hitPacket(xe::sg::RayPacket &packet, xe::sg::IntersectInfo *intersectInfos) override;
+        
         /**
          * @brief Get the numbers of MeshParts on the Mesh.
          */
@@ -129,14 +129,14 @@ namespace xe { namespace gfx {
 		};
 
 		// Generate the rest of the cube using the first face
-		Rotation rotation[] = {
-			{rad(  0.0f), {0.0f, 1.0f, 0.0}},
-			{rad( 90.0f), {0.0f, 1.0f, 0.0}},
-			{rad(180.0f), {0.0f, 1.0f, 0.0}},
-			{rad(270.0f), {0.0f, 1.0f, 0.0}},
-
-			{rad( 90.0f), {1.0f, 0.0f, 0.0}},
-			{rad(-90.0f), {1.0f, 0.0f, 0.0}}
+		static constexpr Rotation rotation[] = {
+			{rad(  0.0f), {0.0f, 1.0f, 0.0f}},
+			{rad( 90.0f), {0.0f, 1.0f, 0.0f}},
+			{rad(180.0f), {0.0f, 1.0f, 0.0f}},
+			{rad(270.0f), {0.0f, 1.0f, 0.0f}},
+
+			{rad( 90.0f), {1.0f, 0.0f, 0.0f}},
+			{rad(-90.0f), {1.0f, 0.0f, 0.0f}}
 		};
 		
 		for (int i=0; i<FACE_COUNT; i++) {
@@ -0,0 +1,268 @@
+/**
+ * @file BVH.cpp
+ * @brief Bounding Volume Hierarchy construction.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/BVH.hpp>
+
+#include <array>
+#include <cassert>
+
+namespace xe { namespace sg {
+
+    //! Number of bins evaluated per axis by the Surface Area Heuristic.
+    static const int BinCount = 12;
+
+    //! Beyond this depth, the primitives are split at the median, to bound the traversal stack.
+    static const int MaxSAHDepth = 64;
+
+    //! Leafs can hold up to this multiple of the requested leaf size, when splitting them is not worth.
+    static const int MaxLeafFactor = 4;
+
+    //! Cost of a ray-box test, relative to the cost of a primitive test.
+    static const float TraversalCost = 1.0f;
+
+    inline float surfaceArea(const Boxf &box) {
+        if (!box.isValid()) {
+            return 0.0f;
+        }
+
+        const Vector3f size = box.getSize();
+
+        return 2.0f * (size.x*size.y + size.y*size.z + size.z*size.x);
+    }
+
+    BVH::BVH() {}
+
+    BVH::BVH(const std::vector<Boxf> &boxes, int leafSize) {
+        this->build(boxes, leafSize);
+    }
+
+    void BVH::build(const std::vector<Boxf> &boxes, int leafSize) {
+        assert(leafSize > 0);
+
+        this->nodes.clear();
+        this->indices.clear();
+
+        if (boxes.size() == 0) {
+            return;
+        }
+
+        const int count = static_cast<int>(boxes.size());
+
+        std::vector<Vector3f> centers(count);
+
+        this->indices.resize(count);
+        for (int i=0; i<count; i++) {
+            this->indices[i] = i;
+            centers[i] = boxes[i].getCenter();
+        }
+
+        this->nodes.reserve(2*count);
+        this->buildNode(boxes, centers, 0, count, 0, leafSize);
+    }
+
+    int BVH::buildNode(const std::vector<Boxf> &boxes, const std::vector<Vector3f> &centers, int begin, int end, int depth, int leafSize) {
+        const int nodeIndex = static_cast<int>(this->nodes.size());
+        this->nodes.emplace_back();
+
+        const int count = end - begin;
+
+        Boxf box, centerBox;
+        for (int i=begin; i<end; i++) {
+            box.expand(boxes[this->indices[i]]);
+            centerBox.expand(centers[this->indices[i]]);
+        }
+
+        this->nodes[nodeIndex].box = box;
+
+        auto makeLeaf = [&]() {
+            this->nodes[nodeIndex].offset = begin;
+            this->nodes[nodeIndex].count = count;
+
+            return nodeIndex;
+        };
+
+        if (count <= leafSize) {
+            return makeLeaf();
+        }
+
+        const Vector3f centerMin = centerBox.getMinEdge();
+        const Vector3f centerSize = centerBox.getSize();
+
+        // pick the axis with the largest centroid extent for the fallback split
+        int splitAxis = 0;
+        for (int axis=1; axis<3; axis++) {
+            if (centerSize[axis] > centerSize[splitAxis]) {
+                splitAxis = axis;
+            }
+        }
+
+        if (centerSize[splitAxis] <= 0.0f) {
+            // all the centroids are on the same point, and can't be separated.
+            return makeLeaf();
+        }
+
+        int mid = begin + count/2;
+
+        if (depth < MaxSAHDepth) {
+            // evaluate the SAH for the bin boundaries of the three axes
+            struct Bin {
+                Boxf box;
+                int count = 0;
+            };
+
+            float bestCost = std::numeric_limits<float>::max();
+            int bestAxis = -1;
+            int bestSplit = 0;
+
+            for (int axis=0; axis<3; axis++) {
+                if (centerSize[axis] <= 0.0f) {
+                    continue;
+                }
+
+                std::array<Bin, BinCount> bins;
+                const float scale = BinCount / centerSize[axis];
+
+                for (int i=begin; i<end; i++) {
+                    const int primitive = this->indices[i];
+                    const int binIndex = std::min(BinCount - 1, static_cast<int>((centers[primitive][axis] - centerMin[axis]) * scale));
+
+                    bins[binIndex].count++;
+                    bins[binIndex].box.expand(boxes[primitive]);
+                }
+
+                // sweep from the right, to know the area and count of the right side of each split
+                std::array<float, BinCount> rightAreas;
+                std::array<int, BinCount> rightCounts;
+
+                Boxf rightBox;
+                int rightCount = 0;
+
+                for (int i=BinCount - 1; i>0; i--) {
+                    rightCount += bins[i].count;
+                    if (bins[i].count > 0) {
+                        rightBox.expand(bins[i].box);
+                    }
+
+                    rightAreas[i] = surfaceArea(rightBox);
+                    rightCounts[i] = rightCount;
+                }
+
+                Boxf leftBox;
+                int leftCount = 0;
+
+                for (int i=1; i<BinCount; i++) {
+                    leftCount += bins[i - 1].count;
+                    if (bins[i - 1].count > 0) {
+                        leftBox.expand(bins[i - 1].box);
+                    }
+
+                    if (leftCount == 0 || rightCounts[i] == 0) {
+                        continue;
+                    }
+
+                    const float cost = leftCount*surfaceArea(leftBox) + rightCounts[i]*rightAreas[i];
+
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = i;
+                    }
+                }
+            }
+
+            const float leafCost = static_cast<float>(count);
+            const float splitCost = TraversalCost + bestCost / surfaceArea(box);
+
+            if (bestAxis == -1) {
+                return makeLeaf();
+            }
+
+            if (splitCost >= leafCost && count <= MaxLeafFactor*leafSize) {
+                return makeLeaf();
+            }
+
+            const float scale = BinCount / centerSize[bestAxis];
+
+            auto first = this->indices.begin() + begin;
+            auto last = this->indices.begin() + end;
+
+            auto middle = std::partition(first, last, [&](int primitive) {
+                const int binIndex = std::min(BinCount - 1, static_cast<int>((centers[primitive][bestAxis] - centerMin[bestAxis]) * scale));
+                return binIndex < bestSplit;
+            });
+
+            mid = static_cast<int>(middle - this->indices.begin());
+        } else {
+            // too deep: split at the object median
+            auto first = this->indices.begin() + begin;
+            auto last = this->indices.begin() + end;
+
+            std::nth_element(first, first + count/2, last, [&](int a, int b) {
+                return centers[a][splitAxis] < centers[b][splitAxis];
+            });
+        }
+
+        assert(mid > begin && mid < end);
+
+        this->buildNode(boxes, centers, begin, mid, depth + 1, leafSize);
+
+        const int right = this->buildNode(boxes, centers, mid, end, depth + 1, leafSize);
+
+        this->nodes[nodeIndex].offset = right;
+        this->nodes[nodeIndex].count = 0;
+
+        return nodeIndex;
+    }
+
+    void BVH::refit(const std::vector<Boxf> &boxes) {
+        assert(boxes.size() == this->indices.size());
+
+        // the children are always stored after their parent, so a reverse walk visits them first
+        for (int nodeIndex=static_cast<int>(this->nodes.size()) - 1; nodeIndex>=0; nodeIndex--) {
+            BVHNode &node = this->nodes[nodeIndex];
+
+            Boxf box;
+
+            if (node.isLeaf()) {
+                for (int i=node.offset; i<node.offset + node.count; i++) {
+                    box.expand(boxes[this->indices[i]]);
+                }
+            } else {
+                box.expand(this->nodes[nodeIndex + 1].box);
+                box.expand(this->nodes[node.offset].box);
+            }
+
+            node.box = box;
+        }
+    }
+
+    bool BVH::isEmpty() const {
+        return this->nodes.size() == 0;
+    }
+
+    Boxf BVH::getBox() const {
+        if (this->nodes.size() == 0) {
+            return Boxf();
+        }
+
+        return this->nodes[0].box;
+    }
+
+    const std::vector<BVHNode>& BVH::getNodes() const {
+        return this->nodes;
+    }
+
+    const std::vector<int>& BVH::getIndices() const {
+        return this->indices;
+    }
+}}
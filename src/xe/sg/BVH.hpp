@@ -0,0 +1,312 @@
+/**
+ * @file BVH.hpp
+ * @brief Bounding Volume Hierarchy class definition.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_BVH_HPP__
+#define __EXENG_SCENEGRAPH_BVH_HPP__
+
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <xe/Config.hpp>
+#include <xe/Boundary.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/RayPacket.hpp>
+#include <xe/sg/PacketIntersect.hpp>
+#include <xe/sg/SlabIntersect.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Node of a BVH, stored in depth-first order.
+     *
+     * The left child of a inner node is always the next node in the array, so only
+     * the index of the right child is stored.
+     */
+    struct BVHNode {
+        //! Bounding box of all the primitives under the node.
+        xe::Boxf box;
+
+        //! For leafs, index of the first primitive. For inner nodes, index of the right child.
+        int offset = 0;
+
+        //! Primitive count of the leaf. Zero for inner nodes.
+        int count = 0;
+
+        bool isLeaf() const {
+            return count > 0;
+        }
+    };
+
+    /**
+     * @brief Bounding Volume Hierarchy over a set of primitives, built from their bounding boxes.
+     *
+     * The tree is built top-down using the Surface Area Heuristic, evaluated over a fixed
+     * number of bins per axis. The primitives themselves are not stored: the leafs reference
+     * the primitive indices supplied in the build, via the getIndices() array.
+     */
+    class EXENGAPI BVH {
+    public:
+        BVH();
+
+        /**
+         * @brief Build the hierarchy from the bounding boxes of the primitives.
+         */
+        explicit BVH(const std::vector<xe::Boxf> &boxes, int leafSize=4);
+
+        /**
+         * @brief Discards the current hierarchy, and build a new one from the bounding boxes of the primitives.
+         */
+        void build(const std::vector<xe::Boxf> &boxes, int leafSize=4);
+
+        /**
+         * @brief Recomputes the bounding boxes of the nodes from the new bounding boxes of the primitives,
+         * keeping the current topology.
+         *
+         * Useful when the primitives have moved, but they are still the same. The quality of the 
+         * hierarchy degrades as the primitives move away from their original positions.
+         */
+        void refit(const std::vector<xe::Boxf> &boxes);
+
+        /**
+         * @brief Check if the hierarchy doesn't have any primitive.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Get the bounding box of the whole hierarchy.
+         */
+        xe::Boxf getBox() const;
+
+        /**
+         * @brief Get the nodes of the hierarchy, in depth-first order.
+         */
+        const std::vector<BVHNode>& getNodes() const;
+
+        /**
+         * @brief Get the primitive indices referenced by the leaf nodes.
+         */
+        const std::vector<int>& getIndices() const;
+
+        /**
+         * @brief Traverse the hierarchy in front-to-back order, calling the visitor for each primitive
+         * whose leaf is reached by the ray, between its minimum and maximum distances.
+         *
+         * The visitor has the signature bool (int primitiveIndex, Ray &ray). It must return true 
+         * when the primitive was hit, and clip the ray to the hit distance, so farther subtrees 
+         * are culled from the traversal.
+         */
+        template<typename Visitor>
+        bool traverse(Ray &ray, Visitor visitor) const;
+
+        /**
+         * @brief Traverse the hierarchy until some primitive is hit, between the minimum and maximum 
+         * distances of the ray.
+         *
+         * The visitor has the signature bool (int primitiveIndex), and must return true when the primitive was hit.
+         * The first hit ends the traversal, so the nodes aren't sorted by distance.
+         */
+        template<typename Visitor>
+        bool traverseAny(const Ray &ray, Visitor visitor) const;
+
+        /**
+         * @brief Traverse the hierarchy with all the rays of a packet at once. A node is visited when
+         * at least one of the rays hits its box, before its current maximum distance.
+         *
+         * The visitor has the signature int (int primitiveIndex, RayPacket &packet). It must return
+         * the mask of the lanes that hit the primitive, and shrink their maximum distances.
+         * @return The mask of the lanes that hit some primitive.
+         */
+        template<typename Visitor>
+        int traverse(RayPacket &packet, const PacketKernels &kernels, Visitor visitor) const;
+
+    private:
+        int buildNode(const std::vector<xe::Boxf> &boxes, const std::vector<xe::Vector3f> &centers, int begin, int end, int depth, int leafSize);
+
+    private:
+        std::vector<BVHNode> nodes;
+        std::vector<int> indices;
+    };
+}}
+
+namespace xe { namespace sg {
+    template<typename Visitor>
+    inline bool BVH::traverse(Ray &ray, Visitor visitor) const {
+        if (this->nodes.size() == 0) {
+            return false;
+        }
+
+        struct StackEntry {
+            int node;
+            float distance;
+        };
+
+        const int StackSize = 128;
+        StackEntry stack[StackSize];
+        int top = 0;
+
+        bool hit = false;
+        float distance = 0.0f;
+
+        if (!intersectSlab(ray, this->nodes[0].box, &distance)) {
+            return false;
+        }
+
+        stack[top++] = {0, distance};
+
+        while (top > 0) {
+            const StackEntry entry = stack[--top];
+
+            // a closer hit was found after the node was pushed
+            if (entry.distance > ray.getMaxDistance()) {
+                continue;
+            }
+
+            const BVHNode &node = this->nodes[entry.node];
+
+            if (node.isLeaf()) {
+                for (int i=node.offset; i<node.offset + node.count; ++i) {
+                    if (visitor(this->indices[i], ray)) {
+                        hit = true;
+                    }
+                }
+
+                continue;
+            }
+
+            // visit the nearest child first
+            const int left = entry.node + 1;
+            const int right = node.offset;
+
+            float leftDistance = 0.0f, rightDistance = 0.0f;
+
+            const bool leftHit = intersectSlab(ray, this->nodes[left].box, &leftDistance);
+            const bool rightHit = intersectSlab(ray, this->nodes[right].box, &rightDistance);
+
+            assert(top + 2 <= StackSize);
+
+            if (leftHit && rightHit) {
+                if (leftDistance < rightDistance) {
+                    stack[top++] = {right, rightDistance};
+                    stack[top++] = {left, leftDistance};
+                } else {
+                    stack[top++] = {left, leftDistance};
+                    stack[top++] = {right, rightDistance};
+                }
+            } else if (leftHit) {
+                stack[top++] = {left, leftDistance};
+            } else if (rightHit) {
+                stack[top++] = {right, rightDistance};
+            }
+        }
+
+        return hit;
+    }
+
+    template<typename Visitor>
+    inline bool BVH::traverseAny(const Ray &ray, Visitor visitor) const {
+        if (this->nodes.size() == 0) {
+            return false;
+        }
+
+        const int StackSize = 128;
+        int stack[StackSize];
+        int top = 0;
+
+        float distance = 0.0f;
+
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const int index = stack[--top];
+            const BVHNode &node = this->nodes[index];
+
+            if (!intersectSlab(ray, node.box, &distance)) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                for (int i=node.offset; i<node.offset + node.count; ++i) {
+                    if (visitor(this->indices[i])) {
+                        return true;
+                    }
+                }
+
+                continue;
+            }
+
+            assert(top + 2 <= StackSize);
+
+            stack[top++] = node.offset;
+            stack[top++] = index + 1;
+        }
+
+        return false;
+    }
+
+    template<typename Visitor>
+    inline int BVH::traverse(RayPacket &packet, const PacketKernels &kernels, Visitor visitor) const {
+        if (this->nodes.size() == 0) {
+            return 0;
+        }
+
+        // the children are visited in the order given by the direction of the first ray
+        const xe::Vector3f direction = packet.getDirection(0);
+
+        const int StackSize = 128;
+        int stack[StackSize];
+        int top = 0;
+
+        int mask = 0;
+
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const int index = stack[--top];
+            const BVHNode &node = this->nodes[index];
+
+            // the box is tested when the node is popped, so the hits found meanwhile can cull it
+            if (kernels.intersectBox(packet, node.box) == 0) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                for (int i=node.offset; i<node.offset + node.count; ++i) {
+                    mask |= visitor(this->indices[i], packet);
+                }
+
+                continue;
+            }
+
+            const int left = index + 1;
+            const int right = node.offset;
+
+            const xe::Vector3f offset = this->nodes[right].box.getCenter() - this->nodes[left].box.getCenter();
+
+            assert(top + 2 <= StackSize);
+
+            if (dot(offset, direction) > 0.0f) {
+                stack[top++] = right;
+                stack[top++] = left;
+            } else {
+                stack[top++] = left;
+                stack[top++] = right;
+            }
+        }
+
+        return mask;
+    }
+}}
+
+#endif  //__EXENG_SCENEGRAPH_BVH_HPP__
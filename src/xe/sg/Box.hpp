@@ -3,6 +3,7 @@
 #define __EXENG_SCENEGRAPH_BOX_HPP__
 
 #include <xe/Boundary.hpp>
+#include <xe/sg/Sphere.hpp>
 
 namespace xe { namespace sg {
     template<typename OtherSolid>
@@ -10,6 +11,8 @@ namespace xe { namespace sg {
     
     xe::Boxf box(const xe::Boxf &solid);
 
+    xe::Boxf box(const Sphere &solid);
+
 	template<typename OtherSolid>
     inline xe::Boxf box(const OtherSolid &solid) {
         return xe::Boxf();
@@ -19,6 +22,16 @@ namespace xe { namespace sg {
         return solid;
     }
 
+    inline xe::Boxf box(const Sphere &solid) {
+        const xe::Vector3f radius(solid.getRadius());
+
+        xe::Boxf result;
+        result.expand(solid.getCenter() - radius);
+        result.expand(solid.getCenter() + radius);
+
+        return result;
+    }
+
 }}
 
 #endif  
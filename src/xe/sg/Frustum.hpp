@@ -0,0 +1,125 @@
+/**
+ * @file Frustum.hpp
+ * @brief View frustum, used to discard the geometry out of the sight of a camera.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_FRUSTUM_HPP__
+#define __EXENG_SCENEGRAPH_FRUSTUM_HPP__
+
+#include <xe/Enum.hpp>
+#include <xe/Vector.hpp>
+#include <xe/Matrix.hpp>
+#include <xe/Boundary.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Result of a test between a volume and a frustum.
+     */
+    struct FrustumTest : public Enum {
+        enum Enum {
+            Outside,        //! Completely out of the frustum.
+            Intersect,      //! Partially inside.
+            Inside          //! Completely inside, so all the volumes contained in it are inside too.
+        };
+    };
+
+    /**
+     * @brief The six planes that bound the volume seen by a camera, in world space.
+     */
+    class Frustum {
+    public:
+        enum { PlaneCount = 6 };
+
+        /**
+         * @brief Initialize a frustum that contains the whole space.
+         */
+        Frustum() {
+            for (int i=0; i<PlaneCount; i++) {
+                this->planes[i] = {0.0f, 0.0f, 0.0f, 1.0f};
+            }
+        }
+
+        /**
+         * @brief Extract the planes from a view-projection matrix (proj * view).
+         *
+         * A point is inside of the clip volume when -w <= x, y, z <= w, so each plane is the last row of
+         * the matrix plus or minus one of the others. The planes point to the inside.
+         */
+        explicit Frustum(const xe::Matrix4f &viewProj) {
+            for (int i=0; i<3; i++) {
+                for (int j=0; j<4; j++) {
+                    this->planes[2*i + 0][j] = viewProj(3, j) + viewProj(i, j);
+                    this->planes[2*i + 1][j] = viewProj(3, j) - viewProj(i, j);
+                }
+            }
+        }
+
+        /**
+         * @brief Test a box against the planes.
+         *
+         * For each plane only the corners of the box farthest along the normal and against it are
+         * checked. Invalid boxes are always outside.
+         */
+        FrustumTest::Enum test(const xe::Boxf &box) const {
+            if (!box.isValid()) {
+                return FrustumTest::Outside;
+            }
+
+            const xe::Vector3f edges[2] = {box.getMinEdge(), box.getMaxEdge()};
+
+            FrustumTest::Enum result = FrustumTest::Inside;
+
+            for (int i=0; i<PlaneCount; i++) {
+                const xe::Vector4f &plane = this->planes[i];
+
+                float farthest = plane.w, nearest = plane.w;
+
+                for (int coord=0; coord<3; coord++) {
+                    const int side = plane[coord] >= 0.0f ? 1 : 0;
+
+                    farthest += plane[coord] * edges[side][coord];
+                    nearest += plane[coord] * edges[1 - side][coord];
+                }
+
+                if (farthest < 0.0f) {
+                    return FrustumTest::Outside;
+                }
+
+                if (nearest < 0.0f) {
+                    result = FrustumTest::Intersect;
+                }
+            }
+
+            return result;
+        }
+
+        bool isInside(const xe::Vector3f &point) const {
+            for (int i=0; i<PlaneCount; i++) {
+                if (dot(xe::Vector3f(this->planes[i].x, this->planes[i].y, this->planes[i].z), point) + this->planes[i].w < 0.0f) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const xe::Vector4f& getPlane(int index) const {
+            return this->planes[index];
+        }
+
+    private:
+        //! Left, right, bottom, top, near and far, as (normal, distance).
+        xe::Vector4f planes[PlaneCount];
+    };
+}}
+
+#endif  //__EXENG_SCENEGRAPH_FRUSTUM_HPP__
@@ -13,6 +13,11 @@
 
 #include <xe/sg/Geometry.hpp>
 #include <xe/sg/Pipeline.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/RayPacket.hpp>
+#include <xe/sg/IntersectInfo.hpp>
+
+#include <cassert>
 
 namespace xe { namespace sg {
     Geometry::~Geometry() { }
@@ -21,7 +26,54 @@ namespace xe { namespace sg {
 		return TypeId<Geometry>();
 	}
 
+	std::uint32_t Geometry::getVersion() const {
+		return 0;
+	}
+
 	void Geometry::renderWith(xe::sg::Pipeline *renderer) {
 		renderer->render(this);
 	}
+
+	bool Geometry::occluded(const xe::sg::Ray &ray) {
+		IntersectInfo info;
+
+		if (!this->hit(ray, &info)) {
+			return false;
+		}
+
+		return ray.contains(info.distance);
+	}
+
+	int Geometry::hitPacket(xe::sg::RayPacket &packet, xe::sg::IntersectInfo *intersectInfos) {
+		assert(intersectInfos);
+
+		int mask = 0;
+
+		for (int lane=0; lane<packet.size; lane++) {
+			const xe::Vector3f direction = packet.getDirection(lane);
+			const float length = abs(direction);
+
+			IntersectInfo info;
+
+			if (!this->hit(Ray(packet.getPoint(lane), direction, packet.minDistance[lane] * length), &info)) {
+				continue;
+			}
+
+			// the packet distances are measured in units of the (maybe not normalized) direction
+			const float distance = info.distance / length;
+
+			if (distance < packet.minDistance[lane] || distance >= packet.maxDistance[lane]) {
+				continue;
+			}
+
+			info.distance = distance;
+
+			packet.maxDistance[lane] = distance;
+			intersectInfos[lane] = info;
+
+			mask |= 1 << lane;
+		}
+
+		return mask;
+	}
 }}
@@ -15,6 +15,7 @@
 #define __EXENG_SCENEGRAPH_GEOMETRY_HPP__
 
 #include <memory>
+#include <cstdint>
 #include <xe/Object.hpp>
 #include <xe/Boundary.hpp>
 #include <xe/sg/Renderable.hpp>
@@ -22,6 +23,7 @@
 namespace xe { namespace sg {
         
 	class Ray;
+	struct RayPacket;
 	struct IntersectInfo;
 
 	/**
@@ -36,6 +38,13 @@ namespace xe { namespace sg {
 		 * @return Un objeto de tipo Exeng::Boxf, con la caja de colision
 		 */
 		virtual Boxf getBox() const = 0;
+
+		/**
+		 * @brief Get a number that changes each time the shape of the geometry changes, so the boxes computed 
+		 * from it can be checked without computing them again. The default implementation always returns 0,
+		 * for the geometries that never change.
+		 */
+		virtual std::uint32_t getVersion() const;
          
 		/**
 		 * @brief Detecta la interseccion del objeto geometrico con el rayo indicado.
@@ -44,6 +53,25 @@ namespace xe { namespace sg {
 		 * @return Un valor 'bool'. True si se detecto la interseccion, y False en caso contrario.
 		 */
 		virtual bool hit( const xe::sg::Ray &ray, xe::sg::IntersectInfo *intersectInfo) = 0;
+
+		/**
+		 * @brief Check if the ray intersects the geometry, between its minimum and maximum distances.
+		 *
+		 * Unlike hit, any intersection is enough, so the implementations can stop at the first one found, 
+		 * and skip the computation of the intersection point, normal and material. Useful for shadow rays.
+		 * The default implementation calls hit.
+		 */
+		virtual bool occluded(const xe::sg::Ray &ray);
+
+		/**
+		 * @brief Detect the intersections of all the rays of the packet with the geometry.
+		 *
+		 * The lanes that hit the geometry before their current maximum distance get it updated, and their
+		 * intersection information stored in intersectInfos[lane]. The other lanes are left untouched.
+		 * The default implementation tests each ray separately.
+		 * @return The mask of the lanes that hit the geometry.
+		 */
+		virtual int hitPacket(xe::sg::RayPacket &packet, xe::sg::IntersectInfo *intersectInfos);
 			
 		virtual TypeInfo getTypeInfo() const;
 
@@ -0,0 +1,294 @@
+/**
+ * @file InstanceBVH.cpp
+ * @brief Top level BVH implementation.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/InstanceBVH.hpp>
+#include <xe/sg/Geometry.hpp>
+#include <xe/sg/PacketIntersect.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace xe { namespace sg {
+
+    inline Vector3f transformPoint(const Matrix4f &m, const Vector3f &p) {
+        Vector3f result;
+
+        for (int i=0; i<3; i++) {
+            result[i] = m.get(i, 0)*p.x + m.get(i, 1)*p.y + m.get(i, 2)*p.z + m.get(i, 3);
+        }
+
+        return result;
+    }
+
+    inline Vector3f transformDirection(const Matrix4f &m, const Vector3f &d) {
+        Vector3f result;
+
+        for (int i=0; i<3; i++) {
+            result[i] = m.get(i, 0)*d.x + m.get(i, 1)*d.y + m.get(i, 2)*d.z;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Transform a normal vector using the inverse of the transformation.
+     */
+    inline Vector3f transformNormal(const Matrix4f &inv, const Vector3f &n) {
+        Vector3f result;
+
+        for (int i=0; i<3; i++) {
+            result[i] = inv.get(0, i)*n.x + inv.get(1, i)*n.y + inv.get(2, i)*n.z;
+        }
+
+        return normalize(result);
+    }
+
+    inline Boxf transformBox(const Matrix4f &m, const Boxf &box) {
+        Boxf result;
+
+        for (int i=0; i<Boxf::PointCount; i++) {
+            result.expand(transformPoint(m, box.getEdge(i)));
+        }
+
+        return result;
+    }
+
+    InstanceBVH::InstanceBVH() {}
+
+    void InstanceBVH::clear() {
+        this->instances.clear();
+        this->bounded.clear();
+        this->unbounded.clear();
+        this->bvh.build(std::vector<Boxf>());
+    }
+
+    int InstanceBVH::add(Geometry *geometry, const Matrix4f &transform) {
+        assert(geometry);
+
+        GeometryInstance instance;
+        instance.geometry = geometry;
+        instance.transform = transform;
+
+        this->instances.push_back(instance);
+
+        return static_cast<int>(this->instances.size()) - 1;
+    }
+
+    void InstanceBVH::updateInstance(GeometryInstance &instance) {
+        instance.invTransform = inverse(instance.transform);
+
+        const Boxf box = instance.geometry->getBox();
+
+        if (box.isValid()) {
+            instance.box = transformBox(instance.transform, box);
+        } else {
+            instance.box = Boxf();
+        }
+    }
+
+    void InstanceBVH::build() {
+        this->bounded.clear();
+        this->unbounded.clear();
+
+        std::vector<Boxf> boxes;
+
+        for (int i=0; i<static_cast<int>(this->instances.size()); i++) {
+            GeometryInstance &instance = this->instances[i];
+
+            this->updateInstance(instance);
+
+            if (instance.box.isValid()) {
+                this->bounded.push_back(i);
+                boxes.push_back(instance.box);
+            } else {
+                this->unbounded.push_back(i);
+            }
+        }
+
+        this->bvh.build(boxes, 1);
+    }
+
+    void InstanceBVH::setTransform(int index, const Matrix4f &transform) {
+        assert(index >= 0 && index < static_cast<int>(this->instances.size()));
+
+        this->instances[index].transform = transform;
+    }
+
+    void InstanceBVH::refit() {
+        std::vector<Boxf> boxes(this->bounded.size());
+
+        for (GeometryInstance &instance : this->instances) {
+            this->updateInstance(instance);
+        }
+
+        for (std::size_t i=0; i<this->bounded.size(); i++) {
+            boxes[i] = this->instances[this->bounded[i]].box;
+
+            // a bounded geometry can't become unbounded without a rebuild
+            assert(boxes[i].isValid());
+        }
+
+        this->bvh.refit(boxes);
+    }
+
+    int InstanceBVH::getInstanceCount() const {
+        return static_cast<int>(this->instances.size());
+    }
+
+    const GeometryInstance& InstanceBVH::getInstance(int index) const {
+        assert(index >= 0 && index < static_cast<int>(this->instances.size()));
+
+        return this->instances[index];
+    }
+
+    Boxf InstanceBVH::getBox() const {
+        return this->bvh.getBox();
+    }
+
+    /**
+     * @brief Transform the ray to the local space of the instance. The local ray is normalized, 
+     * so its distances are scaled by the length of the transformed direction.
+     */
+    inline Ray transformRay(const Matrix4f &inv, const Ray &ray) {
+        const Vector3f point = transformPoint(inv, ray.getPoint());
+        const Vector3f direction = transformDirection(inv, ray.getDirection());
+
+        const float scale = abs(direction);
+
+        return Ray(point, direction, ray.getMinDistance() * scale, ray.getMaxDistance() * scale);
+    }
+
+    bool InstanceBVH::intersectInstance(const GeometryInstance &instance, const Ray &ray, IntersectInfo *intersectInfo) const {
+        const Ray localRay = transformRay(instance.invTransform, ray);
+
+        IntersectInfo info;
+
+        if (!instance.geometry->hit(localRay, &info) || info.distance < 0.0f) {
+            return false;
+        }
+
+        // the distances aren't preserved by scaling transformations
+        const Vector3f worldPoint = transformPoint(instance.transform, localRay.getPointAt(info.distance));
+        const float distance = dot(worldPoint - ray.getPoint(), ray.getDirection());
+
+        if (!ray.contains(distance)) {
+            return false;
+        }
+
+        info.distance = distance;
+        info.point = worldPoint;
+        info.normal = transformNormal(instance.invTransform, info.normal);
+
+        *intersectInfo = info;
+
+        return true;
+    }
+
+    bool InstanceBVH::occludedInstance(const GeometryInstance &instance, const Ray &ray) const {
+        return instance.geometry->occluded(transformRay(instance.invTransform, ray));
+    }
+
+    int InstanceBVH::intersectInstance(const GeometryInstance &instance, RayPacket &packet, IntersectInfo *intersectInfos) const {
+        // the local directions aren't normalized, so the distances are the same in both spaces
+        RayPacket localPacket;
+        localPacket.size = packet.size;
+
+        for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+            const Vector3f point = transformPoint(instance.invTransform, packet.getPoint(lane));
+            const Vector3f direction = transformDirection(instance.invTransform, packet.getDirection(lane));
+
+            localPacket.setLane(lane, point, direction, packet.minDistance[lane], packet.maxDistance[lane]);
+        }
+
+        IntersectInfo localInfos[RayPacket::MaxSize];
+
+        const int mask = instance.geometry->hitPacket(localPacket, localInfos);
+
+        for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+            if (mask & (1 << lane)) {
+                IntersectInfo &info = intersectInfos[lane];
+
+                info = localInfos[lane];
+                info.point = packet.getPointAt(lane, info.distance);
+                info.normal = transformNormal(instance.invTransform, info.normal);
+
+                packet.maxDistance[lane] = info.distance;
+            }
+        }
+
+        return mask;
+    }
+
+    bool InstanceBVH::intersect(const Ray &ray, IntersectInfo *intersectInfo) const {
+        IntersectInfo info;
+
+        // shrinks with each hit, so only closer hits are searched after it
+        Ray segment = ray;
+
+        for (int index : this->unbounded) {
+            IntersectInfo localInfo;
+
+            if (this->intersectInstance(this->instances[index], segment, &localInfo)) {
+                segment.clip(localInfo.distance);
+                info = localInfo;
+            }
+        }
+
+        this->bvh.traverse(segment, [&](int index, Ray &current) {
+            IntersectInfo localInfo;
+
+            if (this->intersectInstance(this->instances[this->bounded[index]], current, &localInfo)) {
+                current.clip(localInfo.distance);
+                info = localInfo;
+
+                return true;
+            }
+
+            return false;
+        });
+
+        if (intersectInfo) {
+            *intersectInfo = info;
+        }
+
+        return info.intersect;
+    }
+
+    bool InstanceBVH::occluded(const Ray &ray) const {
+        for (int index : this->unbounded) {
+            if (this->occludedInstance(this->instances[index], ray)) {
+                return true;
+            }
+        }
+
+        return this->bvh.traverseAny(ray, [&](int index) {
+            return this->occludedInstance(this->instances[this->bounded[index]], ray);
+        });
+    }
+
+    int InstanceBVH::intersect(RayPacket &packet, IntersectInfo *intersectInfos) const {
+        assert(intersectInfos);
+
+        int mask = 0;
+
+        for (int index : this->unbounded) {
+            mask |= this->intersectInstance(this->instances[index], packet, intersectInfos);
+        }
+
+        mask |= this->bvh.traverse(packet, getPacketKernels(), [&](int index, RayPacket &rays) {
+            return this->intersectInstance(this->instances[this->bounded[index]], rays, intersectInfos);
+        });
+
+        return mask;
+    }
+}}
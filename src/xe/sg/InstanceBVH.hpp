@@ -0,0 +1,133 @@
+/**
+ * @file InstanceBVH.hpp
+ * @brief Top level BVH over transformed geometry instances.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_INSTANCEBVH_HPP__
+#define __EXENG_SCENEGRAPH_INSTANCEBVH_HPP__
+
+#include <vector>
+
+#include <xe/Config.hpp>
+#include <xe/Matrix.hpp>
+#include <xe/Boundary.hpp>
+#include <xe/sg/Forward.hpp>
+#include <xe/sg/BVH.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/RayPacket.hpp>
+#include <xe/sg/IntersectInfo.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief A Geometry placed in the world with a transformation.
+     */
+    struct GeometryInstance {
+        //! The instanced geometry. Its own hit test acts as the bottom level structure.
+        Geometry *geometry = nullptr;
+
+        //! Local to world transformation.
+        xe::Matrix4f transform;
+
+        //! World to local transformation.
+        xe::Matrix4f invTransform;
+
+        //! World space bounding box.
+        xe::Boxf box;
+    };
+
+    /**
+     * @brief Two level acceleration structure. A BVH over the world space boxes of geometry instances,
+     * whose leafs delegate the ray queries to the geometries, in their local space.
+     *
+     * Geometries without a valid bounding box (like planes) are kept apart and tested linearly.
+     */
+    class EXENGAPI InstanceBVH {
+    public:
+        InstanceBVH();
+
+        /**
+         * @brief Removes all the instances.
+         */
+        void clear();
+
+        /**
+         * @brief Adds a new instance. The hierarchy isn't updated until the next call to build.
+         * @return The index of the new instance.
+         */
+        int add(Geometry *geometry, const xe::Matrix4f &transform);
+
+        /**
+         * @brief Builds the hierarchy from the current instances.
+         */
+        void build();
+
+        /**
+         * @brief Changes the transformation of an instance. The hierarchy isn't updated until the next call to refit.
+         */
+        void setTransform(int index, const xe::Matrix4f &transform);
+
+        /**
+         * @brief Updates the bounding boxes of the hierarchy from the current instance transformations,
+         * and the current geometry boxes, without rebuilding it.
+         */
+        void refit();
+
+        int getInstanceCount() const;
+
+        const GeometryInstance& getInstance(int index) const;
+
+        /**
+         * @brief Get the world space bounding box of the bounded instances.
+         */
+        xe::Boxf getBox() const;
+
+        /**
+         * @brief Find the closest intersection of the ray with the instances, between its minimum and maximum distances.
+         */
+        bool intersect(const Ray &ray, IntersectInfo *intersectInfo) const;
+
+        /**
+         * @brief Check if the ray intersects some instance, between its minimum and maximum distances. 
+         * Stops at the first intersection found.
+         */
+        bool occluded(const Ray &ray) const;
+
+        /**
+         * @brief Find the closest intersections of the rays of the packet with the instances, before their current 
+         * maximum distances. The information of each lane that hits something is stored in intersectInfos[lane].
+         * @return The mask of the lanes that hit some instance.
+         */
+        int intersect(RayPacket &packet, IntersectInfo *intersectInfos) const;
+
+    private:
+        bool intersectInstance(const GeometryInstance &instance, const Ray &ray, IntersectInfo *intersectInfo) const;
+
+        int intersectInstance(const GeometryInstance &instance, RayPacket &packet, IntersectInfo *intersectInfos) const;
+
+        bool occludedInstance(const GeometryInstance &instance, const Ray &ray) const;
+
+        void updateInstance(GeometryInstance &instance);
+
+    private:
+        std::vector<GeometryInstance> instances;
+
+        //! Indices of the instances referenced by the leafs of the bvh.
+        std::vector<int> bounded;
+
+        //! Indices of the instances tested linearly.
+        std::vector<int> unbounded;
+
+        BVH bvh;
+    };
+}}
+
+#endif  //__EXENG_SCENEGRAPH_INSTANCEBVH_HPP__
@@ -9,6 +9,7 @@
 #include <xe/Boundary.hpp>
 #include <xe/sg/IntersectInfo.hpp>
 #include <xe/sg/Ray.hpp>
+#include <xe/sg/SlabIntersect.hpp>
 #include <xe/sg/Sphere.hpp>
 #include <xe/sg/Plane.hpp>
 
@@ -21,6 +22,7 @@
 #  undef far
 #endif
 
+#include <algorithm>
 #include <limits>
 
 namespace xe { namespace sg {
@@ -28,65 +30,24 @@ namespace xe { namespace sg {
     bool intersect(const Ray &ray, const Plane &plane, IntersectInfo *info);
     bool intersect(const Ray &ray, const Sphere &sphere, IntersectInfo *info);
 
+    bool occluded(const Ray &ray, const Boxf &box);
+    bool occluded(const Ray &ray, const Plane &plane);
+    bool occluded(const Ray &ray, const Sphere &sphere);
+
 	inline bool intersect(const Ray &ray, const xe::Boxf &box, IntersectInfo *info) 
 	{
-        Vector3f minEdge = box.getMin();
-        Vector3f maxEdge = box.getMax();
-        
-        Vector3f rayPoint = ray.getPoint();
-        Vector3f rayDirection = ray.getDirection();
+        const Vector3f minEdge = box.getMinEdge();
+        const Vector3f maxEdge = box.getMaxEdge();
         
-        float near = -std::numeric_limits<float>::max();
-        float far = std::numeric_limits<float>::max();
+        // Only the part of the box covered by the ray is considered
+        float near = 0.0f;
         
-        // For each coord, get the near and far intersection distances
-        for (int coord=0; coord<3; ++coord) {
-            
-            // Ray is parallel to current coordinate
-            if (rayDirection[coord] == 0.0f) { 
-                if (rayPoint[coord] < minEdge[coord] || rayPoint[coord] > maxEdge[coord]) {
-                    if ( info != nullptr ) {
-                        info->intersect = false;
-                    }
-                    
-                    return false;
-                }
-                
-                continue;
+        if (!intersectSlab(ray, box, &near)) {
+            if (info != nullptr) {
+                info->intersect = false;
             }
             
-            // Ray is not parallel. Continue compute of the intersection
-            float invRayDirection = 1.0f / rayDirection[coord];
-            float t1 = (minEdge[coord] - rayPoint[coord]) * invRayDirection;
-            float t2 = (maxEdge[coord] - rayPoint[coord]) * invRayDirection;
-            
-            if (t1 > t2) {
-                std::swap(t1, t2);
-            }
-            
-            if (t1 > near) {
-                near = t1;
-            }
-            
-            if (t2 < far) {
-                far = t2;
-            }
-            
-            if (near > far) {
-                if (info != nullptr) {
-                    info->intersect = false;
-                }
-                
-                return false;
-            }
-            
-            if (far < 0.0f) {
-                if (info != nullptr) {
-                    info->intersect = false;
-                }
-                
-                return false;
-            }
+            return false;
         }
         
         // Compute intersection point
@@ -126,6 +87,25 @@ namespace xe { namespace sg {
 	{
         return sphere.intersect(ray, info);
     }
+
+    /**
+     * @brief Check if the ray touches the box between its minimum and maximum distances. 
+     * A ray that starts inside the box touches it.
+     */
+    inline bool occluded(const Ray &ray, const Boxf &box) 
+    {
+        return intersect(ray, box, nullptr);
+    }
+
+    inline bool occluded(const Ray &ray, const Plane &plane) 
+    {
+        return plane.occluded(ray);
+    }
+
+    inline bool occluded(const Ray &ray, const Sphere &sphere) 
+    {
+        return sphere.occluded(ray);
+    }
 }}
 
 #if defined(_WIN32)
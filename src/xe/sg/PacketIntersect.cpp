@@ -0,0 +1,305 @@
+/**
+ * @file PacketIntersect.cpp
+ * @brief Scalar and SSE ray packet kernels, and the runtime selection of the kernels.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/PacketIntersect.hpp>
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EXENG_PACKET_SSE
+#  include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+namespace xe { namespace sg {
+
+    /*
+     * Defined in PacketIntersectAVX2.cpp, the only file compiled with the AVX2 instruction set enabled.
+     */
+    extern bool isAVX2Compiled();
+    extern int intersectBoxAVX2(const RayPacket &packet, const float *minEdge, const float *maxEdge);
+    extern int intersectTriangleAVX2(RayPacket &packet, const float *p0, const float *e1, const float *e2);
+
+    /*
+     * Scalar kernels
+     */
+    static int intersectBoxScalar(const RayPacket &packet, const xe::Boxf &box) {
+        const xe::Vector3f minEdge = box.getMinEdge();
+        const xe::Vector3f maxEdge = box.getMaxEdge();
+
+        int mask = 0;
+
+        for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+            const float point[3] = {packet.pointX[lane], packet.pointY[lane], packet.pointZ[lane]};
+            const float invDirection[3] = {packet.invDirectionX[lane], packet.invDirectionY[lane], packet.invDirectionZ[lane]};
+
+            float tnear = packet.minDistance[lane];
+            float tfar = packet.maxDistance[lane];
+
+            for (int coord=0; coord<3; coord++) {
+                const bool negative = invDirection[coord] < 0.0f;
+                const float t1 = ((negative ? maxEdge : minEdge)[coord] - point[coord]) * invDirection[coord];
+                const float t2 = ((negative ? minEdge : maxEdge)[coord] - point[coord]) * invDirection[coord];
+
+                tnear = std::max(tnear, t1);
+                tfar = std::min(tfar, t2);
+            }
+
+            if (tnear <= tfar * SlabFarScale) {
+                mask |= 1 << lane;
+            }
+        }
+
+        return mask;
+    }
+
+    static int intersectTriangleScalar(RayPacket &packet, const xe::Vector3f &p0, const xe::Vector3f &e1, const xe::Vector3f &e2) {
+        int mask = 0;
+
+        for (int lane=0; lane<RayPacket::MaxSize; lane++) {
+            const xe::Vector3f direction = packet.getDirection(lane);
+
+            const xe::Vector3f pvec = cross(direction, e2);
+            const float det = dot(e1, pvec);
+
+            if (det == 0.0f) {
+                continue;
+            }
+
+            const float invDet = 1.0f / det;
+
+            const xe::Vector3f tvec = packet.getPoint(lane) - p0;
+            const float u = dot(tvec, pvec) * invDet;
+
+            const xe::Vector3f qvec = cross(tvec, e1);
+            const float v = dot(direction, qvec) * invDet;
+            const float t = dot(e2, qvec) * invDet;
+
+            if (u >= -TriangleEdgeTolerance && v >= -TriangleEdgeTolerance && u + v <= 1.0f + TriangleEdgeTolerance && t >= packet.minDistance[lane] && t < packet.maxDistance[lane]) {
+                packet.maxDistance[lane] = t;
+                mask |= 1 << lane;
+            }
+        }
+
+        return mask;
+    }
+
+    static const PacketKernels scalarKernels = {
+        "Scalar", 1, intersectBoxScalar, intersectTriangleScalar
+    };
+
+    /*
+     * SSE kernels. Each half of the packet is processed with four wide instructions.
+     */
+#if defined(EXENG_PACKET_SSE)
+    static inline __m128 selectSSE(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static int intersectBoxSSE(const RayPacket &packet, const xe::Boxf &box) {
+        const xe::Vector3f minEdge = box.getMinEdge();
+        const xe::Vector3f maxEdge = box.getMaxEdge();
+
+        const __m128 minX = _mm_set1_ps(minEdge.x), minY = _mm_set1_ps(minEdge.y), minZ = _mm_set1_ps(minEdge.z);
+        const __m128 maxX = _mm_set1_ps(maxEdge.x), maxY = _mm_set1_ps(maxEdge.y), maxZ = _mm_set1_ps(maxEdge.z);
+        const __m128 farScale = _mm_set1_ps(SlabFarScale);
+        const __m128 zero = _mm_setzero_ps();
+
+        int mask = 0;
+
+        for (int half=0; half<RayPacket::MaxSize; half+=4) {
+            __m128 tnear = _mm_load_ps(packet.minDistance + half);
+            __m128 tfar = _mm_load_ps(packet.maxDistance + half);
+
+            const __m128 pointX = _mm_load_ps(packet.pointX + half);
+            const __m128 invX = _mm_load_ps(packet.invDirectionX + half);
+            const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(minX, pointX), invX);
+            const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(maxX, pointX), invX);
+
+            const __m128 negX = _mm_cmplt_ps(invX, zero);
+            tnear = _mm_max_ps(selectSSE(negX, tx2, tx1), tnear);
+            tfar = _mm_min_ps(selectSSE(negX, tx1, tx2), tfar);
+
+            const __m128 pointY = _mm_load_ps(packet.pointY + half);
+            const __m128 invY = _mm_load_ps(packet.invDirectionY + half);
+            const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(minY, pointY), invY);
+            const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(maxY, pointY), invY);
+
+            const __m128 negY = _mm_cmplt_ps(invY, zero);
+            tnear = _mm_max_ps(selectSSE(negY, ty2, ty1), tnear);
+            tfar = _mm_min_ps(selectSSE(negY, ty1, ty2), tfar);
+
+            const __m128 pointZ = _mm_load_ps(packet.pointZ + half);
+            const __m128 invZ = _mm_load_ps(packet.invDirectionZ + half);
+            const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(minZ, pointZ), invZ);
+            const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(maxZ, pointZ), invZ);
+
+            const __m128 negZ = _mm_cmplt_ps(invZ, zero);
+            tnear = _mm_max_ps(selectSSE(negZ, tz2, tz1), tnear);
+            tfar = _mm_min_ps(selectSSE(negZ, tz1, tz2), tfar);
+
+            mask |= _mm_movemask_ps(_mm_cmple_ps(tnear, _mm_mul_ps(tfar, farScale))) << half;
+        }
+
+        return mask;
+    }
+
+    static int intersectTriangleSSE(RayPacket &packet, const xe::Vector3f &p0, const xe::Vector3f &e1, const xe::Vector3f &e2) {
+        const __m128 p0X = _mm_set1_ps(p0.x), p0Y = _mm_set1_ps(p0.y), p0Z = _mm_set1_ps(p0.z);
+        const __m128 e1X = _mm_set1_ps(e1.x), e1Y = _mm_set1_ps(e1.y), e1Z = _mm_set1_ps(e1.z);
+        const __m128 e2X = _mm_set1_ps(e2.x), e2Y = _mm_set1_ps(e2.y), e2Z = _mm_set1_ps(e2.z);
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minCoord = _mm_set1_ps(-TriangleEdgeTolerance);
+        const __m128 maxCoord = _mm_set1_ps(1.0f + TriangleEdgeTolerance);
+
+        int mask = 0;
+
+        for (int half=0; half<RayPacket::MaxSize; half+=4) {
+            const __m128 dirX = _mm_load_ps(packet.directionX + half);
+            const __m128 dirY = _mm_load_ps(packet.directionY + half);
+            const __m128 dirZ = _mm_load_ps(packet.directionZ + half);
+
+            // pvec = direction x e2
+            const __m128 pX = _mm_sub_ps(_mm_mul_ps(dirY, e2Z), _mm_mul_ps(dirZ, e2Y));
+            const __m128 pY = _mm_sub_ps(_mm_mul_ps(dirZ, e2X), _mm_mul_ps(dirX, e2Z));
+            const __m128 pZ = _mm_sub_ps(_mm_mul_ps(dirX, e2Y), _mm_mul_ps(dirY, e2X));
+
+            const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1X, pX), _mm_mul_ps(e1Y, pY)), _mm_mul_ps(e1Z, pZ));
+            const __m128 invDet = _mm_div_ps(one, det);
+
+            // tvec = point - p0
+            const __m128 tX = _mm_sub_ps(_mm_load_ps(packet.pointX + half), p0X);
+            const __m128 tY = _mm_sub_ps(_mm_load_ps(packet.pointY + half), p0Y);
+            const __m128 tZ = _mm_sub_ps(_mm_load_ps(packet.pointZ + half), p0Z);
+
+            const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)), _mm_mul_ps(tZ, pZ)), invDet);
+
+            // qvec = tvec x e1
+            const __m128 qX = _mm_sub_ps(_mm_mul_ps(tY, e1Z), _mm_mul_ps(tZ, e1Y));
+            const __m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, e1X), _mm_mul_ps(tX, e1Z));
+            const __m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, e1Y), _mm_mul_ps(tY, e1X));
+
+            const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ)), invDet);
+            const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2X, qX), _mm_mul_ps(e2Y, qY)), _mm_mul_ps(e2Z, qZ)), invDet);
+
+            const __m128 minDistance = _mm_load_ps(packet.minDistance + half);
+            const __m128 maxDistance = _mm_load_ps(packet.maxDistance + half);
+
+            __m128 hit = _mm_cmpneq_ps(det, zero);
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(u, minCoord));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(v, minCoord));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), maxCoord));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(t, minDistance));
+            hit = _mm_and_ps(hit, _mm_cmplt_ps(t, maxDistance));
+
+            _mm_store_ps(packet.maxDistance + half, _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, maxDistance)));
+
+            mask |= _mm_movemask_ps(hit) << half;
+        }
+
+        return mask;
+    }
+
+    static const PacketKernels sseKernels = {
+        "SSE", 4, intersectBoxSSE, intersectTriangleSSE
+    };
+#endif
+
+    /*
+     * AVX2 kernels, adapted to the PacketKernels interface.
+     */
+    static int intersectBoxAVX2Adapter(const RayPacket &packet, const xe::Boxf &box) {
+        const xe::Vector3f minEdge = box.getMinEdge();
+        const xe::Vector3f maxEdge = box.getMaxEdge();
+
+        return intersectBoxAVX2(packet, minEdge.data, maxEdge.data);
+    }
+
+    static int intersectTriangleAVX2Adapter(RayPacket &packet, const xe::Vector3f &p0, const xe::Vector3f &e1, const xe::Vector3f &e2) {
+        return intersectTriangleAVX2(packet, p0.data, e1.data, e2.data);
+    }
+
+    static const PacketKernels avx2Kernels = {
+        "AVX2", 8, intersectBoxAVX2Adapter, intersectTriangleAVX2Adapter
+    };
+
+    /**
+     * @brief Check if both the CPU and the operating system support the AVX2 instruction set.
+     */
+    static bool isAVX2Supported() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+
+        return __builtin_cpu_supports("avx2") != 0;
+
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4] = {0};
+
+        __cpuid(info, 1);
+
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+
+        // the operating system must save the YMM registers
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    const PacketKernels& getScalarPacketKernels() {
+        return scalarKernels;
+    }
+
+    const PacketKernels* getSSEPacketKernels() {
+#if defined(EXENG_PACKET_SSE)
+        return &sseKernels;
+#else
+        return nullptr;
+#endif
+    }
+
+    const PacketKernels* getAVX2PacketKernels() {
+        static const bool supported = isAVX2Compiled() && isAVX2Supported();
+
+        return supported ? &avx2Kernels : nullptr;
+    }
+
+    const PacketKernels& getPacketKernels() {
+        static const PacketKernels *kernels = []() {
+            if (const PacketKernels *avx2 = getAVX2PacketKernels()) {
+                return avx2;
+            }
+
+            if (const PacketKernels *sse = getSSEPacketKernels()) {
+                return sse;
+            }
+
+            return &getScalarPacketKernels();
+        }();
+
+        return *kernels;
+    }
+}}
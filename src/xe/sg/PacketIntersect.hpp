@@ -0,0 +1,87 @@
+/**
+ * @file PacketIntersect.hpp
+ * @brief Intersection kernels between ray packets and elemental objects.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_PACKETINTERSECT_HPP__
+#define __EXENG_SCENEGRAPH_PACKETINTERSECT_HPP__
+
+#include <xe/Config.hpp>
+#include <xe/Vector.hpp>
+#include <xe/Boundary.hpp>
+#include <xe/sg/RayPacket.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Scale applied to the far distance of the slab tests, so the rounding errors can't make a ray 
+     * slip between two adjacent boxes (Ize, "Robust BVH Ray Traversal", 2013).
+     */
+    const float SlabFarScale = 1.0000004f;
+
+    /**
+     * @brief Tolerance of the barycentric coordinates in the packet triangle tests, so the rays that pass
+     * over a edge shared by two triangles don't slip between both of them.
+     */
+    const float TriangleEdgeTolerance = 1.0e-5f;
+
+    /**
+     * @brief Set of ray packet intersection routines, implemented for a specific instruction set.
+     *
+     * All the routines process the full RayPacket::MaxSize lanes, and return a mask with one bit per lane.
+     */
+    struct PacketKernels {
+        //! Name of the instruction set ("Scalar", "SSE", "AVX2").
+        const char *name;
+
+        //! Number of lanes processed by each instruction.
+        int width;
+
+        /**
+         * @brief Slab test between the rays of the packet and a box, limited by the minimum and current maximum distances of each lane.
+         * @return The mask of the lanes that hit the box.
+         */
+        int (*intersectBox)(const RayPacket &packet, const xe::Boxf &box);
+
+        /**
+         * @brief Möller-Trumbore test between the rays of the packet and the triangle (p0, p0 + e1, p0 + e2).
+         *
+         * The edges of the triangle are widened by TriangleEdgeTolerance.
+         * The lanes that hit the triangle between their minimum and current maximum distances get the maximum updated to the hit distance.
+         * @return The mask of the lanes that hit the triangle.
+         */
+        int (*intersectTriangle)(RayPacket &packet, const xe::Vector3f &p0, const xe::Vector3f &e1, const xe::Vector3f &e2);
+    };
+
+    /**
+     * @brief Get the portable implementation of the kernels.
+     */
+    extern EXENGAPI const PacketKernels& getScalarPacketKernels();
+
+    /**
+     * @brief Get the SSE implementation of the kernels, or nullptr when it isn't available.
+     */
+    extern EXENGAPI const PacketKernels* getSSEPacketKernels();
+
+    /**
+     * @brief Get the AVX2 implementation of the kernels, or nullptr when it isn't available in the build, or in the current CPU.
+     */
+    extern EXENGAPI const PacketKernels* getAVX2PacketKernels();
+
+    /**
+     * @brief Get the fastest implementation of the kernels supported by the current CPU.
+     *
+     * The selection is done once, on the first call.
+     */
+    extern EXENGAPI const PacketKernels& getPacketKernels();
+}}
+
+#endif  //__EXENG_SCENEGRAPH_PACKETINTERSECT_HPP__
@@ -0,0 +1,132 @@
+/**
+ * @file PacketIntersectAVX2.cpp
+ * @brief AVX2 ray packet kernels.
+ *
+ * This file is compiled with the AVX2 instruction set enabled, so nothing outside of it must call
+ * these functions until the support of the CPU is checked. The kernels take plain floats instead
+ * of vectors and boxes, so no inline function from the headers gets instantiated with AVX2 code.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/PacketIntersect.hpp>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+namespace xe { namespace sg {
+
+#if defined(__AVX2__)
+    int intersectBoxAVX2(const RayPacket &packet, const float *minEdge, const float *maxEdge) {
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 tnear = _mm256_load_ps(packet.minDistance);
+        __m256 tfar = _mm256_load_ps(packet.maxDistance);
+
+        const __m256 pointX = _mm256_load_ps(packet.pointX);
+        const __m256 invX = _mm256_load_ps(packet.invDirectionX);
+        const __m256 tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(minEdge[0]), pointX), invX);
+        const __m256 tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(maxEdge[0]), pointX), invX);
+
+        const __m256 negX = _mm256_cmp_ps(invX, zero, _CMP_LT_OQ);
+        tnear = _mm256_max_ps(_mm256_blendv_ps(tx1, tx2, negX), tnear);
+        tfar = _mm256_min_ps(_mm256_blendv_ps(tx2, tx1, negX), tfar);
+
+        const __m256 pointY = _mm256_load_ps(packet.pointY);
+        const __m256 invY = _mm256_load_ps(packet.invDirectionY);
+        const __m256 ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(minEdge[1]), pointY), invY);
+        const __m256 ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(maxEdge[1]), pointY), invY);
+
+        const __m256 negY = _mm256_cmp_ps(invY, zero, _CMP_LT_OQ);
+        tnear = _mm256_max_ps(_mm256_blendv_ps(ty1, ty2, negY), tnear);
+        tfar = _mm256_min_ps(_mm256_blendv_ps(ty2, ty1, negY), tfar);
+
+        const __m256 pointZ = _mm256_load_ps(packet.pointZ);
+        const __m256 invZ = _mm256_load_ps(packet.invDirectionZ);
+        const __m256 tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(minEdge[2]), pointZ), invZ);
+        const __m256 tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(maxEdge[2]), pointZ), invZ);
+
+        const __m256 negZ = _mm256_cmp_ps(invZ, zero, _CMP_LT_OQ);
+        tnear = _mm256_max_ps(_mm256_blendv_ps(tz1, tz2, negZ), tnear);
+        tfar = _mm256_min_ps(_mm256_blendv_ps(tz2, tz1, negZ), tfar);
+
+        tfar = _mm256_mul_ps(tfar, _mm256_set1_ps(SlabFarScale));
+
+        return _mm256_movemask_ps(_mm256_cmp_ps(tnear, tfar, _CMP_LE_OQ));
+    }
+
+    int intersectTriangleAVX2(RayPacket &packet, const float *p0, const float *e1, const float *e2) {
+        const __m256 e1X = _mm256_set1_ps(e1[0]), e1Y = _mm256_set1_ps(e1[1]), e1Z = _mm256_set1_ps(e1[2]);
+        const __m256 e2X = _mm256_set1_ps(e2[0]), e2Y = _mm256_set1_ps(e2[1]), e2Z = _mm256_set1_ps(e2[2]);
+
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 minCoord = _mm256_set1_ps(-TriangleEdgeTolerance);
+        const __m256 maxCoord = _mm256_set1_ps(1.0f + TriangleEdgeTolerance);
+
+        const __m256 dirX = _mm256_load_ps(packet.directionX);
+        const __m256 dirY = _mm256_load_ps(packet.directionY);
+        const __m256 dirZ = _mm256_load_ps(packet.directionZ);
+
+        // pvec = direction x e2
+        const __m256 pX = _mm256_sub_ps(_mm256_mul_ps(dirY, e2Z), _mm256_mul_ps(dirZ, e2Y));
+        const __m256 pY = _mm256_sub_ps(_mm256_mul_ps(dirZ, e2X), _mm256_mul_ps(dirX, e2Z));
+        const __m256 pZ = _mm256_sub_ps(_mm256_mul_ps(dirX, e2Y), _mm256_mul_ps(dirY, e2X));
+
+        const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1X, pX), _mm256_mul_ps(e1Y, pY)), _mm256_mul_ps(e1Z, pZ));
+        const __m256 invDet = _mm256_div_ps(one, det);
+
+        // tvec = point - p0
+        const __m256 tX = _mm256_sub_ps(_mm256_load_ps(packet.pointX), _mm256_set1_ps(p0[0]));
+        const __m256 tY = _mm256_sub_ps(_mm256_load_ps(packet.pointY), _mm256_set1_ps(p0[1]));
+        const __m256 tZ = _mm256_sub_ps(_mm256_load_ps(packet.pointZ), _mm256_set1_ps(p0[2]));
+
+        const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tX, pX), _mm256_mul_ps(tY, pY)), _mm256_mul_ps(tZ, pZ)), invDet);
+
+        // qvec = tvec x e1
+        const __m256 qX = _mm256_sub_ps(_mm256_mul_ps(tY, e1Z), _mm256_mul_ps(tZ, e1Y));
+        const __m256 qY = _mm256_sub_ps(_mm256_mul_ps(tZ, e1X), _mm256_mul_ps(tX, e1Z));
+        const __m256 qZ = _mm256_sub_ps(_mm256_mul_ps(tX, e1Y), _mm256_mul_ps(tY, e1X));
+
+        const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirX, qX), _mm256_mul_ps(dirY, qY)), _mm256_mul_ps(dirZ, qZ)), invDet);
+        const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2X, qX), _mm256_mul_ps(e2Y, qY)), _mm256_mul_ps(e2Z, qZ)), invDet);
+
+        const __m256 minDistance = _mm256_load_ps(packet.minDistance);
+        const __m256 maxDistance = _mm256_load_ps(packet.maxDistance);
+
+        __m256 hit = _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ);
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(u, minCoord, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, minCoord, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), maxCoord, _CMP_LE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, minDistance, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, maxDistance, _CMP_LT_OQ));
+
+        _mm256_store_ps(packet.maxDistance, _mm256_blendv_ps(maxDistance, t, hit));
+
+        return _mm256_movemask_ps(hit);
+    }
+
+    bool isAVX2Compiled() {
+        return true;
+    }
+#else
+    int intersectBoxAVX2(const RayPacket &, const float *, const float *) {
+        return 0;
+    }
+
+    int intersectTriangleAVX2(RayPacket &, const float *, const float *, const float *) {
+        return 0;
+    }
+
+    bool isAVX2Compiled() {
+        return false;
+    }
+#endif
+}}
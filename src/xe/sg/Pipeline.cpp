@@ -3,4 +3,19 @@
 
 namespace xe { namespace sg {
 	Pipeline::~Pipeline() {}
+
+	void Pipeline::render(xe::gfx::Mesh *mesh, int subset) {
+		if (subset == 0) {
+			this->render(mesh);
+		}
+	}
+
+	int Pipeline::render(xe::gfx::Mesh *mesh, int subset, const xe::Matrix4f *transforms, int count) {
+		for (int i=0; i<count; i++) {
+			this->setModel(transforms[i]);
+			this->render(mesh, subset);
+		}
+
+		return count;
+	}
 }}
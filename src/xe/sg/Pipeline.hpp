@@ -25,6 +25,24 @@ namespace xe { namespace sg {
 		virtual void render(xe::sg::Geometry *geometry) = 0;
 		virtual void render(xe::gfx::Mesh *mesh) = 0;
 
+		/**
+		 * @brief Render a single subset of a mesh. 
+		 *
+		 * The scene renderer submits the subsets sorted by material, so the implementations can skip the 
+		 * state changes between consecutive calls. By default, the whole mesh is rendered along with its first subset.
+		 */
+		virtual void render(xe::gfx::Mesh *mesh, int subset);
+
+		/**
+		 * @brief Render a subset of a mesh once for each transformation.
+		 *
+		 * The scene renderer batches this way the nodes that share a mesh subset. By default, each instance 
+		 * is rendered with its own calls to setModel and render, and the implementations able to submit many
+		 * instances at once can override it. The model transformation left set afterwards is unspecified.
+		 * @return The number of draws issued.
+		 */
+		virtual int render(xe::gfx::Mesh *mesh, int subset, const xe::Matrix4f *transforms, int count);
+
 		virtual void setModel(const xe::Matrix4f &) = 0;
 
         virtual const xe::gfx::VertexFormat* getVertexFormat() const = 0;
@@ -76,6 +76,12 @@ public:
      */
     bool intersect(const Ray& ray, IntersectInfo* intersectInfo=nullptr) const;
     
+    /**
+     * @brief Check if the ray intersects the plane between its minimum and maximum distances, without 
+     * computing the rest of the intersection information.
+     */
+    bool occluded(const Ray& ray) const;
+    
 private:
     xe::Vector3f point;
     xe::Vector3f normal;
@@ -154,6 +160,12 @@ inline Plane::Plane() : point(0.0f), normal(0.0f, 1.0, 0.0f) {}
         return result;
     }
 
+    inline bool Plane::occluded(const Ray& ray) const {
+        const float t = dot(this->normal, this->point - ray.getPoint()) / dot(this->normal, ray.getDirection());
+
+        return ray.contains(t);
+    }
+
 }}
 
 std::ostream& operator<< (std::ostream& os, const xe::sg::Plane &plane);
@@ -16,6 +16,7 @@
 
 #include <iosfwd>
 #include <cassert>
+#include <limits>
 
 #include <xe/Config.hpp>
 #include <xe/Vector.hpp>
@@ -24,6 +25,10 @@ namespace xe { namespace sg {
     
 	/**
 	 * @brief Ray abstraction.
+	 *
+	 * The ray only covers the points between its minimum and maximum distances, so the intersection 
+	 * routines can ignore anything outside of it, and shrink it as closer hits are found. The reciprocal 
+	 * and the sign of the direction are kept along with it, for the box tests.
 	 */
 	class Ray {
 	public:
@@ -35,7 +40,7 @@ namespace xe { namespace sg {
 		/**
 		 * @brief Initialize the ray, orientated around a arbitrary origin and direction.
 		 */
-		Ray(const xe::Vector3f& point, const xe::Vector3f& direction);
+		Ray(const xe::Vector3f& point, const xe::Vector3f& direction, float minDistance=0.0f, float maxDistance=std::numeric_limits<float>::max());
 
 		/**
 		 * @brief Set the starting point of the ray.
@@ -51,11 +56,60 @@ namespace xe { namespace sg {
 		 * @brief Set the direction of the ray. The vector of direction is normalized before mutates the Ray object.
 		 */
 		void setDirection(const xe::Vector3f& direction);
+
+		/**
+		 * @brief Set a direction already normalized by the caller, like the ones computed by the ray 
+		 * generators with normalizeFast. 
+		 */
+		void setNormalizedDirection(const xe::Vector3f& direction);
     
 		/**
 		 * @brief Get the direction of the ray. This vector is always normalized.
 		 */
 		xe::Vector3f getDirection() const;
+
+		/**
+		 * @brief Get the component-wise reciprocal of the direction of the ray. 
+		 * The components parallel to some axis become infinite.
+		 */
+		xe::Vector3f getInvDirection() const;
+
+		/**
+		 * @brief Get 1 if the direction of the ray is negative in the specified coordinate, and 0 otherwise.
+		 */
+		int getSign(int coord) const;
+
+		/**
+		 * @brief Set the distance from the starting point where the ray begins.
+		 */
+		void setMinDistance(float distance);
+
+		/**
+		 * @brief Get the distance from the starting point where the ray begins. Zero by default.
+		 */
+		float getMinDistance() const;
+
+		/**
+		 * @brief Set the distance from the starting point where the ray ends.
+		 */
+		void setMaxDistance(float distance);
+
+		/**
+		 * @brief Get the distance from the starting point where the ray ends. The maximum float value by default.
+		 */
+		float getMaxDistance() const;
+
+		/**
+		 * @brief Check if the point at the specified distance lies in the ray, between its minimum (inclusive) 
+		 * and maximum (exclusive) distances.
+		 */
+		bool contains(float distance) const;
+
+		/**
+		 * @brief Shrink the ray, so it ends at the specified distance. Used to record the closest hit found so far.
+		 * @return true if the distance was inside the ray, false if the ray was left unchanged.
+		 */
+		bool clip(float distance);
     
 		/**
 		 * @brief Computes the point of the ray at 't' distance from the starting point, to the 
@@ -71,6 +125,10 @@ namespace xe { namespace sg {
 	private:
 		xe::Vector3f point;
 		xe::Vector3f direction;
+		xe::Vector3f invDirection;
+		int sign[3];
+		float minDistance;
+		float maxDistance;
 	};
 
 }}
@@ -80,9 +138,11 @@ std::ostream& operator<< (std::ostream& os, const xe::sg::Ray& ray);
 
 namespace xe { namespace sg {
 
-	inline Ray::Ray() : point(0.0f), direction(0.0, 0.0, 1.0f) { }
+	inline Ray::Ray() : minDistance(0.0f), maxDistance(std::numeric_limits<float>::max()) { 
+		this->set(xe::Vector3f(0.0f), xe::Vector3f(0.0f, 0.0f, 1.0f));
+	}
 
-	inline Ray::Ray(const xe::Vector3f& point, const xe::Vector3f& direction){
+	inline Ray::Ray(const xe::Vector3f& point, const xe::Vector3f& direction, float minDistance, float maxDistance) : minDistance(minDistance), maxDistance(maxDistance) {
 		this->set(point, direction);
 	}
 
@@ -95,13 +155,62 @@ namespace xe { namespace sg {
 	}
 
 	inline void Ray::setDirection(const xe::Vector3f& direction) {
-		this->direction = normalize(direction);
+		this->setNormalizedDirection(normalize(direction));
+	}
+
+	inline void Ray::setNormalizedDirection(const xe::Vector3f& direction) {
+		this->direction = direction;
+
+		for (int coord=0; coord<3; ++coord) {
+			this->invDirection[coord] = 1.0f / this->direction[coord];
+			this->sign[coord] = this->invDirection[coord] < 0.0f ? 1 : 0;
+		}
 	}
 
 	inline xe::Vector3f Ray::getDirection() const {
 		return this->direction;
 	}
 
+	inline xe::Vector3f Ray::getInvDirection() const {
+		return this->invDirection;
+	}
+
+	inline int Ray::getSign(int coord) const {
+		assert(coord >= 0 && coord < 3);
+
+		return this->sign[coord];
+	}
+
+	inline void Ray::setMinDistance(float distance) {
+		this->minDistance = distance;
+	}
+
+	inline float Ray::getMinDistance() const {
+		return this->minDistance;
+	}
+
+	inline void Ray::setMaxDistance(float distance) {
+		this->maxDistance = distance;
+	}
+
+	inline float Ray::getMaxDistance() const {
+		return this->maxDistance;
+	}
+
+	inline bool Ray::contains(float distance) const {
+		return distance >= this->minDistance && distance < this->maxDistance;
+	}
+
+	inline bool Ray::clip(float distance) {
+		if (!this->contains(distance)) {
+			return false;
+		}
+
+		this->maxDistance = distance;
+
+		return true;
+	}
+
 	inline xe::Vector3f Ray::getPointAt(float t) const {
 		assert( xe::equals( xe::abs(this->direction), 1.0f) == true );
     
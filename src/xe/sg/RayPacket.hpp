@@ -0,0 +1,120 @@
+/**
+ * @file RayPacket.hpp
+ * @brief RayPacket structure definition.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_RAYPACKET_HPP__
+#define __EXENG_SCENEGRAPH_RAYPACKET_HPP__
+
+#include <cassert>
+#include <limits>
+
+#include <xe/Config.hpp>
+#include <xe/Vector.hpp>
+#include <xe/sg/Ray.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief A group of coherent rays, stored as a structure of arrays, so a SIMD kernel
+     * can test all of them against the same primitive at once.
+     *
+     * Unlike Ray, the directions aren't required to be normalized. The distances are measured in
+     * units of the direction vector, so they are preserved when the packet is transformed. Like in Ray,
+     * each lane only reports the hits between its minimum and maximum distances.
+     * The lanes past 'size' are inactive: their maximum distance is negative, so they never hit anything.
+     */
+    struct RayPacket {
+        static const int MaxSize = 8;
+
+        alignas(32) float pointX[MaxSize];
+        alignas(32) float pointY[MaxSize];
+        alignas(32) float pointZ[MaxSize];
+
+        alignas(32) float directionX[MaxSize];
+        alignas(32) float directionY[MaxSize];
+        alignas(32) float directionZ[MaxSize];
+
+        alignas(32) float invDirectionX[MaxSize];
+        alignas(32) float invDirectionY[MaxSize];
+        alignas(32) float invDirectionZ[MaxSize];
+
+        //! Distance where each ray starts, so the secondary rays don't hit again the surface they start on.
+        alignas(32) float minDistance[MaxSize];
+
+        //! Distance to the closest hit found so far, for each lane.
+        alignas(32) float maxDistance[MaxSize];
+
+        //! Number of active lanes.
+        int size = 0;
+
+        RayPacket() {
+            for (int lane=0; lane<MaxSize; lane++) {
+                this->setLane(lane, xe::Vector3f(0.0f), xe::Vector3f(0.0f, 0.0f, 1.0f), 0.0f, -1.0f);
+            }
+        }
+
+        /**
+         * @brief Appends a new ray to the packet, starting at the minimum distance of the ray.
+         * @return The lane used by the ray.
+         */
+        int add(const Ray &ray, float maxDistance = std::numeric_limits<float>::max()) {
+            assert(this->size < MaxSize);
+
+            this->setLane(this->size, ray.getPoint(), ray.getDirection(), ray.getMinDistance(), maxDistance);
+
+            return this->size++;
+        }
+
+        /**
+         * @brief Set the ray of the specified lane, and compute its inverse direction.
+         */
+        void setLane(int lane, const xe::Vector3f &point, const xe::Vector3f &direction, float minDistance, float maxDistance) {
+            assert(lane >= 0 && lane < MaxSize);
+
+            this->pointX[lane] = point.x;
+            this->pointY[lane] = point.y;
+            this->pointZ[lane] = point.z;
+
+            this->directionX[lane] = direction.x;
+            this->directionY[lane] = direction.y;
+            this->directionZ[lane] = direction.z;
+
+            this->invDirectionX[lane] = 1.0f / direction.x;
+            this->invDirectionY[lane] = 1.0f / direction.y;
+            this->invDirectionZ[lane] = 1.0f / direction.z;
+
+            this->minDistance[lane] = minDistance;
+            this->maxDistance[lane] = maxDistance;
+        }
+
+        xe::Vector3f getPoint(int lane) const {
+            return {this->pointX[lane], this->pointY[lane], this->pointZ[lane]};
+        }
+
+        xe::Vector3f getDirection(int lane) const {
+            return {this->directionX[lane], this->directionY[lane], this->directionZ[lane]};
+        }
+
+        xe::Vector3f getPointAt(int lane, float t) const {
+            return this->getPoint(lane) + t * this->getDirection(lane);
+        }
+
+        /**
+         * @brief Get the mask of the active lanes, one bit per lane.
+         */
+        int getActiveMask() const {
+            return (1 << this->size) - 1;
+        }
+    };
+}}
+
+#endif  //__EXENG_SCENEGRAPH_RAYPACKET_HPP__
@@ -0,0 +1,158 @@
+/**
+ * @file RenderQueue.cpp
+ * @brief Render queue implementation.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/RenderQueue.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+namespace xe { namespace sg {
+
+    static const int PassShift = 62;
+
+    /**
+     * @brief Get the bits of a depth, clamped to the positive values, so they can be compared as integers.
+     */
+    inline std::uint64_t getDepthBits(float depth) {
+        // also discards the NaNs
+        if (!(depth > 0.0f)) {
+            depth = 0.0f;
+        }
+
+        std::uint32_t bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+
+        return bits;
+    }
+
+    inline std::uint64_t getPassBits(RenderPass::Enum pass) {
+        return static_cast<std::uint64_t>(pass) << PassShift;
+    }
+
+    void RenderQueue::clear() {
+        this->items.clear();
+        this->entries.clear();
+        this->materialIds.clear();
+        this->subsetIds.clear();
+    }
+
+    int RenderQueue::getMaterialId(const xe::gfx::Material *material) {
+        if (!material) {
+            return 0;
+        }
+
+        auto result = this->materialIds.insert({material, static_cast<int>(this->materialIds.size()) + 1});
+
+        return std::min(result.first->second, static_cast<int>(MaxMaterialId));
+    }
+
+    int RenderQueue::getSubsetId(const void *subset) {
+        auto result = this->subsetIds.insert({subset, static_cast<int>(this->subsetIds.size())});
+
+        return std::min(result.first->second, static_cast<int>(MaxSubsetId));
+    }
+
+    std::uint64_t RenderQueue::makeSetupKey(int sequence) {
+        assert(sequence >= 0);
+
+        return getPassBits(RenderPass::Setup) | static_cast<std::uint64_t>(sequence);
+    }
+
+    std::uint64_t RenderQueue::makeOpaqueKey(int materialId, int subsetId, float depth) {
+        assert(materialId >= 0 && materialId <= MaxMaterialId);
+        assert(subsetId >= 0 && subsetId <= MaxSubsetId);
+
+        return getPassBits(RenderPass::Opaque)
+            | (static_cast<std::uint64_t>(materialId) << 48)
+            | (static_cast<std::uint64_t>(subsetId) << 32)
+            | getDepthBits(depth);
+    }
+
+    std::uint64_t RenderQueue::makeTransparentKey(int materialId, int subsetId, float depth) {
+        assert(materialId >= 0 && materialId <= MaxMaterialId);
+        assert(subsetId >= 0 && subsetId <= MaxSubsetId);
+
+        // the farthest first
+        const std::uint64_t invDepth = 0xFFFFFFFFu - getDepthBits(depth);
+
+        return getPassBits(RenderPass::Transparent)
+            | (invDepth << 30)
+            | (static_cast<std::uint64_t>(materialId) << 16)
+            | static_cast<std::uint64_t>(subsetId);
+    }
+
+    void RenderQueue::add(std::uint64_t key, const RenderItem &item) {
+        this->entries.push_back({key, static_cast<int>(this->items.size())});
+        this->items.push_back(item);
+    }
+
+    void RenderQueue::sort() {
+        const int count = this->getItemCount();
+
+        // least significant digit first. Each pass is stable, so the items with equal keys keep their order
+        const int DigitBits = 8;
+        const int DigitCount = 64 / DigitBits;
+        const int BucketCount = 1 << DigitBits;
+
+        std::vector<int> histograms(DigitCount * BucketCount, 0);
+
+        for (const Entry &entry : this->entries) {
+            for (int digit=0; digit<DigitCount; digit++) {
+                histograms[digit*BucketCount + ((entry.key >> (digit*DigitBits)) & (BucketCount - 1))]++;
+            }
+        }
+
+        this->buffer.resize(count);
+
+        for (int digit=0; digit<DigitCount; digit++) {
+            int *histogram = &histograms[digit*BucketCount];
+            const int shift = digit*DigitBits;
+
+            // all the keys share this digit, so the pass wouldn't change anything
+            if (count == 0 || histogram[(this->entries[0].key >> shift) & (BucketCount - 1)] == count) {
+                continue;
+            }
+
+            int offset = 0;
+
+            for (int bucket=0; bucket<BucketCount; bucket++) {
+                const int bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+
+            for (const Entry &entry : this->entries) {
+                this->buffer[histogram[(entry.key >> shift) & (BucketCount - 1)]++] = entry;
+            }
+
+            this->entries.swap(this->buffer);
+        }
+    }
+
+    int RenderQueue::getItemCount() const {
+        return static_cast<int>(this->items.size());
+    }
+
+    const RenderItem& RenderQueue::getItem(int index) const {
+        assert(index >= 0 && index < this->getItemCount());
+
+        return this->items[this->entries[index].item];
+    }
+
+    std::uint64_t RenderQueue::getKey(int index) const {
+        assert(index >= 0 && index < this->getItemCount());
+
+        return this->entries[index].key;
+    }
+}}
@@ -0,0 +1,129 @@
+/**
+ * @file RenderQueue.hpp
+ * @brief Queue of draws, sorted to minimize the state changes between them.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_RENDERQUEUE_HPP__
+#define __EXENG_SCENEGRAPH_RENDERQUEUE_HPP__
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include <xe/Config.hpp>
+#include <xe/Enum.hpp>
+#include <xe/gfx/Forward.hpp>
+#include <xe/sg/Forward.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Groups of draws, submitted in this order.
+     */
+    struct RenderPass : public Enum {
+        enum Enum {
+            Setup,          //! Cameras and lights, in scene order, since they set the state of the following draws.
+            Opaque,         //! Sorted by material and subset, and then front to back.
+            Transparent     //! Sorted back to front, and then by material and subset.
+        };
+    };
+
+    /**
+     * @brief A single draw: a renderable, or one subset of a mesh, with the transformation of its node.
+     */
+    struct RenderItem {
+        Renderable *renderable = nullptr;
+
+        //! Index of the node in the TransformHierarchy of the scene.
+        int node = 0;
+
+        //! Index of the subset of the mesh, or -1 to render the whole renderable.
+        int subset = -1;
+
+        //! Material of the draw, if any.
+        const xe::gfx::Material *material = nullptr;
+    };
+
+    /**
+     * @brief Draws gathered from the scene, sorted by a 64 bit key with a radix sort.
+     *
+     * The key holds the pass in its two highest bits. The rest, from the highest to the lowest bits, is:
+     *  - Setup: the order in which the items were added.
+     *  - Opaque: material (14 bits), subset (16 bits), and depth (32 bits).
+     *  - Transparent: inverted depth (32 bits), material (14 bits) and subset (16 bits).
+     *
+     * The materials and subsets are identified by small numbers, given in order of appearance since the last
+     * clear, so the result is the same from one run to the next. The depth is stored as the bits of a positive
+     * float, that sort like the unsigned integers.
+     */
+    class EXENGAPI RenderQueue {
+    public:
+        enum {
+            MaxMaterialId = (1 << 14) - 1,
+            MaxSubsetId = (1 << 16) - 1
+        };
+
+        /**
+         * @brief Removes all the items and identifiers, keeping the memory for the next frame.
+         */
+        void clear();
+
+        /**
+         * @brief Get the number that identifies a material in the keys. The null material is always 0.
+         *
+         * When there are more materials than MaxMaterialId, the last ones share the same identifier, so their
+         * draws are still submitted, with more state changes.
+         */
+        int getMaterialId(const xe::gfx::Material *material);
+
+        /**
+         * @brief Get the number that identifies a mesh subset, or any other geometric data, in the keys.
+         */
+        int getSubsetId(const void *subset);
+
+        static std::uint64_t makeSetupKey(int sequence);
+
+        static std::uint64_t makeOpaqueKey(int materialId, int subsetId, float depth);
+
+        static std::uint64_t makeTransparentKey(int materialId, int subsetId, float depth);
+
+        void add(std::uint64_t key, const RenderItem &item);
+
+        /**
+         * @brief Sort the items by their keys. The items with the same key keep the order in which they were added.
+         */
+        void sort();
+
+        int getItemCount() const;
+
+        /**
+         * @brief Get an item, in sorted order after the call to sort.
+         */
+        const RenderItem& getItem(int index) const;
+
+        std::uint64_t getKey(int index) const;
+
+    private:
+        struct Entry {
+            std::uint64_t key;
+            int item;
+        };
+
+        std::vector<RenderItem> items;
+        std::vector<Entry> entries;
+        std::vector<Entry> buffer;
+
+        std::unordered_map<const void*, int> materialIds;
+        std::unordered_map<const void*, int> subsetIds;
+    };
+}}
+
+#endif  //__EXENG_SCENEGRAPH_RENDERQUEUE_HPP__
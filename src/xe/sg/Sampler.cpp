@@ -0,0 +1,317 @@
+/**
+ * @file Sampler.cpp
+ * @brief Implementation of the stateless sample generators.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/Sampler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace xe { namespace sg {
+
+    //! The largest float below one.
+    static const float OneMinusEpsilon = 1.0f - std::numeric_limits<float>::epsilon() * 0.5f;
+
+    static const int Primes[HaltonSampler::MaxDimension * 2] = {
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+        59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131
+    };
+
+    inline std::uint32_t reverseBits(std::uint32_t x) {
+        x = (x << 16) | (x >> 16);
+        x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+        x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+        x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+        x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+
+        return x;
+    }
+
+    inline std::uint32_t hash(std::uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+
+        return x;
+    }
+
+    /**
+     * @brief Maps the bits of a 32 bit fraction to a float in [0, 1).
+     */
+    inline float toUnitFloat(std::uint32_t x) {
+        return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+    }
+
+    inline float wrapUnit(float value) {
+        value -= std::floor(value);
+
+        return value < 1.0f ? value : OneMinusEpsilon;
+    }
+
+    /**
+     * @brief Second dimension of the Sobol sequence, as a 32 bit fraction. The first one is the van der Corput sequence.
+     */
+    inline std::uint32_t sobolSecond(std::uint32_t index) {
+        std::uint32_t result = 0;
+
+        for (std::uint32_t direction = 1u << 31; index; index >>= 1, direction ^= direction >> 1) {
+            if (index & 1) {
+                result ^= direction;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Hash based Owen scrambling (Laine and Karras 2011, constants by Burley 2020), over the reversed bits.
+     */
+    inline std::uint32_t laineKarrasPermutation(std::uint32_t x, std::uint32_t seed) {
+        x ^= x * 0x3d20adeau;
+        x += seed;
+        x *= (seed >> 16) | 1;
+        x ^= x * 0x05526c56u;
+        x ^= x * 0x53a22864u;
+
+        return x;
+    }
+
+    inline std::uint32_t nestedUniformScramble(std::uint32_t x, std::uint32_t seed) {
+        return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+    }
+
+    /**
+     * @brief Owen scrambled Sobol point. The index is shuffled too, so the dimensions sharing the sequence
+     * don't get correlated.
+     */
+    inline xe::Vector2f sampleSobol(std::uint32_t index, std::uint32_t seed) {
+        index = nestedUniformScramble(index, seed);
+
+        const std::uint32_t x = nestedUniformScramble(reverseBits(index), hash(seed ^ 0x9e3779b9u));
+        const std::uint32_t y = nestedUniformScramble(sobolSecond(index), hash(seed ^ 0x7f4a7c15u));
+
+        return xe::Vector2f(toUnitFloat(x), toUnitFloat(y));
+    }
+
+    std::uint32_t hashSample(const xe::Vector2i &pixel, int dimension, std::uint32_t seed) {
+        std::uint32_t result = hash(static_cast<std::uint32_t>(dimension) + seed);
+
+        result = hash(result ^ static_cast<std::uint32_t>(pixel.x));
+        result = hash(result ^ static_cast<std::uint32_t>(pixel.y));
+
+        return result;
+    }
+
+    float radicalInverse(std::uint32_t index, int base) {
+        assert(base >= 2);
+
+        if (base == 2) {
+            return toUnitFloat(reverseBits(index));
+        }
+
+        const double invBase = 1.0 / base;
+
+        double result = 0.0;
+        double factor = invBase;
+
+        for (; index > 0; index /= base) {
+            result += (index % base) * factor;
+            factor *= invBase;
+        }
+
+        return std::min(static_cast<float>(result), OneMinusEpsilon);
+    }
+
+    Sampler::~Sampler() {}
+
+    HaltonSampler::HaltonSampler(std::uint32_t seed) : seed(seed) {}
+
+    xe::Vector2f HaltonSampler::sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const {
+        assert(sampleIndex >= 0);
+        assert(dimension >= 0 && dimension < MaxDimension);
+
+        const std::uint32_t index = static_cast<std::uint32_t>(sampleIndex);
+        const std::uint32_t rotation = hashSample(pixel, dimension, this->seed);
+
+        return xe::Vector2f (
+            wrapUnit(radicalInverse(index, Primes[2*dimension + 0]) + toUnitFloat(rotation)),
+            wrapUnit(radicalInverse(index, Primes[2*dimension + 1]) + toUnitFloat(hash(rotation)))
+        );
+    }
+
+    SobolSampler::SobolSampler(std::uint32_t seed) : seed(seed) {}
+
+    xe::Vector2f SobolSampler::sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const {
+        assert(sampleIndex >= 0);
+        assert(dimension >= 0);
+
+        return sampleSobol(static_cast<std::uint32_t>(sampleIndex), hashSample(pixel, dimension, this->seed));
+    }
+
+    /**
+     * @brief Builds a blue noise mask with the void and cluster method (Ulichney, 1993).
+     * @return The rank of each pixel of the tile.
+     */
+    static std::vector<std::uint16_t> generateBlueNoise(const int size, std::uint32_t seed) {
+        const int count = size * size;
+
+        // the gaussian filter is negligible beyond this distance
+        const int radius = 8;
+        const float sigma = 1.5f;
+
+        std::vector<float> filter((2*radius + 1) * (2*radius + 1));
+
+        for (int y=-radius; y<=radius; y++) {
+            for (int x=-radius; x<=radius; x++) {
+                filter[(y + radius)*(2*radius + 1) + x + radius] = std::exp(-(x*x + y*y) / (2.0f*sigma*sigma));
+            }
+        }
+
+        std::vector<bool> pattern(count, false);
+        std::vector<float> energy(count, 0.0f);
+
+        auto splat = [&](int index, float sign) {
+            const int px = index % size;
+            const int py = index / size;
+
+            for (int y=-radius; y<=radius; y++) {
+                for (int x=-radius; x<=radius; x++) {
+                    const int wx = (px + x + size) % size;
+                    const int wy = (py + y + size) % size;
+
+                    energy[wy*size + wx] += sign * filter[(y + radius)*(2*radius + 1) + x + radius];
+                }
+            }
+        };
+
+        auto add = [&](int index) {
+            pattern[index] = true;
+            splat(index, 1.0f);
+        };
+
+        auto remove = [&](int index) {
+            pattern[index] = false;
+            splat(index, -1.0f);
+        };
+
+        auto tightestCluster = [&]() {
+            int best = -1;
+
+            for (int i=0; i<count; i++) {
+                if (pattern[i] && (best == -1 || energy[i] > energy[best])) {
+                    best = i;
+                }
+            }
+
+            return best;
+        };
+
+        auto largestVoid = [&]() {
+            int best = -1;
+
+            for (int i=0; i<count; i++) {
+                if (!pattern[i] && (best == -1 || energy[i] < energy[best])) {
+                    best = i;
+                }
+            }
+
+            return best;
+        };
+
+        // initial random pattern, relaxed by moving points from the clusters to the voids
+        std::mt19937 engine(seed);
+        std::uniform_int_distribution<int> distribution(0, count - 1);
+
+        const int initialCount = count / 10;
+
+        for (int added=0; added<initialCount; ) {
+            const int index = distribution(engine);
+
+            if (!pattern[index]) {
+                add(index);
+                added++;
+            }
+        }
+
+        for (;;) {
+            const int cluster = tightestCluster();
+            remove(cluster);
+
+            const int hole = largestVoid();
+            add(hole);
+
+            if (hole == cluster) {
+                break;
+            }
+        }
+
+        std::vector<std::uint16_t> ranks(count, 0);
+
+        const std::vector<bool> initialPattern = pattern;
+        const std::vector<float> initialEnergy = energy;
+
+        // the points of the initial pattern get the lowest ranks, removing first the most clustered ones
+        for (int rank=initialCount - 1; rank>=0; rank--) {
+            const int cluster = tightestCluster();
+            remove(cluster);
+
+            ranks[cluster] = static_cast<std::uint16_t>(rank);
+        }
+
+        // the remaining ones, filling the largest voids
+        pattern = initialPattern;
+        energy = initialEnergy;
+
+        for (int rank=initialCount; rank<count; rank++) {
+            const int hole = largestVoid();
+            add(hole);
+
+            ranks[hole] = static_cast<std::uint16_t>(rank);
+        }
+
+        return ranks;
+    }
+
+    BlueNoiseSampler::BlueNoiseSampler(std::uint32_t seed) : seed(seed) {
+        this->mask = generateBlueNoise(TileSize, seed);
+    }
+
+    float BlueNoiseSampler::getMaskValue(int x, int y) const {
+        x = ((x % TileSize) + TileSize) % TileSize;
+        y = ((y % TileSize) + TileSize) % TileSize;
+
+        return (this->mask[y*TileSize + x] + 0.5f) / (TileSize * TileSize);
+    }
+
+    xe::Vector2f BlueNoiseSampler::sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const {
+        assert(sampleIndex >= 0);
+        assert(dimension >= 0);
+
+        // all the pixels share the sequence, and each one rotates it by the mask. Each coordinate
+        // reads the mask with a different offset, so they remain uncorrelated.
+        const std::uint32_t dimensionSeed = hash(static_cast<std::uint32_t>(dimension) + this->seed);
+        const xe::Vector2f point = sampleSobol(static_cast<std::uint32_t>(sampleIndex), dimensionSeed);
+
+        const std::uint32_t offsetX = hash(dimensionSeed);
+        const std::uint32_t offsetY = hash(offsetX);
+
+        const float rotationX = this->getMaskValue(pixel.x + (offsetX & 0xffff), pixel.y + (offsetX >> 16));
+        const float rotationY = this->getMaskValue(pixel.x + (offsetY & 0xffff), pixel.y + (offsetY >> 16));
+
+        return xe::Vector2f(wrapUnit(point.x + rotationX), wrapUnit(point.y + rotationY));
+    }
+}}
@@ -0,0 +1,118 @@
+/**
+ * @file Sampler.hpp
+ * @brief Stateless sample generators for antialiasing and Monte Carlo integration.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_SAMPLER_HPP__
+#define __EXENG_SCENEGRAPH_SAMPLER_HPP__
+
+#include <cstdint>
+#include <vector>
+
+#include <xe/Config.hpp>
+#include <xe/Vector.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Generator of sample points in the unit square.
+     *
+     * The samples are a pure function of the pixel, the index of the sample inside the pixel, and the
+     * dimension, that selects an independent pair of coordinates (for example, the position inside the
+     * pixel, and then the position over an area light). There is no state shared between the calls, so
+     * a single sampler can be used by all the rendering threads at once.
+     *
+     * The sequences of the different pixels are decorrelated, so no structured patterns appear in the image.
+     */
+    class EXENGAPI Sampler {
+    public:
+        virtual ~Sampler();
+
+        /**
+         * @brief Get the sample of the specified pixel, index and dimension, in the range [0, 1).
+         */
+        virtual xe::Vector2f sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const = 0;
+    };
+
+    /**
+     * @brief Halton sequence, with a pair of prime bases for each dimension. Each pixel gets a different
+     * toroidal shift (Cranley-Patterson rotation) of the whole sequence.
+     */
+    class EXENGAPI HaltonSampler : public Sampler {
+    public:
+        //! Number of dimensions available, limited by the table of prime bases.
+        static const int MaxDimension = 16;
+
+        explicit HaltonSampler(std::uint32_t seed = 0);
+
+        virtual xe::Vector2f sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const override;
+
+    private:
+        std::uint32_t seed;
+    };
+
+    /**
+     * @brief Two dimensional Sobol sequence with hash based Owen scrambling (Burley, 2020).
+     *
+     * Every dimension uses the same (0,2)-sequence, shuffled and scrambled with different seeds, so the
+     * first 2^k samples of each pixel always have one point in each elementary interval of the square.
+     */
+    class EXENGAPI SobolSampler : public Sampler {
+    public:
+        explicit SobolSampler(std::uint32_t seed = 0);
+
+        virtual xe::Vector2f sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const override;
+
+    private:
+        std::uint32_t seed;
+    };
+
+    /**
+     * @brief Sobol sequence rotated in each pixel by the values of a tiled blue noise mask
+     * (Georgiev and Fajardo, 2016).
+     *
+     * The error of neighbouring pixels becomes negatively correlated, so at low sample counts the noise
+     * is pushed to high frequencies, where it is less visible.
+     */
+    class EXENGAPI BlueNoiseSampler : public Sampler {
+    public:
+        //! Side, in pixels, of the square blue noise mask repeated over the image.
+        static const int TileSize = 64;
+
+        explicit BlueNoiseSampler(std::uint32_t seed = 0);
+
+        virtual xe::Vector2f sample(const xe::Vector2i &pixel, int sampleIndex, int dimension) const override;
+
+        /**
+         * @brief Get the value of the blue noise mask at the specified pixel of the tile, in the range [0, 1).
+         */
+        float getMaskValue(int x, int y) const;
+
+    private:
+        std::uint32_t seed;
+
+        //! Rank of each pixel of the tile, in the void and cluster ordering.
+        std::vector<std::uint16_t> mask;
+    };
+
+    /**
+     * @brief Hash of the coordinates of a pixel, a dimension and a seed, with good avalanche.
+     * Used to decorrelate the sequences of the pixels.
+     */
+    extern EXENGAPI std::uint32_t hashSample(const xe::Vector2i &pixel, int dimension, std::uint32_t seed);
+
+    /**
+     * @brief Radical inverse of the index, in the specified base. The base two case is exact.
+     */
+    extern EXENGAPI float radicalInverse(std::uint32_t index, int base);
+}}
+
+#endif  //__EXENG_SCENEGRAPH_SAMPLER_HPP__
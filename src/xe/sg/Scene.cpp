@@ -14,8 +14,15 @@
 
 #include "Scene.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
 #include <xe/Vector.hpp>
 #include <xe/sg/SceneNode.hpp>
+#include <xe/sg/InstanceBVH.hpp>
 
 namespace xe { namespace sg {
     using namespace xe;
@@ -24,10 +31,114 @@ namespace xe { namespace sg {
     struct Scene::Private {
         Vector4f backColor = {0.0f, 0.0f, 0.0f, 1.0f};
         SceneNodePtr rootNode = std::make_unique<SceneNode>();
+
+        //! World transformations of the nodes, rebuilt when the node tree changes.
+        TransformHierarchy hierarchy;
+        bool hierarchyOutdated = true;
+        std::mutex hierarchyMutex;
+
+        //! Ray query acceleration structure, along with the hierarchy index of the node of each instance.
+        InstanceBVH bvh;
+        std::vector<int> instanceNodes;
+        std::atomic<bool> structureChanged = {true};
+        std::atomic<bool> transformChanged = {false};
+        std::mutex bvhMutex;
+
+        //! Nodes of the scene by name, in the order they were indexed. The unnamed ones are left out.
+        std::unordered_map<std::string, std::vector<SceneNode*>> nameIndex;
+        std::mutex nameMutex;
+
+        void indexName(SceneNode *node, const std::string &name) {
+            if (!name.empty()) {
+                this->nameIndex[name].push_back(node);
+            }
+        }
+
+        void unindexName(SceneNode *node, const std::string &name) {
+            auto indexIt = this->nameIndex.find(name);
+
+            if (indexIt == this->nameIndex.end()) {
+                return;
+            }
+
+            std::vector<SceneNode*> &nodes = indexIt->second;
+            auto nodeIt = std::find(nodes.begin(), nodes.end(), node);
+
+            // keeps the order of the remaining nodes
+            if (nodeIt != nodes.end()) {
+                nodes.erase(nodeIt);
+            }
+
+            if (nodes.empty()) {
+                this->nameIndex.erase(indexIt);
+            }
+        }
+
+        void indexSubtree(SceneNode *node, bool attached) {
+            if (attached) {
+                this->indexName(node, node->getName());
+            } else {
+                this->unindexName(node, node->getName());
+            }
+
+            for (int i=0; i<node->getChildCount(); i++) {
+                this->indexSubtree(node->getChild(i), attached);
+            }
+        }
+
+        void updateHierarchy() {
+            std::lock_guard<std::mutex> lock(this->hierarchyMutex);
+
+            if (this->hierarchyOutdated) {
+                this->hierarchy.build(this->rootNode.get());
+                this->hierarchyOutdated = false;
+            } else {
+                this->hierarchy.update();
+            }
+        }
+
+        void updateBVH() {
+            if (!this->structureChanged && !this->transformChanged) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(this->bvhMutex);
+
+            this->updateHierarchy();
+
+            // the flags are cleared only once the hierarchy is ready, for the other querying threads
+            if (this->structureChanged) {
+                this->bvh.clear();
+                this->instanceNodes.clear();
+
+                for (int index=0; index<this->hierarchy.getNodeCount(); index++) {
+                    if (Geometry *geometry = dynamic_cast<Geometry*>(this->hierarchy.getNode(index)->getRenderable())) {
+                        this->bvh.add(geometry, this->hierarchy.getWorldTransform(index));
+                        this->instanceNodes.push_back(index);
+                    }
+                }
+
+                this->bvh.build();
+
+                this->structureChanged = false;
+                this->transformChanged = false;
+
+            } else if (this->transformChanged) {
+                // same hierarchy, so only the transformations of the instances change
+                for (std::size_t instance=0; instance<this->instanceNodes.size(); instance++) {
+                    this->bvh.setTransform(static_cast<int>(instance), this->hierarchy.getWorldTransform(this->instanceNodes[instance]));
+                }
+
+                this->bvh.refit();
+
+                this->transformChanged = false;
+            }
+        }
     };
     
     Scene::Scene() {
 		impl = new Scene::Private();
+		impl->rootNode->setScene(this);
 	}
 
     Scene::~Scene() {
@@ -53,4 +164,167 @@ namespace xe { namespace sg {
         assert(impl);
         return impl->backColor;
     }
+
+    bool Scene::intersect(const Ray &ray, IntersectInfo *intersectInfo) const {
+        assert(impl);
+
+        impl->updateBVH();
+
+        return impl->bvh.intersect(ray, intersectInfo);
+    }
+
+    bool Scene::occluded(const Ray &ray) const {
+        assert(impl);
+
+        impl->updateBVH();
+
+        return impl->bvh.occluded(ray);
+    }
+
+    const TransformHierarchy& Scene::getTransformHierarchy() const {
+        assert(impl);
+
+        impl->updateHierarchy();
+
+        return impl->hierarchy;
+    }
+
+    Matrix4f Scene::getWorldTransform(const SceneNode *node) const {
+        assert(impl);
+        assert(node);
+        assert(node->getScene() == this);
+
+        impl->updateHierarchy();
+
+        return impl->hierarchy.getWorldTransform(node->getHierarchyIndex());
+    }
+
+    void Scene::setSplitDepth(int depth) {
+        assert(impl);
+
+        std::lock_guard<std::mutex> lock(impl->hierarchyMutex);
+
+        impl->hierarchy.setSplitDepth(depth);
+    }
+
+    int Scene::getSplitDepth() const {
+        assert(impl);
+
+        std::lock_guard<std::mutex> lock(impl->hierarchyMutex);
+
+        return impl->hierarchy.getSplitDepth();
+    }
+
+    SceneNode* Scene::findNode(const std::string &name) {
+        assert(impl);
+
+        return impl->rootNode->findNode(name);
+    }
+
+    const SceneNode* Scene::findNode(const std::string &name) const {
+        assert(impl);
+
+        return impl->rootNode->findNode(name);
+    }
+
+    SceneNode* Scene::findNodeByPath(const std::string &path) {
+        const Scene *scene = this;
+
+        return const_cast<SceneNode*>(scene->findNodeByPath(path));
+    }
+
+    const SceneNode* Scene::findNodeByPath(const std::string &path) const {
+        assert(impl);
+
+        const SceneNode *node = impl->rootNode.get();
+
+        std::size_t begin = 0;
+
+        while (node && begin < path.size()) {
+            std::size_t end = path.find('/', begin);
+
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+
+            // skips the empty steps, like a leading '/'
+            if (end > begin) {
+                node = node->getChild(path.substr(begin, end - begin));
+            }
+
+            begin = end + 1;
+        }
+
+        return node;
+    }
+
+    const SceneNode* Scene::findNode(const std::string &name, const SceneNode *root) const {
+        assert(impl);
+        assert(root);
+
+        std::lock_guard<std::mutex> lock(impl->nameMutex);
+
+        auto indexIt = impl->nameIndex.find(name);
+
+        if (indexIt == impl->nameIndex.end()) {
+            return nullptr;
+        }
+
+        // all the indexed nodes are inside of the subtree of the scene root
+        if (root == impl->rootNode.get()) {
+            return indexIt->second.front();
+        }
+
+        for (const SceneNode *node : indexIt->second) {
+            const SceneNode *ancestor = node;
+
+            while (ancestor && ancestor != root) {
+                ancestor = ancestor->getParent();
+            }
+
+            if (ancestor) {
+                return node;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Scene::notifyAttach(SceneNode *node, bool attached) {
+        assert(impl);
+        assert(node);
+
+        std::lock_guard<std::mutex> lock(impl->nameMutex);
+
+        impl->indexSubtree(node, attached);
+    }
+
+    void Scene::notifyRename(SceneNode *node, const std::string &previousName) {
+        assert(impl);
+        assert(node);
+
+        std::lock_guard<std::mutex> lock(impl->nameMutex);
+
+        impl->unindexName(node, previousName);
+        impl->indexName(node, node->getName());
+    }
+
+    void Scene::notifyChange(SceneNode *node, bool structural) {
+        assert(impl);
+        assert(node);
+
+        std::lock_guard<std::mutex> lock(impl->hierarchyMutex);
+
+        if (structural) {
+            impl->hierarchyOutdated = true;
+            impl->structureChanged = true;
+        } else {
+            // while the hierarchy is outdated the node indices aren't valid, and everything is computed again anyway
+            if (!impl->hierarchyOutdated) {
+                impl->hierarchy.setDirty(node->getHierarchyIndex());
+            }
+
+            impl->transformChanged = true;
+        }
+    }
 }}
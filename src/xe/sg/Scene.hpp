@@ -21,6 +21,9 @@
 #include <xe/sg/SceneNode.hpp>
 #include <xe/sg/Light.hpp>
 #include <xe/sg/Camera.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/IntersectInfo.hpp>
+#include <xe/sg/TransformHierarchy.hpp>
 
 namespace xe { namespace sg { 
     /**
@@ -45,6 +48,78 @@ namespace xe { namespace sg {
          */
         Vector4f getBackColor() const;
 
+        /**
+         * @brief Find the closest intersection between the ray and the geometries of the scene, in world space.
+         *
+         * The query runs over a two level BVH, built from the scene nodes the first time it's needed.
+         * Transformation changes only refit the hierarchy; adding, removing or replacing nodes and 
+         * renderables rebuilds it.
+         */
+        bool intersect(const Ray &ray, IntersectInfo *intersectInfo) const;
+
+        /**
+         * @brief Check if the ray intersects some geometry of the scene, between its minimum and maximum distances.
+         *
+         * Cheaper than intersect, because the query ends at the first intersection found. Useful for shadow rays.
+         */
+        bool occluded(const Ray &ray) const;
+
+        /**
+         * @brief Get the nodes of the scene in depth first order, with their world transformations up to date.
+         *
+         * Only the nodes whose transformation has changed since the last call, and their descendants, are
+         * recomputed, so a static scene costs nothing. Adding or removing nodes rebuilds the hierarchy. 
+         * The reference is valid until the scene is modified.
+         */
+        const TransformHierarchy& getTransformHierarchy() const;
+
+        /**
+         * @brief Get the transformation from the local space of a node of the scene to the world space.
+         */
+        Matrix4f getWorldTransform(const SceneNode *node) const;
+
+        /**
+         * @brief Set the depth of the nodes whose subtrees have their transformations and boxes updated in parallel.
+         * See TransformHierarchy::setSplitDepth.
+         */
+        void setSplitDepth(int depth);
+
+        int getSplitDepth() const;
+
+        /**
+         * @brief Find a node of the scene by its name. 
+         *
+         * The nodes are looked up in a hash index, kept up to date as they are added, removed and renamed.
+         * When many nodes share the name, the one that got it first within the scene is returned: the nodes
+         * are indexed when they are added or renamed, and the nodes of an added subtree in depth first order.
+         */
+        SceneNode* findNode(const std::string &name);
+        const SceneNode* findNode(const std::string &name) const;
+
+        /**
+         * @brief Find a node from the names of the nodes in the way from the root, separated by '/', 
+         * like "level/enemies/boss". Each step is a lookup in the child index of a node.
+         */
+        SceneNode* findNodeByPath(const std::string &path);
+        const SceneNode* findNodeByPath(const std::string &path) const;
+
+    private:
+        friend class SceneNode;
+
+        void notifyChange(SceneNode *node, bool structural);
+
+        /**
+         * @brief Add the names of a subtree to the index, when it's attached to the scene, or remove them when it's detached.
+         */
+        void notifyAttach(SceneNode *node, bool attached);
+
+        void notifyRename(SceneNode *node, const std::string &previousName);
+
+        /**
+         * @brief Find the first indexed node with the given name inside of the subtree of the root.
+         */
+        const SceneNode* findNode(const std::string &name, const SceneNode *root) const;
+
     private:
         struct Private;
         Private* impl = nullptr;
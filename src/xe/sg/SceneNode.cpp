@@ -12,9 +12,14 @@
  */
 
 #include "SceneNode.hpp"
+#include "Scene.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <vector>
+#include <unordered_map>
+#include <xe/MemoryPool.hpp>
 #include <boost/checked_delete.hpp>
 #include <boost/range/algorithm/find.hpp>
 
@@ -29,14 +34,144 @@ namespace xe { namespace sg {
     //! SceneNode private data
     struct SceneNode::Private {
         std::string name;
-        Matrix4f transform = xe::identity<float, 4>();
+        mutable Matrix4f transform = xe::identity<float, 4>();
+        mutable bool transformOutdated = false;	//! The components have changed since the matrix was built.
+        Transformf components;
+        bool componentsValid = true;			//! False when the transformation was set as a matrix.
         SceneNode* parent = nullptr;
         Renderable *renderable = nullptr;
 		SceneNodePtrVector childs;
+		std::unordered_map<std::string, SceneNode*> childIndex;	//! First child with each name. The unnamed ones are left out.
+		Scene *scene = nullptr;		//! Owner scene. Only set on the root node.
+		Pool *pool = nullptr;		//! Memory pool of the nodes created in the scene. Only set on the root node of a scene.
+		int hierarchyIndex = -1;	//! Position in the TransformHierarchy of the scene.
+
+		static void* operator new(std::size_t size);
+		static void* operator new(std::size_t size, Pool *pool);
+		static void operator delete(void *pointer);
+		static void operator delete(void *pointer, Pool *pool);
+
+		void indexChild(SceneNode *child) {
+			if (!child->impl->name.empty()) {
+				childIndex.emplace(child->impl->name, child);
+			}
+		}
+
+		void unindexChild(SceneNode *child) {
+			const std::string &name = child->impl->name;
+
+			auto indexIt = childIndex.find(name);
+
+			if (indexIt == childIndex.end() || indexIt->second != child) {
+				return;
+			}
+
+			childIndex.erase(indexIt);
+
+			// the next child with the same name, if any, takes its place
+			for (const SceneNodePtr &other : childs) {
+				if (other && other.get() != child && other->impl->name == name) {
+					childIndex.emplace(name, other.get());
+					break;
+				}
+			}
+		}
     };
 }}
 
 namespace xe { namespace sg {
+
+	/**
+	 * @brief Memory pools of the nodes created in a scene, and of their private data.
+	 *
+	 * Each block starts with a header that points to the pool that allocated it, or null for the blocks
+	 * taken from the heap, so a node can be deleted without knowing its scene. Every allocated block holds
+	 * a reference to the pool, like the scene does, and the last one to go releases all the slabs at once.
+	 */
+	struct SceneNode::Pool {
+		static const std::size_t HeaderSize = alignof(std::max_align_t);
+
+		static_assert(sizeof(Pool*) <= HeaderSize, "The block header must hold a pointer to the pool");
+
+		MemoryPool<HeaderSize + sizeof(SceneNode)> nodes;
+		MemoryPool<HeaderSize + sizeof(SceneNode::Private)> privates;
+		std::atomic<int> references = {1};
+
+		void release() {
+			if (--this->references == 0) {
+				delete this;
+			}
+		}
+
+		template<typename BlockPool>
+		static void* allocate(Pool *pool, BlockPool Pool::*blocks, std::size_t size) {
+			void *block = nullptr;
+
+			if (pool) {
+				block = (pool->*blocks).allocate();
+				pool->references++;
+			} else {
+				block = ::operator new(HeaderSize + size);
+			}
+
+			*static_cast<Pool**>(block) = pool;
+
+			return static_cast<char*>(block) + HeaderSize;
+		}
+
+		template<typename BlockPool>
+		static void deallocate(void *pointer, BlockPool Pool::*blocks) {
+			if (!pointer) {
+				return;
+			}
+
+			void *block = static_cast<char*>(pointer) - HeaderSize;
+			Pool *pool = *static_cast<Pool**>(block);
+
+			if (!pool) {
+				::operator delete(block);
+				return;
+			}
+
+			(pool->*blocks).deallocate(block);
+			pool->release();
+		}
+	};
+
+	void* SceneNode::operator new(std::size_t size) {
+		return Pool::allocate(nullptr, &Pool::nodes, size);
+	}
+
+	void* SceneNode::operator new(std::size_t size, Pool *pool) {
+		// the derived classes have another size
+		assert(size == sizeof(SceneNode));
+
+		return Pool::allocate(pool, &Pool::nodes, size);
+	}
+
+	void SceneNode::operator delete(void *pointer) {
+		Pool::deallocate(pointer, &Pool::nodes);
+	}
+
+	void SceneNode::operator delete(void *pointer, Pool *) {
+		Pool::deallocate(pointer, &Pool::nodes);
+	}
+
+	void* SceneNode::Private::operator new(std::size_t size) {
+		return Pool::allocate(nullptr, &Pool::privates, size);
+	}
+
+	void* SceneNode::Private::operator new(std::size_t size, Pool *pool) {
+		return Pool::allocate(pool, &Pool::privates, size);
+	}
+
+	void SceneNode::Private::operator delete(void *pointer) {
+		Pool::deallocate(pointer, &Pool::privates);
+	}
+
+	void SceneNode::Private::operator delete(void *pointer, Pool *) {
+		Pool::deallocate(pointer, &Pool::privates);
+	}
         
     SceneNode::SceneNode(const std::string& name, SceneNode *parent, Renderable* renderable) {
         impl = new SceneNode::Private();
@@ -46,8 +181,19 @@ namespace xe { namespace sg {
 		this->setRenderable(renderable);
     }
 
+    SceneNode::SceneNode(Pool *pool) {
+        impl = new (pool) SceneNode::Private();
+    }
+
     SceneNode::~SceneNode() {
+        Pool *pool = impl->pool;
+
+        // the children go back to the pool before it's released
         boost::checked_delete(impl);
+
+        if (pool) {
+            pool->release();
+        }
     }
     
     std::string SceneNode::toString() const {
@@ -64,6 +210,11 @@ namespace xe { namespace sg {
     Matrix4f SceneNode::getTransform() const {
         assert(impl);
 
+        if (impl->transformOutdated) {
+            impl->transform = impl->components.toMatrix();
+            impl->transformOutdated = false;
+        }
+
         return impl->transform;
     }
 
@@ -71,6 +222,30 @@ namespace xe { namespace sg {
         assert(impl);
 
         impl->transform = transform;
+        impl->transformOutdated = false;
+        impl->componentsValid = false;
+
+		this->notifyChange(false);
+    }
+
+    void SceneNode::setTransform(const Transformf& transform) {
+        assert(impl);
+
+        impl->components = transform;
+        impl->componentsValid = true;
+        impl->transformOutdated = true;
+
+		this->notifyChange(false);
+    }
+
+    Transformf SceneNode::getTransformComponents() const {
+        assert(impl);
+
+        if (impl->componentsValid) {
+            return impl->components;
+        } else {
+            return Transformf(impl->transform);
+        }
     }
 
     std::string SceneNode::getName() const {
@@ -86,7 +261,28 @@ namespace xe { namespace sg {
             assert(this->getParent() && !this->getParent()->getChild(name));
         }
         
+        if (impl->name == name) {
+            return;
+        }
+
+        SceneNode *parent = this->getParent();
+        Scene *scene = this->getScene();
+
+        const std::string previousName = impl->name;
+
+        if (parent) {
+            parent->impl->unindexChild(this);
+        }
+
         impl->name = name;
+
+        if (parent) {
+            parent->impl->indexChild(this);
+        }
+
+        if (scene) {
+            scene->notifyRename(this, previousName);
+        }
     }
 
     int SceneNode::getChildCount() const {
@@ -102,18 +298,22 @@ namespace xe { namespace sg {
     SceneNode* SceneNode::getChild(const std::string& name) const {
         assert(impl);
 
-		auto &childs = impl->childs;
-		auto childIt = std::find_if(childs.begin(), childs.end(), [name](const SceneNodePtr& child) {
-			return child.get()->getName() == name;
-		});
+		if (name.empty()) {
+			auto &childs = impl->childs;
+			auto childIt = std::find_if(childs.begin(), childs.end(), [](const SceneNodePtr& child) {
+				return child && child->getName().empty();
+			});
+
+			return childIt != childs.end() ? childIt->get() : nullptr;
+		}
 
-		SceneNode *child = nullptr;
+		auto indexIt = impl->childIndex.find(name);
 
-		if (childIt != childs.end()) {
-			child = childIt->get();
+		if (indexIt == impl->childIndex.end()) {
+			return nullptr;
 		}
 
-		return child;
+		return indexIt->second;
     }
 
     SceneNode* SceneNode::getParent() const {
@@ -129,7 +329,13 @@ namespace xe { namespace sg {
 
 		// remove from previous parent
 		if (this->impl->parent) {
-			auto &childs = parent->impl->childs;
+			if (Scene *scene = this->getScene()) {
+				scene->notifyAttach(this, false);
+			}
+
+			this->impl->parent->impl->unindexChild(this);
+
+			auto &childs = this->impl->parent->impl->childs;
 			auto childIt = std::find_if(childs.begin(), childs.end(), [this](const SceneNodePtr &child) {
 				return child.get() == this;
 			});
@@ -140,12 +346,22 @@ namespace xe { namespace sg {
 			childs.erase(childIt);
 		}
 
+		if (this->impl->parent) {
+			this->impl->parent->notifyChange(true);
+		}
+
 		// update current parent
 		this->impl->parent = parent;
 
 		// append to new parent
 		if (parent) {
 			parent->impl->childs.push_back(std::move(this_));
+			parent->impl->indexChild(this);
+			parent->notifyChange(true);
+
+			if (Scene *scene = this->getScene()) {
+				scene->notifyAttach(this, true);
+			}
 
 		} else {
 			this_.release();
@@ -157,6 +373,12 @@ namespace xe { namespace sg {
 			return this;
 		}
 
+		const Scene *scene = this->getScene();
+
+		if (scene && !name.empty()) {
+			return scene->findNode(name, this);
+		}
+
 		for (int i=0; i<this->getChildCount(); i++) {
 			const SceneNode *node = this->getChild(i)->findNode(name);
 
@@ -185,10 +407,34 @@ namespace xe { namespace sg {
 
 		child->impl->parent = this;
 		this->impl->childs.push_back(std::move(child));
+		this->impl->indexChild(node);
+
+		this->notifyChange(true);
+
+		if (Scene *scene = this->getScene()) {
+			scene->notifyAttach(node, true);
+		}
 
 		return node;
     }
 
+	SceneNode* SceneNode::addChild(const xe::Matrix4f &transformation, xe::sg::Renderable *renderable) {
+		const SceneNode *root = this;
+
+		while (root->getParent()) {
+			root = root->getParent();
+		}
+
+		Pool *pool = root->impl->pool;
+
+		SceneNodePtr sceneNode(new (pool) SceneNode(pool));
+
+		sceneNode->setTransform(transformation);
+		sceneNode->setRenderable(renderable);
+
+		return this->addChild(std::move(sceneNode));
+	}
+
     SceneNodePtr SceneNode::removeChild(SceneNode* child) {
         assert(impl);
 		assert(child);
@@ -204,12 +450,20 @@ namespace xe { namespace sg {
 
 		assert(childIt != childs.end());
 
+		if (Scene *scene = this->getScene()) {
+			scene->notifyAttach(child, false);
+		}
+
+		impl->unindexChild(child);
+
 		node = std::move(*childIt);
 		
 		childs.erase(childIt);
 
 		node->impl->parent = nullptr;
 
+		this->notifyChange(true);
+
 		return node;
     }
 	
@@ -217,6 +471,8 @@ namespace xe { namespace sg {
 		assert(impl);
 
 		impl->renderable = renderable;
+
+		this->notifyChange(true);
 	}
 
 	Renderable* SceneNode::getRenderable() {
@@ -230,4 +486,47 @@ namespace xe { namespace sg {
 
 		return impl->renderable;
 	}
+
+	Scene* SceneNode::getScene() const {
+		assert(impl);
+
+		const SceneNode *root = this;
+
+		while (root->getParent()) {
+			root = root->getParent();
+		}
+
+		return root->impl->scene;
+	}
+
+	void SceneNode::setScene(Scene *scene) {
+		assert(impl);
+		assert(!this->getParent());
+
+		impl->scene = scene;
+
+		if (scene && !impl->pool) {
+			impl->pool = new Pool();
+		}
+	}
+
+	int SceneNode::getHierarchyIndex() const {
+		assert(impl);
+
+		return impl->hierarchyIndex;
+	}
+
+	void SceneNode::setHierarchyIndex(int index) {
+		assert(impl);
+
+		impl->hierarchyIndex = index;
+	}
+
+	void SceneNode::notifyChange(bool structural) {
+		Scene *scene = this->getScene();
+
+		if (scene) {
+			scene->notifyChange(this, structural);
+		}
+	}
 }}
@@ -21,6 +21,7 @@
 
 #include <xe/Object.hpp>
 #include <xe/Matrix.hpp>
+#include <xe/Transform.hpp>
 #include <xe/Collection.hpp>
 #include <xe/sg/Forward.hpp>
 
@@ -46,10 +47,35 @@ namespace xe { namespace sg {
 
         virtual ~SceneNode();
 
+        /**
+         * @brief The nodes created with addChild(transformation, renderable) inside of a scene are allocated, 
+         * along with their private data, from a memory pool owned by the scene. The other ones come from the heap.
+         */
+        static void* operator new(std::size_t size);
+        static void operator delete(void *pointer);
+
         virtual std::string toString() const override;
         
+        /**
+         * @brief Get the transformation relative to the parent node. 
+         *
+         * When it was set by components, the matrix is built here, the first time it's requested.
+         */
         xe::Matrix4f getTransform() const;
         void setTransform(const xe::Matrix4f& transform);
+
+        /**
+         * @brief Set the transformation from its translation, rotation and scale. 
+         *
+         * Cheaper than a matrix for the animators, that can update a single component and interpolate them.
+         */
+        void setTransform(const xe::Transformf& transform);
+
+        /**
+         * @brief Get the transformation as its components. If it was set as a matrix, it's decomposed, 
+         * discarding any shear.
+         */
+        xe::Transformf getTransformComponents() const;
         
         std::string getName() const;
         void setName(const std::string &name);
@@ -63,22 +89,62 @@ namespace xe { namespace sg {
 
         int getChildCount() const;
         SceneNode* getChild(int index) const;
+
+        /**
+         * @brief Get the first child added with the given name, from a hash index of the children.
+         */
         SceneNode* getChild(const std::string &name) const;
         
+        /**
+         * @brief Find a node with the given name, starting from this one.
+         *
+         * Within a scene, the candidates come from the name index of the scene, so the search doesn't 
+         * visit the whole subtree, and the ties are resolved like in Scene::findNode. Outside of a scene, 
+         * the first node in depth first order is returned. The unnamed nodes aren't indexed.
+         */
         const SceneNode* findNode(const std::string &name) const;
 		SceneNode* findNode(const std::string &name);
         
         SceneNode* addChild(SceneNodePtr child);
         SceneNodePtr removeChild(SceneNode* child);
 
-		SceneNode* addChild(const xe::Matrix4f &transformation, xe::sg::Renderable *renderable) {
-			auto sceneNode = std::make_unique<SceneNode>();
+		/**
+		 * @brief Create a child node. Inside of a scene, it's allocated from the memory pool of the scene, so the
+		 * nodes created together are contiguous in memory.
+		 */
+		SceneNode* addChild(const xe::Matrix4f &transformation, xe::sg::Renderable *renderable);
+
+		/**
+		 * @brief Get the Scene that owns the node hierarchy, if any.
+		 */
+		Scene* getScene() const;
+
+    private:
+		friend class Scene;
+		friend class TransformHierarchy;
+
+		struct Pool;
+
+		explicit SceneNode(Pool *pool);
+
+		static void* operator new(std::size_t size, Pool *pool);
+		static void operator delete(void *pointer, Pool *pool);
+
+		/**
+		 * @brief Set the scene that owns the hierarchy, on its root node. The root node creates the node pool of the scene.
+		 */
+		void setScene(Scene *scene);
 
-			sceneNode->setTransform(transformation);
-			sceneNode->setRenderable(renderable);
+		/**
+		 * @brief Position of the node in the TransformHierarchy of its scene, set when the hierarchy is built.
+		 */
+		int getHierarchyIndex() const;
+		void setHierarchyIndex(int index);
 
-			return this->addChild(std::move(sceneNode));
-		}
+		/**
+		 * @brief Notify the owner Scene (if any) that the node hierarchy has been modified.
+		 */
+		void notifyChange(bool structural);
 
     private:
         struct Private;
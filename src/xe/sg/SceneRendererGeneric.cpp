@@ -5,6 +5,10 @@
 #include <xe/sg/Scene.hpp>
 #include <xe/sg/SceneNode.hpp>
 #include <xe/sg/Renderable.hpp>
+#include <xe/sg/Camera.hpp>
+#include <xe/sg/Light.hpp>
+#include <xe/gfx/Mesh.hpp>
+#include <xe/sys/ThreadPool.hpp>
 
 namespace xe { namespace sg {
 
@@ -37,40 +41,255 @@ namespace xe { namespace sg {
 		this->renderer = renderer;
 	}
 
+	void SceneRendererGeneric::setCamera(xe::sg::Camera *camera) {
+		this->camera = camera;
+	}
+
+	xe::sg::Camera* SceneRendererGeneric::getCamera() const {
+		return this->camera;
+	}
+
+	const SceneRenderStats& SceneRendererGeneric::getStats() const {
+		return this->stats;
+	}
+
+	void SceneRendererGeneric::setSplitDepth(int depth) {
+		assert(depth >= 0);
+
+		this->splitDepth = depth;
+	}
+
+	int SceneRendererGeneric::getSplitDepth() const {
+		return this->splitDepth;
+	}
+
+	void SceneRendererGeneric::setTransparencyTest(std::function<bool (const xe::gfx::Material*)> transparencyTest) {
+		this->transparencyTest = transparencyTest;
+	}
+
 	void SceneRendererGeneric::renderScene() {
 		assert(scene);
 
-		xe::sg::TransformationStack transformStack;
+		// the world transformations and boxes are kept by the scene, and recomputed only for the nodes that have moved
+		const xe::sg::TransformHierarchy &hierarchy = this->getScene()->getTransformHierarchy();
 
-		transformStack.reset(xe::identity<float, 4>());
+		xe::sg::Camera *camera = this->camera;
+
+		for (int index=0; index<hierarchy.getNodeCount() && !camera; index++) {
+			camera = dynamic_cast<xe::sg::Camera*>(hierarchy.getNode(index)->getRenderable());
+		}
+
+		const xe::Matrix4f view = camera ? camera->computeView() : xe::identity<float, 4>();
+		const xe::sg::Frustum frustum = camera ? xe::sg::Frustum(camera->computeProj() * view) : xe::sg::Frustum();
+
+		this->stats = SceneRenderStats();
+
+		this->queue.clear();
+		this->gatherNodes(hierarchy, frustum, view);
+		this->queue.sort();
 
 		this->renderer->beginFrame(this->getScene()->getBackColor());
-		this->renderNode(&transformStack, this->getScene()->getRootNode());
+		this->submitQueue(hierarchy);
 		this->renderer->endFrame();
 	}
 
-	void SceneRendererGeneric::renderNode(xe::sg::TransformationStack *transformStack, xe::sg::SceneNode* node) {
-        assert(transformStack);
-		assert(node);
+	void SceneRendererGeneric::gatherNodes(const xe::sg::TransformHierarchy &hierarchy, const xe::sg::Frustum &frustum, const xe::Matrix4f &view) {
+		this->cullTaskCount = 0;
+		this->visibleNodes.clear();
+		this->cullRange(hierarchy, frustum, 0, hierarchy.getNodeCount(), 0, true, this->visibleNodes, this->stats);
 
-		// std::cout << "SceneRendererGeneric::renderNode(" << node->getName() << ")" << std::endl;
+		// the subtrees at the split depth are culled in parallel, each one to its own list
+		xe::sys::ThreadPool::getDefault()->parallelFor(0, this->cullTaskCount, 1, [&](int begin, int end) {
+			for (int i=begin; i<end; i++) {
+				CullTask &task = this->cullTasks[i];
 
-		transformStack->push(node->getTransform());
+				const int subtreeEnd = hierarchy.getSubtreeEnd(task.root);
+				const int insideEnd = task.inside ? subtreeEnd : 0;
 
-		xe::sg::Pipeline *renderer = this->getRenderer();
-		renderer->setModel(transformStack->top());
+				this->cullRange(hierarchy, frustum, task.root, subtreeEnd, insideEnd, false, task.visibleNodes, task.stats);
+			}
+		});
 
-		xe::sg::Renderable *renderable = node->getRenderable();
-		if (renderable) {
-			renderable->renderWith(renderer);
+		// merged in depth first order, so the queue is filled as in a serial traversal
+		for (const int entry : this->visibleNodes) {
+			if (entry >= 0) {
+				this->gatherNode(hierarchy, entry, view);
+				continue;
+			}
+
+			const CullTask &task = this->cullTasks[-1 - entry];
+
+			for (const int index : task.visibleNodes) {
+				this->gatherNode(hierarchy, index, view);
+			}
+
+			this->stats.visibleNodes += task.stats.visibleNodes;
+			this->stats.culledNodes += task.stats.culledNodes;
 		}
+	}
+
+	void SceneRendererGeneric::cullRange(const xe::sg::TransformHierarchy &hierarchy, const xe::sg::Frustum &frustum, int begin, int end, int insideEnd, bool split, std::vector<int> &visibleNodes, SceneRenderStats &stats) {
+		// the nodes before insideEnd belong to a subtree completely inside of the frustum, so they aren't tested
+		for (int index=begin; index<end; ) {
+			const int subtreeEnd = hierarchy.getSubtreeEnd(index);
+
+			if (split && this->splitDepth > 0 && hierarchy.getDepth(index) == this->splitDepth) {
+				if (this->cullTaskCount == static_cast<int>(this->cullTasks.size())) {
+					this->cullTasks.emplace_back();
+				}
+
+				CullTask &task = this->cullTasks[this->cullTaskCount];
+
+				task.root = index;
+				task.inside = index < insideEnd;
+				task.visibleNodes.clear();
+				task.stats = SceneRenderStats();
+
+				visibleNodes.push_back(-1 - this->cullTaskCount);
+
+				this->cullTaskCount++;
+
+				index = subtreeEnd;
+				continue;
+			}
+
+			if (index >= insideEnd) {
+				const FrustumTest::Enum result = frustum.test(hierarchy.getSubtreeBox(index));
+
+				if (result == FrustumTest::Outside) {
+					stats.culledNodes += subtreeEnd - index;
+					index = subtreeEnd;
+					continue;
+				}
+
+				if (result == FrustumTest::Inside) {
+					insideEnd = subtreeEnd;
+				}
+			}
+
+			const xe::sg::Renderable *renderable = hierarchy.getNode(index)->getRenderable();
+
+			// the node itself can be outside, even when some of its descendants aren't
+			if (renderable && index >= insideEnd && subtreeEnd > index + 1 && frustum.test(hierarchy.getBox(index)) == FrustumTest::Outside) {
+				stats.culledNodes++;
+
+			} else {
+				if (renderable) {
+					visibleNodes.push_back(index);
+				}
+
+				stats.visibleNodes++;
+			}
 
-		for (int i=0; i<node->getChildCount(); i++) {
-			xe::sg::SceneNode *child = node->getChild(i);
-			assert(child);
-			this->renderNode(transformStack, child);
+			index++;
 		}
+	}
+
+	void SceneRendererGeneric::gatherNode(const xe::sg::TransformHierarchy &hierarchy, int index, const xe::Matrix4f &view) {
+		xe::sg::RenderItem item;
+
+		item.renderable = hierarchy.getNode(index)->getRenderable();
+		item.node = index;
+
+		// the cameras and lights set up the state of the draws that follow them
+		if (dynamic_cast<xe::sg::Camera*>(item.renderable) || dynamic_cast<xe::sg::Light*>(item.renderable)) {
+			this->queue.add(RenderQueue::makeSetupKey(this->queue.getItemCount()), item);
+			return;
+		}
+
+		// distance to the camera plane, from the center of the box
+		const xe::Boxf &box = hierarchy.getBox(index);
+		const xe::Vector3f center = (box.getMinEdge() + box.getMaxEdge()) * 0.5f;
+		const float depth = -(view(2, 0)*center.x + view(2, 1)*center.y + view(2, 2)*center.z + view(2, 3));
+
+		xe::gfx::Mesh *mesh = dynamic_cast<xe::gfx::Mesh*>(item.renderable);
+
+		if (!mesh) {
+			this->queue.add(RenderQueue::makeOpaqueKey(0, this->queue.getSubsetId(item.renderable), depth), item);
+			return;
+		}
+
+		for (int subset=0; subset<mesh->getSubsetCount(); subset++) {
+			const xe::gfx::MeshSubset *meshSubset = mesh->getSubset(subset);
+
+			item.subset = subset;
+			item.material = meshSubset->getMaterial();
+
+			const int materialId = this->queue.getMaterialId(item.material);
+			const int subsetId = this->queue.getSubsetId(meshSubset);
+
+			if (this->transparencyTest && this->transparencyTest(item.material)) {
+				this->queue.add(RenderQueue::makeTransparentKey(materialId, subsetId, depth), item);
+			} else {
+				this->queue.add(RenderQueue::makeOpaqueKey(materialId, subsetId, depth), item);
+			}
+		}
+	}
+
+	void SceneRendererGeneric::submitQueue(const xe::sg::TransformHierarchy &hierarchy) {
+		xe::sg::Pipeline *renderer = this->getRenderer();
+
+		const int count = this->queue.getItemCount();
 
-		transformStack->pop();
+		int currentNode = -1;
+		const xe::gfx::Material *currentMaterial = nullptr;
+
+		for (int i=0; i<count; ) {
+			const xe::sg::RenderItem &item = this->queue.getItem(i);
+
+			if (item.subset < 0) {
+				if (item.node != currentNode) {
+					currentNode = item.node;
+					renderer->setModel(hierarchy.getWorldTransform(item.node));
+				}
+
+				item.renderable->renderWith(renderer);
+
+				this->stats.drawCount++;
+				i++;
+				continue;
+			}
+
+			if (item.material != currentMaterial || this->stats.materialChanges == 0) {
+				currentMaterial = item.material;
+				this->stats.materialChanges++;
+			}
+
+			xe::gfx::Mesh *mesh = static_cast<xe::gfx::Mesh*>(item.renderable);
+
+			// the items of a mesh subset share its material and subset identifiers, so they are contiguous
+			int end = i + 1;
+
+			while (end < count && this->queue.getItem(end).renderable == item.renderable && this->queue.getItem(end).subset == item.subset) {
+				end++;
+			}
+
+			if (end - i == 1) {
+				if (item.node != currentNode) {
+					currentNode = item.node;
+					renderer->setModel(hierarchy.getWorldTransform(item.node));
+				}
+
+				renderer->render(mesh, item.subset);
+
+				this->stats.drawCount++;
+
+			} else {
+				this->instanceTransforms.clear();
+
+				for (int j=i; j<end; j++) {
+					this->instanceTransforms.push_back(hierarchy.getWorldTransform(this->queue.getItem(j).node));
+				}
+
+				const int draws = renderer->render(mesh, item.subset, this->instanceTransforms.data(), end - i);
+
+				// the model transformation left by the pipeline is unknown
+				currentNode = -1;
+
+				this->stats.drawCount += draws;
+			}
+
+			i = end;
+		}
 	}
 }}
@@ -4,11 +4,34 @@
 #ifndef __xe_sg_scenerenderergeneric_hpp__
 #define __xe_sg_scenerenderergeneric_hpp__
 
+#include <vector>
+#include <functional>
+#include <xe/Matrix.hpp>
 #include <xe/sg/Pipeline.hpp>
 #include <xe/sg/SceneRenderer.hpp>
-#include <xe/sg/TransformationStack.hpp>
+#include <xe/sg/RenderQueue.hpp>
+#include <xe/sg/TransformHierarchy.hpp>
+#include <xe/sg/Frustum.hpp>
 
 namespace xe { namespace sg {
+	/**
+	 * @brief Counters of the last rendered frame.
+	 */
+	struct SceneRenderStats {
+		int visibleNodes = 0;	//! Nodes that passed the frustum test.
+		int culledNodes = 0;	//! Nodes discarded by the frustum test, by themselves or along with an ancestor.
+		int drawCount = 0;		//! Draws issued by the pipeline for the items of the render queue.
+		int materialChanges = 0;	//! Times the material changed between consecutive mesh subsets.
+	};
+
+	/**
+	 * @brief Renders the nodes of a scene, discarding the subtrees out of the view frustum.
+	 *
+	 * The visible renderables are gathered first in a render queue, and submitted once sorted: the cameras and
+	 * lights in scene order, then the opaque mesh subsets grouped by material, front to back, and the 
+	 * transparent ones back to front. Consecutive items of the same mesh subset are passed together to the
+	 * pipeline, which can render them as instances.
+	 */
 	class EXENGAPI SceneRendererGeneric : public xe::sg::SceneRenderer {
 	public:
 		SceneRendererGeneric() {}
@@ -31,12 +54,69 @@ namespace xe { namespace sg {
 
 		void setRenderer(xe::sg::Pipeline* renderer);
 
+		/**
+		 * @brief Set the camera whose frustum is used to discard the nodes. When it isn't set, the first camera 
+		 * found in the scene is used, and without any camera nothing is discarded.
+		 */
+		void setCamera(xe::sg::Camera *camera);
+
+		xe::sg::Camera* getCamera() const;
+
+		const SceneRenderStats& getStats() const;
+
+		/**
+		 * @brief Set the function that tells if a material is transparent, so its subsets are rendered after 
+		 * the opaque ones. Without it, all the materials are opaque.
+		 */
+		void setTransparencyTest(std::function<bool (const xe::gfx::Material*)> transparencyTest);
+
+		/**
+		 * @brief Set the depth of the nodes whose subtrees are culled in parallel. The root has depth 0, and
+		 * a split depth of 0 culls the whole scene in the calling thread. The rendered frame is the same.
+		 */
+		void setSplitDepth(int depth);
+
+		int getSplitDepth() const;
+
 	protected:
-		void renderNode(xe::sg::TransformationStack *transformStack, xe::sg::SceneNode* node);
+		/**
+		 * @brief Add to the render queue the renderables of the nodes that pass the frustum test.
+		 */
+		void gatherNodes(const xe::sg::TransformHierarchy &hierarchy, const xe::sg::Frustum &frustum, const xe::Matrix4f &view);
+
+		void gatherNode(const xe::sg::TransformHierarchy &hierarchy, int index, const xe::Matrix4f &view);
+
+		/**
+		 * @brief Collect the visible nodes with a renderable in the range [begin, end) of the hierarchy, in depth first order.
+		 *
+		 * When split is true, the subtrees at the split depth are left to a cull task, whose index is stored 
+		 * in the list as -1 - index.
+		 */
+		void cullRange(const xe::sg::TransformHierarchy &hierarchy, const xe::sg::Frustum &frustum, int begin, int end, int insideEnd, bool split, std::vector<int> &visibleNodes, SceneRenderStats &stats);
+
+		void submitQueue(const xe::sg::TransformHierarchy &hierarchy);
+
+	private:
+		//! Subtree culled by a worker thread.
+		struct CullTask {
+			int root = 0;
+			bool inside = false;	//! The subtree is inside of the frustum of an ancestor.
+			std::vector<int> visibleNodes;
+			SceneRenderStats stats;
+		};
 
 	private:
 		xe::sg::Scene* scene = nullptr;
 		xe::sg::Pipeline* renderer = nullptr;
+		xe::sg::Camera* camera = nullptr;
+		SceneRenderStats stats;
+		RenderQueue queue;
+		std::function<bool (const xe::gfx::Material*)> transparencyTest;
+		std::vector<xe::Matrix4f> instanceTransforms;
+		std::vector<int> visibleNodes;
+		std::vector<CullTask> cullTasks;
+		int cullTaskCount = 0;
+		int splitDepth = 0;
 	};
 }}
 
@@ -0,0 +1,239 @@
+/**
+ * @file SlabIntersect.hpp
+ * @brief Slab tests between rays and boxes, alone or in packets of eight.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_SLABINTERSECT_HPP__
+#define __EXENG_SCENEGRAPH_SLABINTERSECT_HPP__
+
+#include <cassert>
+#include <limits>
+#include <algorithm>
+
+#include <xe/Config.hpp>
+#include <xe/Vector.hpp>
+#include <xe/Boundary.hpp>
+#include <xe/sg/Ray.hpp>
+#include <xe/sg/PacketIntersect.hpp>
+
+#if defined(__AVX__)
+#  define EXENG_SLAB_AVX
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EXENG_SLAB_SSE
+#  include <emmintrin.h>
+#endif
+
+/*
+ * All the slab tests below handle the direction components that are zero without any special case. Their
+ * reciprocal is infinite, so the distances to the planes of that slab are infinite too, with the sign that
+ * tells if the ray is inside of the slab. When the ray starts exactly on one of the planes the distance
+ * is 0 * inf = NaN, and the running minimum and maximum must ignore it: std::max(tnear, t) returns tnear
+ * and _mm_max_ps(t, tnear) returns its second operand when t is NaN, so the order of the operands matters.
+ * The near and far planes of each slab are selected by the sign of the direction, instead of taking the
+ * minimum and maximum of both distances, since those would let the NaN through to the running values.
+ */
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Slab test between a ray, given by its origin and inverse direction, and a box.
+     */
+    inline bool intersectSlab(const xe::Vector3f &point, const xe::Vector3f &invDirection, const xe::Boxf &box, float maxDistance, float *distance) {
+        const xe::Vector3f minEdge = box.getMinEdge();
+        const xe::Vector3f maxEdge = box.getMaxEdge();
+
+        float tnear = 0.0f;
+        float tfar = maxDistance;
+
+        for (int coord=0; coord<3; ++coord) {
+            const bool negative = invDirection[coord] < 0.0f;
+            const float t1 = ((negative ? maxEdge : minEdge)[coord] - point[coord]) * invDirection[coord];
+            const float t2 = ((negative ? minEdge : maxEdge)[coord] - point[coord]) * invDirection[coord];
+
+            tnear = std::max(tnear, t1);
+            tfar = std::min(tfar, t2);
+        }
+
+        *distance = tnear;
+
+        return tnear <= tfar * SlabFarScale;
+    }
+
+    /**
+     * @brief Slab test between a ray and a box, restricted to the distances covered by the ray.
+     *
+     * The sign of the direction selects the near and far planes of each slab, so the precomputed
+     * reciprocal is used without any division, swap or branch.
+     */
+    inline bool intersectSlab(const Ray &ray, const xe::Boxf &box, float *distance) {
+        const xe::Vector3f point = ray.getPoint();
+        const xe::Vector3f invDirection = ray.getInvDirection();
+        const xe::Vector3f edges[2] = {box.getMinEdge(), box.getMaxEdge()};
+
+        float tnear = ray.getMinDistance();
+        float tfar = ray.getMaxDistance();
+
+        for (int coord=0; coord<3; ++coord) {
+            const int sign = ray.getSign(coord);
+
+            tnear = std::max(tnear, (edges[sign][coord] - point[coord]) * invDirection[coord]);
+            tfar = std::min(tfar, (edges[1 - sign][coord] - point[coord]) * invDirection[coord]);
+        }
+
+        *distance = tnear;
+
+        return tnear <= tfar * SlabFarScale;
+    }
+
+    /**
+     * @brief A group of boxes stored as a structure of arrays, like the children of a wide BVH node, so
+     * a single ray can be tested against all of them at once.
+     *
+     * The lanes past 'size' hold an empty box, that never gets hit.
+     */
+    struct BoxPacket {
+        static const int MaxSize = 8;
+
+        //! Coordinates of the edges, indexed by [side][coord][lane]. Side 0 is the minimum edge, as in Ray::getSign.
+        alignas(32) float edges[2][3][MaxSize];
+
+        //! Number of used lanes.
+        int size = 0;
+
+        BoxPacket() {
+            for (int lane=0; lane<MaxSize; lane++) {
+                this->setLane(lane, xe::Boxf());
+            }
+        }
+
+        /**
+         * @brief Appends a box to the packet.
+         * @return The lane used by the box.
+         */
+        int add(const xe::Boxf &box) {
+            assert(this->size < MaxSize);
+
+            this->setLane(this->size, box);
+
+            return this->size++;
+        }
+
+        void setLane(int lane, const xe::Boxf &box) {
+            assert(lane >= 0 && lane < MaxSize);
+
+            const xe::Vector3f minEdge = box.getMinEdge();
+            const xe::Vector3f maxEdge = box.getMaxEdge();
+
+            for (int coord=0; coord<3; coord++) {
+                this->edges[0][coord][lane] = minEdge[coord];
+                this->edges[1][coord][lane] = maxEdge[coord];
+            }
+        }
+
+        xe::Boxf getBox(int lane) const {
+            assert(lane >= 0 && lane < MaxSize);
+
+            return xe::Boxf (
+                {this->edges[0][0][lane], this->edges[0][1][lane], this->edges[0][2][lane]},
+                {this->edges[1][0][lane], this->edges[1][1][lane], this->edges[1][2][lane]}
+            );
+        }
+    };
+
+    /**
+     * @brief Slab test between a ray and all the boxes of a packet, restricted to the distances covered by the ray.
+     *
+     * The distance to the entry point of each box is stored in 'distances', even for the lanes that miss it.
+     * @return The mask of the lanes whose box was hit, one bit per lane.
+     */
+    inline int intersectSlab(const Ray &ray, const BoxPacket &boxes, float *distances) {
+        const xe::Vector3f point = ray.getPoint();
+        const xe::Vector3f invDirection = ray.getInvDirection();
+
+#if defined(EXENG_SLAB_AVX)
+        // unaligned loads, since the C++14 containers only guarantee the 16 byte alignment of the SSE path
+        __m256 tnear = _mm256_set1_ps(ray.getMinDistance());
+        __m256 tfar = _mm256_set1_ps(ray.getMaxDistance());
+
+        for (int coord=0; coord<3; coord++) {
+            const int sign = ray.getSign(coord);
+            const __m256 coordPoint = _mm256_set1_ps(point[coord]);
+            const __m256 coordInvDirection = _mm256_set1_ps(invDirection[coord]);
+
+            const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.edges[sign][coord]), coordPoint), coordInvDirection);
+            const __m256 t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.edges[1 - sign][coord]), coordPoint), coordInvDirection);
+
+            tnear = _mm256_max_ps(t1, tnear);
+            tfar = _mm256_min_ps(t2, tfar);
+        }
+
+        _mm256_storeu_ps(distances, tnear);
+
+        tfar = _mm256_mul_ps(tfar, _mm256_set1_ps(SlabFarScale));
+
+        return _mm256_movemask_ps(_mm256_cmp_ps(tnear, tfar, _CMP_LE_OQ));
+
+#elif defined(EXENG_SLAB_SSE)
+        const __m128 farScale = _mm_set1_ps(SlabFarScale);
+
+        int mask = 0;
+
+        for (int half=0; half<BoxPacket::MaxSize; half+=4) {
+            __m128 tnear = _mm_set1_ps(ray.getMinDistance());
+            __m128 tfar = _mm_set1_ps(ray.getMaxDistance());
+
+            for (int coord=0; coord<3; coord++) {
+                const int sign = ray.getSign(coord);
+                const __m128 coordPoint = _mm_set1_ps(point[coord]);
+                const __m128 coordInvDirection = _mm_set1_ps(invDirection[coord]);
+
+                const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.edges[sign][coord] + half), coordPoint), coordInvDirection);
+                const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.edges[1 - sign][coord] + half), coordPoint), coordInvDirection);
+
+                tnear = _mm_max_ps(t1, tnear);
+                tfar = _mm_min_ps(t2, tfar);
+            }
+
+            _mm_storeu_ps(distances + half, tnear);
+
+            mask |= _mm_movemask_ps(_mm_cmple_ps(tnear, _mm_mul_ps(tfar, farScale))) << half;
+        }
+
+        return mask;
+
+#else
+        int mask = 0;
+
+        for (int lane=0; lane<BoxPacket::MaxSize; lane++) {
+            float tnear = ray.getMinDistance();
+            float tfar = ray.getMaxDistance();
+
+            for (int coord=0; coord<3; coord++) {
+                const int sign = ray.getSign(coord);
+
+                tnear = std::max(tnear, (boxes.edges[sign][coord][lane] - point[coord]) * invDirection[coord]);
+                tfar = std::min(tfar, (boxes.edges[1 - sign][coord][lane] - point[coord]) * invDirection[coord]);
+            }
+
+            distances[lane] = tnear;
+
+            if (tnear <= tfar * SlabFarScale) {
+                mask |= 1 << lane;
+            }
+        }
+
+        return mask;
+#endif
+    }
+}}
+
+#endif  //__EXENG_SCENEGRAPH_SLABINTERSECT_HPP__
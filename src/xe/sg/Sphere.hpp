@@ -71,6 +71,12 @@ namespace xe { namespace sg {
 		 * @brief Calcula la interseccion entre el rayo indicado, y la esfera.
 		 */
 		bool intersect(const Ray& ray, IntersectInfo *intersectInfo=nullptr) const;
+
+		/**
+		 * @brief Comprueba si el rayo toca la esfera entre sus distancias minima y maxima, sin calcular 
+		 * el resto de la informacion de la interseccion.
+		 */
+		bool occluded(const Ray& ray) const;
     
 		/**
 		 * @brief Comprueba si dos esferas son iguales.
@@ -205,6 +211,26 @@ namespace xe { namespace sg {
 	}
 
 
+	inline bool Sphere::occluded(const Ray& ray) const {
+		const xe::Vector3f r0_sub_c = ray.getPoint() - this->getCenter();
+		const float r = this->getRadius();
+
+		const float B = 2.0f * dot(ray.getDirection(), r0_sub_c);
+		const float C = abs2(r0_sub_c) - r*r;
+
+		const float disc = B*B - 4.0f*C;
+
+		if (disc < 0.0f) {
+			return false;
+		}
+
+		// la interseccion mas cercana, igual que en intersect
+		const float t = (-B - std::sqrt(disc)) / 2.0f;
+
+		return ray.contains(t);
+	}
+
+
 	inline bool Sphere::operator== (const Sphere &sphere) const {
 		if (this->getCenter() != sphere.getCenter()) {
 			return false;
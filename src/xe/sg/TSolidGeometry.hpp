@@ -18,6 +18,7 @@ namespace xe { namespace sg {
         TSolidGeometry(const Solid &solid_, const xe::gfx::Material* material_);
         
         virtual bool hit(const Ray &ray, IntersectInfo *intersectInfo);
+        virtual bool occluded(const Ray &ray);
         virtual Boxf getBox() const;
     
     public:
@@ -44,6 +45,11 @@ namespace xe { namespace sg {
         return intersection;
     }
     
+    template<typename Solid>
+    bool TSolidGeometry<Solid>::occluded(const Ray &ray) {
+        return xe::sg::occluded(ray, this->solid);
+    }
+    
     
     template<typename Solid>
     Boxf TSolidGeometry<Solid>::getBox() const {
@@ -0,0 +1,326 @@
+/**
+ * @file TransformHierarchy.cpp
+ * @brief Flat transformation hierarchy implementation.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include <xe/sg/TransformHierarchy.hpp>
+#include <xe/sg/SceneNode.hpp>
+#include <xe/sg/Geometry.hpp>
+#include <xe/sys/ThreadPool.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief Transform a box by an affine transformation, from its center and half size. 
+     *
+     * Gives the same box than transforming its eight corners, with a single point transformation.
+     */
+    inline Boxf transformBox(const Matrix4f &m, const Boxf &box) {
+        const Vector3f center = (box.getMinEdge() + box.getMaxEdge()) * 0.5f;
+        const Vector3f extent = (box.getMaxEdge() - box.getMinEdge()) * 0.5f;
+
+        Vector3f resultCenter, resultExtent;
+
+        for (int i=0; i<3; i++) {
+            resultCenter[i] = m(i, 0)*center.x + m(i, 1)*center.y + m(i, 2)*center.z + m(i, 3);
+            resultExtent[i] = std::abs(m(i, 0))*extent.x + std::abs(m(i, 1))*extent.y + std::abs(m(i, 2))*extent.z;
+        }
+
+        return Boxf(resultCenter - resultExtent, resultCenter + resultExtent);
+    }
+
+    void TransformHierarchy::clear() {
+        this->nodes.clear();
+        this->parents.clear();
+        this->subtreeEnds.clear();
+        this->depths.clear();
+        this->localTransforms.clear();
+        this->worldTransforms.clear();
+        this->boxes.clear();
+        this->subtreeBoxes.clear();
+        this->dirty.clear();
+        this->firstDirty = 0;
+        this->geometryNodes.clear();
+        this->geometries.clear();
+        this->geometryVersions.clear();
+
+        this->updateSplit();
+    }
+
+    void TransformHierarchy::build(SceneNode *root) {
+        assert(root);
+
+        this->clear();
+        this->append(root, -1);
+        this->updateSplit();
+
+        // all the nodes are new, so the first update computes everything
+        this->dirty.assign(this->nodes.size(), 1);
+        this->firstDirty = 0;
+
+        this->update();
+    }
+
+    void TransformHierarchy::append(SceneNode *node, int parent) {
+        const int index = static_cast<int>(this->nodes.size());
+
+        node->setHierarchyIndex(index);
+
+        this->nodes.push_back(node);
+        this->parents.push_back(parent);
+        this->subtreeEnds.push_back(index + 1);
+        this->depths.push_back(parent >= 0 ? this->depths[parent] + 1 : 0);
+        this->localTransforms.push_back(node->getTransform());
+        this->worldTransforms.push_back(node->getTransform());
+        this->boxes.push_back(Boxf());
+        this->subtreeBoxes.push_back(Boxf());
+
+        const Geometry *geometry = dynamic_cast<const Geometry*>(node->getRenderable());
+
+        if (geometry) {
+            this->geometryNodes.push_back(index);
+        }
+
+        this->geometries.push_back(geometry);
+        this->geometryVersions.push_back(0);
+
+        for (int i=0; i<node->getChildCount(); i++) {
+            this->append(node->getChild(i), index);
+        }
+
+        this->subtreeEnds[index] = static_cast<int>(this->nodes.size());
+    }
+
+    void TransformHierarchy::setDirty(int index) {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        this->dirty[index] = 1;
+        this->firstDirty = std::min(this->firstDirty, index);
+    }
+
+    bool TransformHierarchy::update() {
+        const int count = this->getNodeCount();
+
+        // the edited geometries need their boxes computed again, even when their nodes haven't moved
+        bool geometryChanged = false;
+
+        for (int index : this->geometryNodes) {
+            if (this->geometries[index]->getVersion() != this->geometryVersions[index]) {
+                this->updateBox(index);
+                geometryChanged = true;
+            }
+        }
+
+        if (this->firstDirty >= count && !geometryChanged) {
+            return false;
+        }
+
+        if (this->splitRoots.size() < 2) {
+            // the parents come first, so their world transformations are already up to date when a child is reached
+            for (int index=this->firstDirty; index<count; index++) {
+                this->updateNode(index);
+            }
+
+            std::fill(this->dirty.begin() + this->firstDirty, this->dirty.end(), 0);
+            this->firstDirty = count;
+
+            this->mergeBoxes(0, count);
+
+            return true;
+        }
+
+        // the ancestors of the split roots first, and then each subtree on its own
+        for (int index : this->splitAncestors) {
+            if (index >= this->firstDirty) {
+                this->updateNode(index);
+            }
+        }
+
+        const int rootCount = static_cast<int>(this->splitRoots.size());
+
+        xe::sys::ThreadPool::getDefault()->parallelFor(0, rootCount, 1, [this](int begin, int end) {
+            for (int i=begin; i<end; i++) {
+                const int root = this->splitRoots[i];
+                const int subtreeEnd = this->subtreeEnds[root];
+
+                for (int index=std::max(root, this->firstDirty); index<subtreeEnd; index++) {
+                    this->updateNode(index);
+                }
+
+                this->mergeBoxes(root, subtreeEnd);
+            }
+        });
+
+        std::fill(this->dirty.begin() + this->firstDirty, this->dirty.end(), 0);
+        this->firstDirty = count;
+
+        // the subtree boxes of the split roots are complete, so only the frontier remains to be merged
+        for (int index : this->splitAncestors) {
+            this->subtreeBoxes[index] = this->boxes[index];
+        }
+
+        for (auto it=this->splitFrontier.rbegin(); it!=this->splitFrontier.rend(); ++it) {
+            const int index = *it;
+
+            if (index > 0 && this->subtreeBoxes[index].isValid()) {
+                this->subtreeBoxes[this->parents[index]].expand(this->subtreeBoxes[index]);
+            }
+        }
+
+        return true;
+    }
+
+    void TransformHierarchy::updateNode(int index) {
+        const int parent = this->parents[index];
+
+        if (parent >= this->firstDirty && this->dirty[parent]) {
+            this->dirty[index] = 1;
+        }
+
+        if (!this->dirty[index]) {
+            return;
+        }
+
+        this->localTransforms[index] = this->nodes[index]->getTransform();
+
+        if (parent >= 0) {
+            this->worldTransforms[index] = this->worldTransforms[parent] * this->localTransforms[index];
+        } else {
+            this->worldTransforms[index] = this->localTransforms[index];
+        }
+
+        this->updateBox(index);
+    }
+
+    void TransformHierarchy::mergeBoxes(int begin, int end) {
+        std::copy(this->boxes.begin() + begin, this->boxes.begin() + end, this->subtreeBoxes.begin() + begin);
+
+        // the descendants come after each node, so walking backwards every subtree box is complete before it's merged
+        for (int index=end - 1; index>begin; index--) {
+            if (this->subtreeBoxes[index].isValid()) {
+                this->subtreeBoxes[this->parents[index]].expand(this->subtreeBoxes[index]);
+            }
+        }
+    }
+
+    void TransformHierarchy::setSplitDepth(int depth) {
+        assert(depth >= 0);
+
+        this->splitDepth = depth;
+        this->updateSplit();
+    }
+
+    int TransformHierarchy::getSplitDepth() const {
+        return this->splitDepth;
+    }
+
+    void TransformHierarchy::updateSplit() {
+        this->splitRoots.clear();
+        this->splitAncestors.clear();
+        this->splitFrontier.clear();
+
+        if (this->splitDepth == 0) {
+            return;
+        }
+
+        for (int index=0; index<this->getNodeCount(); index++) {
+            if (this->depths[index] < this->splitDepth) {
+                this->splitAncestors.push_back(index);
+                this->splitFrontier.push_back(index);
+
+            } else if (this->depths[index] == this->splitDepth) {
+                this->splitRoots.push_back(index);
+                this->splitFrontier.push_back(index);
+            }
+        }
+    }
+
+    void TransformHierarchy::updateBox(int index) {
+        const Renderable *renderable = this->nodes[index]->getRenderable();
+
+        if (!renderable) {
+            this->boxes[index] = Boxf();
+            return;
+        }
+
+        const Geometry *geometry = this->geometries[index];
+        const Boxf box = geometry ? geometry->getBox() : Boxf();
+
+        if (geometry) {
+            this->geometryVersions[index] = geometry->getVersion();
+        }
+
+        if (box.isValid()) {
+            this->boxes[index] = transformBox(this->worldTransforms[index], box);
+        } else {
+            const float max = std::numeric_limits<float>::max();
+
+            this->boxes[index] = Boxf(Vector3f(-max), Vector3f(max));
+        }
+    }
+
+    int TransformHierarchy::getNodeCount() const {
+        return static_cast<int>(this->nodes.size());
+    }
+
+    SceneNode* TransformHierarchy::getNode(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->nodes[index];
+    }
+
+    int TransformHierarchy::getParent(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->parents[index];
+    }
+
+    int TransformHierarchy::getSubtreeEnd(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->subtreeEnds[index];
+    }
+
+    int TransformHierarchy::getDepth(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->depths[index];
+    }
+
+    const Matrix4f& TransformHierarchy::getLocalTransform(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->localTransforms[index];
+    }
+
+    const Matrix4f& TransformHierarchy::getWorldTransform(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->worldTransforms[index];
+    }
+
+    const Boxf& TransformHierarchy::getBox(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->boxes[index];
+    }
+
+    const Boxf& TransformHierarchy::getSubtreeBox(int index) const {
+        assert(index >= 0 && index < this->getNodeCount());
+
+        return this->subtreeBoxes[index];
+    }
+}}
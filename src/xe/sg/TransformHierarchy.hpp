@@ -0,0 +1,149 @@
+/**
+ * @file TransformHierarchy.hpp
+ * @brief Flat array of the local and world transformations of a node tree.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SCENEGRAPH_TRANSFORMHIERARCHY_HPP__
+#define __EXENG_SCENEGRAPH_TRANSFORMHIERARCHY_HPP__
+
+#include <cstdint>
+#include <vector>
+
+#include <xe/Config.hpp>
+#include <xe/Matrix.hpp>
+#include <xe/Boundary.hpp>
+#include <xe/sg/Forward.hpp>
+
+namespace xe { namespace sg {
+
+    /**
+     * @brief The nodes of a tree stored in depth first order, along with their local and world transformations.
+     *
+     * Each parent comes before its descendants, and the descendants of a node are the contiguous range
+     * [index + 1, getSubtreeEnd(index)), so the world transformations are updated in a single linear pass
+     * over contiguous memory. Only the nodes marked as dirty, and their descendants, are recomputed.
+     *
+     * The world space bounding boxes of the nodes, and of their subtrees, are kept along with the transformations.
+     * The box of a Geometry is read when its node is built or moved, or when the version of the geometry 
+     * changes, like after writing the vertices of a mesh. The nodes that render something without a box, 
+     * like cameras, lights or infinite planes, get a box that covers the whole space.
+     *
+     * With a split depth, the subtrees rooted at that depth are updated in parallel, after their ancestors.
+     * The result is the same than the one of the serial update.
+     */
+    class EXENGAPI TransformHierarchy {
+    public:
+        /**
+         * @brief Removes all the nodes.
+         */
+        void clear();
+
+        /**
+         * @brief Rebuilds the arrays from the tree under the root node, and computes all the world transformations.
+         *
+         * Each node is told its index, so the following changes can be marked with setDirty.
+         */
+        void build(SceneNode *root);
+
+        /**
+         * @brief Marks the local transformation of a node as changed. Nothing is recomputed until the next call to update.
+         */
+        void setDirty(int index);
+
+        /**
+         * @brief Recomputes the world transformations of the dirty nodes and their descendants, and the boxes
+         * of the geometries that have changed.
+         * @return true if some transformation or box has changed.
+         */
+        bool update();
+
+        /**
+         * @brief Set the depth of the nodes whose subtrees are updated in parallel. The root has depth 0,
+         * and a split depth of 0 updates the whole tree in the calling thread.
+         */
+        void setSplitDepth(int depth);
+
+        int getSplitDepth() const;
+
+        int getNodeCount() const;
+
+        SceneNode* getNode(int index) const;
+
+        /**
+         * @brief Get the index of the parent of a node, or -1 for the root.
+         */
+        int getParent(int index) const;
+
+        /**
+         * @brief Get the index past the last descendant of a node.
+         */
+        int getSubtreeEnd(int index) const;
+
+        /**
+         * @brief Get the number of ancestors of a node.
+         */
+        int getDepth(int index) const;
+
+        const xe::Matrix4f& getLocalTransform(int index) const;
+
+        const xe::Matrix4f& getWorldTransform(int index) const;
+
+        /**
+         * @brief Get the world space bounding box of the renderable of a node. It's invalid when the node has no renderable.
+         */
+        const xe::Boxf& getBox(int index) const;
+
+        /**
+         * @brief Get the world space bounding box of the renderables of a node and all its descendants.
+         */
+        const xe::Boxf& getSubtreeBox(int index) const;
+
+    private:
+        void append(SceneNode *node, int parent);
+
+        void updateBox(int index);
+
+        void updateNode(int index);
+
+        /**
+         * @brief Copy the boxes of a subtree to its subtree boxes, and merge them into the ancestors inside of the subtree.
+         */
+        void mergeBoxes(int begin, int end);
+
+        void updateSplit();
+
+    private:
+        std::vector<SceneNode*> nodes;
+        std::vector<int> parents;
+        std::vector<int> subtreeEnds;
+        std::vector<int> depths;
+        std::vector<xe::Matrix4f> localTransforms;
+        std::vector<xe::Matrix4f> worldTransforms;
+        std::vector<xe::Boxf> boxes;
+        std::vector<xe::Boxf> subtreeBoxes;
+        std::vector<std::uint8_t> dirty;
+
+        //! Nodes that render a Geometry, with the version of the geometry when their box was computed.
+        std::vector<int> geometryNodes;
+        std::vector<const Geometry*> geometries;
+        std::vector<std::uint32_t> geometryVersions;
+
+        //! Index of the first dirty node, or the node count when there is none.
+        int firstDirty = 0;
+
+        int splitDepth = 0;
+        std::vector<int> splitRoots;        //! Nodes at the split depth, updated in parallel along with their descendants.
+        std::vector<int> splitAncestors;    //! Nodes above the split depth, updated before the split roots.
+        std::vector<int> splitFrontier;     //! Both of them, in depth first order.
+    };
+}}
+
+#endif  //__EXENG_SCENEGRAPH_TRANSFORMHIERARCHY_HPP__
@@ -0,0 +1,266 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief ThreadPool class implementation.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#include "ThreadPool.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <condition_variable>
+
+namespace xe { namespace sys {
+
+    /**
+     * @brief State shared by all the chunks of a parallelFor call.
+     */
+    struct ThreadPoolJob {
+        const std::function<void (int, int)> *body = nullptr;
+        std::atomic<int> pending = {0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    struct ThreadPoolTask {
+        ThreadPoolJob *job = nullptr;
+        int begin = 0;
+        int end = 0;
+    };
+
+    struct ThreadPoolQueue {
+        std::mutex mutex;
+        std::deque<ThreadPoolTask> tasks;
+    };
+
+    //! Index of the queue owned by the current thread, when it's a worker of some pool.
+    static thread_local const void *currentPool = nullptr;
+    static thread_local int currentQueue = -1;
+
+    struct ThreadPool::Private {
+        //! One queue per worker thread, plus one for the threads outside the pool.
+        std::vector<std::unique_ptr<ThreadPoolQueue>> queues;
+        std::vector<std::thread> threads;
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        std::atomic<int> taskCount = {0};
+        std::atomic<unsigned> nextQueue = {0};
+        bool exit = false;
+
+        int getExternalQueue() const {
+            return static_cast<int>(this->queues.size()) - 1;
+        }
+
+        bool popFront(int queueIndex, ThreadPoolTask &task) {
+            ThreadPoolQueue &queue = *this->queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty()) {
+                return false;
+            }
+
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            this->taskCount--;
+
+            return true;
+        }
+
+        bool stealBack(int queueIndex, ThreadPoolTask &task) {
+            ThreadPoolQueue &queue = *this->queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty()) {
+                return false;
+            }
+
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            this->taskCount--;
+
+            return true;
+        }
+
+        bool findTask(int queueIndex, ThreadPoolTask &task) {
+            if (this->popFront(queueIndex, task)) {
+                return true;
+            }
+
+            const int queueCount = static_cast<int>(this->queues.size());
+
+            for (int i=1; i<queueCount; i++) {
+                if (this->stealBack((queueIndex + i) % queueCount, task)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void execute(const ThreadPoolTask &task) {
+            ThreadPoolJob *job = task.job;
+
+            try {
+                (*job->body)(task.begin, task.end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job->errorMutex);
+
+                if (!job->error) {
+                    job->error = std::current_exception();
+                }
+            }
+
+            // the job can be destroyed by the waiting thread after this point
+            job->pending--;
+        }
+
+        void workerMain(int queueIndex) {
+            currentPool = this;
+            currentQueue = queueIndex;
+
+            while (true) {
+                ThreadPoolTask task;
+
+                if (this->findTask(queueIndex, task)) {
+                    this->execute(task);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(this->wakeMutex);
+
+                this->wakeCondition.wait(lock, [this]() {
+                    return this->exit || this->taskCount > 0;
+                });
+
+                if (this->exit && this->taskCount == 0) {
+                    return;
+                }
+            }
+        }
+    };
+
+    ThreadPool::ThreadPool(int threadCount) {
+        assert(threadCount >= 0);
+
+        if (threadCount == 0) {
+            threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        }
+
+        impl = new ThreadPool::Private();
+
+        for (int i=0; i<threadCount + 1; i++) {
+            impl->queues.push_back(std::make_unique<ThreadPoolQueue>());
+        }
+
+        for (int i=0; i<threadCount; i++) {
+            impl->threads.emplace_back([this, i]() {
+                impl->workerMain(i);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        assert(impl);
+
+        {
+            std::lock_guard<std::mutex> lock(impl->wakeMutex);
+            impl->exit = true;
+        }
+
+        impl->wakeCondition.notify_all();
+
+        for (std::thread &thread : impl->threads) {
+            thread.join();
+        }
+
+        delete impl;
+    }
+
+    int ThreadPool::getThreadCount() const {
+        assert(impl);
+
+        return static_cast<int>(impl->threads.size());
+    }
+
+    void ThreadPool::parallelFor(int begin, int end, int grain, const std::function<void (int, int)> &body) {
+        assert(impl);
+        assert(grain > 0);
+
+        if (end - begin <= grain) {
+            if (begin < end) {
+                body(begin, end);
+            }
+
+            return;
+        }
+
+        ThreadPoolJob job;
+        job.body = &body;
+
+        const int taskCount = (end - begin + grain - 1) / grain;
+        const int workerCount = this->getThreadCount();
+
+        job.pending = taskCount;
+
+        // deal the chunks between the workers, starting from a different worker each time
+        unsigned queueIndex = impl->nextQueue++;
+
+        for (int i=begin; i<end; i+=grain) {
+            ThreadPoolTask task;
+            task.job = &job;
+            task.begin = i;
+            task.end = std::min(end, i + grain);
+
+            ThreadPoolQueue &queue = *impl->queues[queueIndex++ % workerCount];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+
+        impl->taskCount += taskCount;
+
+        {
+            std::lock_guard<std::mutex> lock(impl->wakeMutex);
+        }
+
+        impl->wakeCondition.notify_all();
+
+        // help with the execution, until the whole range is done
+        const int ownQueue = (currentPool == impl) ? currentQueue : impl->getExternalQueue();
+
+        while (job.pending > 0) {
+            ThreadPoolTask task;
+
+            if (impl->findTask(ownQueue, task)) {
+                impl->execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    ThreadPool* ThreadPool::getDefault() {
+        static ThreadPool pool;
+
+        return &pool;
+    }
+}}
@@ -0,0 +1,69 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief ThreadPool class definition.
+ */
+
+
+/*
+ * Copyright (c) 2013 Felipe Apablaza.
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution.
+ */
+
+#ifndef __EXENG_SYSTEM_THREADPOOL_HPP__
+#define __EXENG_SYSTEM_THREADPOOL_HPP__
+
+#include <functional>
+#include <xe/Config.hpp>
+
+namespace xe { namespace sys {
+
+    /**
+     * @brief Set of worker threads, that execute ranges of a parallel loop.
+     *
+     * Each worker has its own task queue. The workers take the tasks from the front of their queues,
+     * and when they become empty, they steal tasks from the back of the queue of the other workers.
+     * The thread that calls parallelFor also executes tasks, until the whole range is complete, so
+     * nested calls to parallelFor from inside a task are allowed.
+     */
+    class EXENGAPI ThreadPool {
+    public:
+        /**
+         * @brief Creates the worker threads.
+         * @param threadCount Number of worker threads. When zero, one worker thread by each hardware thread,
+         * minus the calling thread, is created.
+         */
+        explicit ThreadPool(int threadCount=0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator= (const ThreadPool&) = delete;
+
+        /**
+         * @brief Get the number of worker threads.
+         */
+        int getThreadCount() const;
+
+        /**
+         * @brief Split the range [begin, end) in chunks of at most 'grain' elements, and
+         * calls body(chunkBegin, chunkEnd) for each chunk, in parallel.
+         *
+         * Blocks until all the chunks are processed. If some call to the body throws an exception,
+         * the first one is rethrown after all the chunks have finished.
+         */
+        void parallelFor(int begin, int end, int grain, const std::function<void (int, int)> &body);
+
+        /**
+         * @brief Get a pool shared by the whole process, with one thread per hardware thread.
+         */
+        static ThreadPool* getDefault();
+
+    private:
+        struct Private;
+        Private *impl = nullptr;
+    };
+}}
+
+#endif  //__EXENG_SYSTEM_THREADPOOL_HPP__